@@ -0,0 +1,98 @@
+// Benchmark dos drivers do OLED: o mesmo laço de quadros com o driver C (inc/ssd1306_i2c.c) ou
+// com o driver C++ (inc/ssd1306.hpp), conforme SSD1306_BENCH_CPP. Cada variante é um executável
+// próprio (ssd1306_bench_c e ssd1306_bench_cpp), então o tamanho de código sai da comparação dos
+// dois .elf com arm-none-eabi-size. A cada segundo a placa envia pela USB:
+//   <driver>,<Hz do i2c>,<us por quadro inteiro>,<us por faixa de 2 páginas>
+#include <cstdio>
+#include "pico/stdlib.h"
+#include "inc/i2c_bus.h"
+#include "inc/ssd1306_draw.h"
+#if SSD1306_BENCH_CPP
+#include "inc/ssd1306.hpp"
+#else
+#include "inc/ssd1306.h"
+#endif
+
+#define BENCH_FRAMES 50
+#define BENCH_SDA 14
+#define BENCH_SCL 15
+
+static i2c_bus_t bus;
+
+#if SSD1306_BENCH_CPP
+static ssd1306_cpp::panel<64, ssd1306_cpp::shared_bus<bus>> oled;
+using band_area = ssd1306_cpp::area<0, ssd1306_width - 1, 3, 4>; // Faixa do tempo do cronômetro
+
+static uint attach() {
+    static const uint8_t probe[] = {0x80, ssd1306_nop};
+    uint baudrate = i2c_bus_probe(&bus, decltype(oled)::address, probe, sizeof(probe));
+    oled.init();
+    return baudrate;
+}
+
+static uint8_t *buffer() {
+    return oled.buffer();
+}
+
+static void flush_frame() {
+    oled.flush();
+}
+
+static void flush_band() {
+    oled.flush<band_area>();
+}
+
+static const char bench_name[] = "cpp";
+#else
+static ssd1306_t oled;
+static uint8_t frame[ssd1306_buffer_length];
+
+static uint attach() {
+    uint baudrate = ssd1306_attach(&oled, &bus, ssd1306_i2c_address, ssd1306_height, false);
+    ssd1306_init(&oled);
+    return baudrate;
+}
+
+static uint8_t *buffer() {
+    return frame;
+}
+
+static void flush_frame() {
+    struct render_area area = {0, ssd1306_width - 1, 0, ssd1306_n_pages - 1, 0};
+    calculate_render_area_buffer_length(&area);
+    render_on_display(&oled, frame, &area);
+}
+
+static void flush_band() {
+    struct render_area area = {0, ssd1306_width - 1, 3, 4, 0};
+    calculate_render_area_buffer_length(&area);
+    render_on_display(&oled, frame + 3 * ssd1306_width, &area);
+}
+
+static const char bench_name[] = "c";
+#endif
+
+// Tempo médio por envio, com o desenho (ao C, em ambas as variantes) fora da medição
+static uint32_t measure(void (*flush)(void)) {
+    uint32_t total = 0;
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        ssd1306_invert_rect(buffer(), i % ssd1306_width, 0, 8, ssd1306_height);
+        uint32_t start = time_us_32();
+        flush();
+        total += time_us_32() - start;
+    }
+    return total / BENCH_FRAMES;
+}
+
+int main() {
+    stdio_init_all();
+    i2c_bus_init(&bus, i2c1, BENCH_SDA, BENCH_SCL);
+    uint baudrate = attach();
+
+    while (true) {
+        uint32_t frame_us = measure(flush_frame);
+        uint32_t band_us = measure(flush_band);
+        printf("%s,%u,%lu,%lu\n", bench_name, baudrate, (unsigned long)frame_us, (unsigned long)band_us);
+        sleep_ms(1000);
+    }
+}
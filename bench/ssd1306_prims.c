@@ -0,0 +1,258 @@
+// Benchmark das primitivas de desenho e de envio do OLED e do quadro dos LEDs, com as mesmas
+// cargas na placa e no host (sobre o substituto do SDK, com o painel modelado no i2c).
+// Saída em CSV, uma linha por medida: <carga>,<medida>,<valor>
+//   us           tempo por repetição medido com time_us_64(): na placa, tudo; no host, o relógio
+//                virtual só conta o barramento, então só as cargas de envio o informam
+//   rel          (host) tempo de CPU por repetição dividido pelo de um laço de referência fixo
+//                medido na mesma execução, para comparar máquinas diferentes
+//   transactions transações i2c por repetição
+//   bytes        (host) bytes i2c por repetição, contados pelo painel modelado
+// No host a execução é única e tools/bench_compare.py compara com bench/baseline_host.csv; na
+// placa o relatório é repetido a cada 5 s pela USB
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "ws2818b.pio.h"
+#include "inc/i2c_bus.h"
+#include "inc/ssd1306.h"
+#include "inc/ssd1306_draw.h"
+#include "inc/ssd1306_glyph.h"
+#include "glyph_atlas.h"
+#if !PICO_ON_DEVICE
+#include <time.h>
+#include "host_ssd1306.h"
+#endif
+
+#define BENCH_SDA 14
+#define BENCH_SCL 15
+#define BENCH_LED_PIN 7
+#define BENCH_LED_COUNT 25
+#define BENCH_CPU_REPEAT 200 // Repetições das cargas de CPU por medida
+#define BENCH_BUS_REPEAT 20  // Repetições das cargas de envio
+#define BENCH_TRIALS 15      // Medidas por carga; vale a menor (menos interferência)
+
+static i2c_bus_t bus;
+static ssd1306_t oled;
+static uint8_t frame[ssd1306_buffer_length];
+static uint32_t bench_sink; // Resultado da referência, para o compilador não descartá-la
+
+static PIO led_pio;
+static uint led_sm;
+static int led_dma;
+static uint32_t led_frame[BENCH_LED_COUNT];
+
+#if !PICO_ON_DEVICE
+static host_ssd1306_t panel;
+#endif
+
+// Cargas de CPU: só o desenho no buffer
+
+#if !PICO_ON_DEVICE
+static uint8_t reference_buffer[ssd1306_buffer_length];
+
+static void load_reference(int i) {
+    // Laço fixo, que não depende de nenhum código medido: a unidade de "rel"
+    uint32_t x = bench_sink + i;
+    for (int j = 0; j < ssd1306_buffer_length; j++) {
+        x = x * 1103515245u + 12345u;
+        reference_buffer[j] = (uint8_t)(x >> 24);
+    }
+    bench_sink = x;
+}
+#endif
+
+static void load_clear(int i) {
+    ssd1306_clear_rect(frame, 0, 0, ssd1306_width, ssd1306_height);
+}
+
+static void load_pixels(int i) {
+    bool set = i & 1;
+    for (int y = 0; y < ssd1306_height; y++) {
+        for (int x = 0; x < ssd1306_width; x++) {
+            ssd1306_set_pixel(frame, x, y, set);
+        }
+    }
+}
+
+// Leque de linhas do centro até as bordas, a cada 8 pixels
+static void load_line_fan(int i) {
+    bool set = i & 1;
+    for (int x = 0; x < ssd1306_width; x += 8) {
+        ssd1306_draw_line(frame, 64, 32, x, 0, set);
+        ssd1306_draw_line(frame, 64, 32, x, ssd1306_height - 1, set);
+    }
+    for (int y = 0; y < ssd1306_height; y += 8) {
+        ssd1306_draw_line(frame, 64, 32, 0, y, set);
+        ssd1306_draw_line(frame, 64, 32, ssd1306_width - 1, y, set);
+    }
+}
+
+// Tela de texto: 8 linhas de 16 caracteres de 8 pixels
+static char text_line[] = "CHRONO 12:34:56 ";
+
+static void load_text_char(int i) {
+    for (int line = 0; line < ssd1306_n_pages; line++) {
+        ssd1306_draw_string(frame, 0, line * 8, text_line);
+    }
+}
+
+static void load_text_blit(int i) {
+    for (int line = 0; line < ssd1306_n_pages; line++) {
+        ssd1306_blit_string(frame, 0, line * 8, &font_8, text_line);
+    }
+}
+
+// Cargas de envio: o barramento e o PIO
+
+static void load_flush_full(int i) {
+    struct render_area area = {0, ssd1306_width - 1, 0, ssd1306_n_pages - 1, 0};
+    calculate_render_area_buffer_length(&area);
+    ssd1306_invert_rect(frame, 0, 0, ssd1306_width, ssd1306_height);
+    render_on_display(&oled, frame, &area);
+}
+
+// Um dígito de 16 pixels alterado: o envio por diferença leva só as suas colunas
+static void load_flush_digit(int i) {
+    ssd1306_blit_glyph(frame, 48, 24, &font_16, '0' + i % 10);
+    render_changes_on_display(&oled, frame);
+}
+
+// O quadro inteiro alterado, pela diferença (o pior caso do envio por diferença)
+static void load_flush_diff_full(int i) {
+    ssd1306_invert_rect(frame, 0, 0, ssd1306_width, ssd1306_height);
+    render_changes_on_display(&oled, frame);
+}
+
+// Quadro dos 25 LEDs via DMA para o PIO, como npWriteAsync, até o fim do envio
+static void load_leds(int i) {
+    for (int led = 0; led < BENCH_LED_COUNT; led++) {
+        led_frame[led] = (uint32_t)(i + led) << 8;
+    }
+    dma_channel_transfer_from_buffer_now(led_dma, led_frame, BENCH_LED_COUNT);
+    dma_channel_wait_for_finish_blocking(led_dma);
+}
+
+typedef enum {
+    BENCH_CPU, // Só desenho: tempo de CPU
+    BENCH_I2C, // Envio ao OLED: tempo, transações e bytes
+    BENCH_PIO  // Envio aos LEDs: tempo
+} bench_kind_t;
+
+typedef struct {
+    const char *name;
+    void (*run)(int i);
+    bench_kind_t kind;
+} bench_load_t;
+
+static const bench_load_t bench_loads[] = {
+    {"clear", load_clear, BENCH_CPU},
+    {"pixels", load_pixels, BENCH_CPU},
+    {"line_fan", load_line_fan, BENCH_CPU},
+    {"text_draw_string", load_text_char, BENCH_CPU},
+    {"text_blit_string", load_text_blit, BENCH_CPU},
+    {"flush_full", load_flush_full, BENCH_I2C},
+    {"flush_digit", load_flush_digit, BENCH_I2C},
+    {"flush_diff_full", load_flush_diff_full, BENCH_I2C},
+    {"leds", load_leds, BENCH_PIO},
+};
+
+#if PICO_ON_DEVICE
+static uint64_t bench_cpu_ns(void) {
+    return time_us_64() * 1000;
+}
+#else
+static uint64_t bench_cpu_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+#endif
+
+// Menor tempo de CPU por repetição entre as medidas, em ns
+static double bench_cpu(void (*run)(int i)) {
+    double best = 0;
+    for (int trial = 0; trial < BENCH_TRIALS; trial++) {
+        uint64_t start = bench_cpu_ns();
+        for (int i = 0; i < BENCH_CPU_REPEAT; i++) {
+            run(i);
+        }
+        double ns = (double)(bench_cpu_ns() - start) / BENCH_CPU_REPEAT;
+        if (trial == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+static void bench_report(void) {
+    for (unsigned l = 0; l < count_of(bench_loads); l++) {
+        const bench_load_t *load = &bench_loads[l];
+        if (load->kind == BENCH_CPU) {
+            double ns = bench_cpu(load->run);
+#if PICO_ON_DEVICE
+            printf("%s,us,%.2f\n", load->name, ns / 1000);
+#else
+            // Referência medida logo depois de cada carga, nas mesmas condições da máquina
+            printf("%s,rel,%.3f\n", load->name, ns / bench_cpu(load_reference));
+#endif
+            continue;
+        }
+
+        // Cada carga de envio parte do quadro apagado, seja qual for o desenho anterior
+        ssd1306_clear_rect(frame, 0, 0, ssd1306_width, ssd1306_height);
+        uint32_t transactions = bus.stats.transactions;
+#if !PICO_ON_DEVICE
+        uint64_t bytes = panel.bytes;
+#endif
+        uint64_t start = time_us_64();
+        for (int i = 0; i < BENCH_BUS_REPEAT; i++) {
+            load->run(i);
+        }
+        printf("%s,us,%.2f\n", load->name, (double)(time_us_64() - start) / BENCH_BUS_REPEAT);
+        if (load->kind != BENCH_I2C) {
+            continue;
+        }
+        printf("%s,transactions,%.2f\n", load->name,
+               (double)(bus.stats.transactions - transactions) / BENCH_BUS_REPEAT);
+#if !PICO_ON_DEVICE
+        printf("%s,bytes,%.2f\n", load->name, (double)(panel.bytes - bytes) / BENCH_BUS_REPEAT);
+#endif
+    }
+}
+
+static void bench_init(void) {
+#if !PICO_ON_DEVICE
+    host_ssd1306_attach(&panel, i2c1, ssd1306_i2c_address);
+#endif
+    i2c_bus_init(&bus, i2c1, BENCH_SDA, BENCH_SCL);
+    ssd1306_attach(&oled, &bus, ssd1306_i2c_address, ssd1306_height, false);
+    ssd1306_init(&oled);
+
+    led_pio = pio0;
+    uint offset = pio_add_program(led_pio, &ws2818b_program);
+    led_sm = pio_claim_unused_sm(led_pio, true);
+    ws2818b_program_init(led_pio, led_sm, offset, BENCH_LED_PIN, 800000.f);
+    led_dma = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(led_dma);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(led_pio, led_sm, true));
+    dma_channel_configure(led_dma, &config, &led_pio->txf[led_sm], led_frame, BENCH_LED_COUNT, false);
+}
+
+int main() {
+    stdio_init_all();
+    bench_init();
+#if PICO_ON_DEVICE
+    while (true) {
+        bench_report();
+        sleep_ms(5000);
+    }
+#else
+    bench_report();
+    return 0;
+#endif
+}
@@ -0,0 +1,51 @@
+# Cabeçalhos gerados na compilação, comuns ao firmware e à compilação no host (testes e
+# simulação). Quem os usa depende do alvo chrono_generated e inclui ${CHRONO_GENERATED_DIR}
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+set(CHRONO_GENERATED_DIR ${PROJECT_BINARY_DIR}/generated)
+
+# Tabelas de máscaras da matriz de LEDs do relógio binário
+add_custom_command(
+    OUTPUT ${CHRONO_GENERATED_DIR}/led_tables.h
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${CHRONO_GENERATED_DIR}
+    COMMAND ${Python3_EXECUTABLE} ${PROJECT_SOURCE_DIR}/tools/gen_led_tables.py ${CHRONO_GENERATED_DIR}/led_tables.h
+    DEPENDS ${PROJECT_SOURCE_DIR}/tools/gen_led_tables.py
+    COMMENT "Gerando tabelas de LEDs do relógio binário"
+)
+
+# Atlas de glifos do OLED: texto em 8 pixels e o tempo em 16 pixels ("HH:MM:SS" ocupa a largura
+# toda; uma escala maior não caberia)
+add_custom_command(
+    OUTPUT ${CHRONO_GENERATED_DIR}/glyph_atlas.h
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${CHRONO_GENERATED_DIR}
+    COMMAND ${Python3_EXECUTABLE} ${PROJECT_SOURCE_DIR}/tools/gen_glyph_atlas.py
+        ${PROJECT_SOURCE_DIR}/fonts/font8x8.txt ${CHRONO_GENERATED_DIR}/glyph_atlas.h
+        font_8:1:0x20:0x7a font_16:2:0x20:0x7a
+    DEPENDS ${PROJECT_SOURCE_DIR}/tools/gen_glyph_atlas.py ${PROJECT_SOURCE_DIR}/fonts/font8x8.txt
+    COMMENT "Gerando atlas de glifos do OLED"
+)
+
+add_custom_target(chrono_generated DEPENDS
+    ${CHRONO_GENERATED_DIR}/led_tables.h
+    ${CHRONO_GENERATED_DIR}/glyph_atlas.h
+)
+
+# Converte uma sequência de imagens PBM 128x64 numa animação compactada em flash, gerando
+# generated/<NAME>.h com o ssd1306_anim_t <NAME> (ver inc/ssd1306_anim.h). Exemplo:
+#   chrono_add_animation(chronometer_project splash_anim 12 assets/splash_00.pbm assets/splash_01.pbm)
+function(chrono_add_animation TARGET NAME FPS)
+    set(output ${CHRONO_GENERATED_DIR}/${NAME}.h)
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${CHRONO_GENERATED_DIR}
+        COMMAND ${Python3_EXECUTABLE} ${PROJECT_SOURCE_DIR}/tools/gen_anim.py ${output} ${NAME} ${FPS} ${ARGN}
+        DEPENDS ${PROJECT_SOURCE_DIR}/tools/gen_anim.py ${ARGN}
+        WORKING_DIRECTORY ${PROJECT_SOURCE_DIR}
+        COMMENT "Gerando animação ${NAME}"
+    )
+    target_sources(${TARGET} PRIVATE ${output})
+endfunction()
+
+# Abertura tocada ao ligar (main.c): 12 quadros a 12 quadros/s, um segundo
+set(CHRONO_SPLASH_FPS 12)
+file(GLOB CHRONO_SPLASH_FRAMES ${PROJECT_SOURCE_DIR}/assets/splash_*.pbm)
+list(SORT CHRONO_SPLASH_FRAMES)
@@ -0,0 +1,412 @@
+// Simulação do firmware completo (main.c) no host, sobre o substituto do SDK e o relógio virtual.
+// Um roteiro aciona os botões e a USB em instantes definidos; o OLED é um modelo de SSD1306 no
+// i2c1 e os LEDs são capturados na saída do PIO. O que muda nas saídas vai para um registro em
+// texto, determinístico, para comparar execuções entre versões do firmware.
+//
+// Uso: chrono_sim [-s roteiro] [-t registro] [-o prefixo] [-d duração]
+//   -s roteiro   arquivo com os comandos (padrão: entrada padrão)
+//   -t registro  grava o registro das saídas (padrão: nenhum)
+//   -o prefixo   prefixo dos arquivos de "snapshot" (padrão: diretório atual)
+//   -d duração   tempo simulado total (padrão: fim do roteiro + 1 s)
+//
+// Roteiro: um comando por linha, "<instante> <comando> [argumentos]", com "#" para comentários.
+// O instante é absoluto desde o boot ou, com "+", relativo ao comando anterior, com unidade us,
+// ms, s, min ou h (ex.: 1.5s, +200ms). Comandos:
+//   press A|B / release A|B   pressiona ou solta o botão
+//   click A|B [duração]       pressiona e solta depois da duração (padrão 100ms)
+//   usb <hex...>              bytes recebidos pela USB CDC (ex.: quadros do protocolo do host)
+//   snapshot <nome>           grava <prefixo><nome>.pbm (OLED) e <prefixo><nome>.ppm (LEDs 5x5)
+//   end                       encerra a simulação nesse instante
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "pico_host.h"
+#include "host_ssd1306.h"
+
+extern int chrono_main(void); // main() de main.c, renomeado na compilação da simulação
+extern uint32_t np_frames_skipped; // Quadros iguais ao anterior, descartados pelo firmware antes da fita
+
+// Pinos e dimensões do firmware (main.c)
+#define SIM_BUTTON_A 5
+#define SIM_BUTTON_B 6
+#define SIM_LED_COUNT 25
+#define SIM_MATRIX_SIZE 5
+#define SIM_MAX_LINE 1024
+
+typedef enum {
+    SIM_PRESS,
+    SIM_RELEASE,
+    SIM_USB,
+    SIM_SNAPSHOT,
+    SIM_END
+} sim_kind_t;
+
+// Comando do roteiro já interpretado
+typedef struct {
+    uint64_t time_us;
+    sim_kind_t kind;
+    uint gpio;
+    char name[64];
+    uint8_t data[256];
+    size_t length;
+    int line;
+} sim_command_t;
+
+static sim_command_t *sim_commands;
+static int sim_command_count = 0;
+static int sim_command_next = 0;
+
+static const char *sim_prefix = "";
+static FILE *sim_trace = NULL;
+
+static host_ssd1306_t sim_oled;
+static uint32_t sim_oled_hash = 0;
+static uint32_t sim_oled_changes = 0;
+
+static uint32_t sim_leds[SIM_LED_COUNT];
+static uint32_t sim_led_frames = 0;
+static uint32_t sim_led_changes = 0;
+
+static uint64_t sim_usb_bytes = 0;
+
+static void sim_fail(int line, const char *message, const char *detail) {
+    fprintf(stderr, "roteiro:%d: %s: %s\n", line, message, detail);
+    exit(2);
+}
+
+// Instante com unidade; relative indica o prefixo "+"
+static uint64_t sim_parse_time(const char *text, bool *relative, int line) {
+    *relative = *text == '+';
+    if (*relative) {
+        text++;
+    }
+    char *unit;
+    double value = strtod(text, &unit);
+    if (unit == text) {
+        sim_fail(line, "instante inválido", text);
+    }
+    static const struct {
+        const char *name;
+        double us;
+    } units[] = {{"us", 1}, {"ms", 1e3}, {"s", 1e6}, {"min", 60e6}, {"h", 3600e6}};
+    for (unsigned i = 0; i < count_of(units); i++) {
+        if (strcmp(unit, units[i].name) == 0) {
+            return (uint64_t)(value * units[i].us + 0.5);
+        }
+    }
+    sim_fail(line, "unidade de tempo desconhecida", unit);
+    return 0;
+}
+
+static uint sim_parse_button(const char *text, int line) {
+    if (text && strcmp(text, "A") == 0) {
+        return SIM_BUTTON_A;
+    }
+    if (text && strcmp(text, "B") == 0) {
+        return SIM_BUTTON_B;
+    }
+    sim_fail(line, "botão desconhecido (use A ou B)", text ? text : "");
+    return 0;
+}
+
+static sim_command_t *sim_add(uint64_t time_us, sim_kind_t kind, int line) {
+    sim_commands = realloc(sim_commands, (sim_command_count + 1) * sizeof(sim_command_t));
+    sim_command_t *command = &sim_commands[sim_command_count++];
+    memset(command, 0, sizeof(*command));
+    command->time_us = time_us;
+    command->kind = kind;
+    command->line = line;
+    return command;
+}
+
+static int sim_compare(const void *a, const void *b) {
+    const sim_command_t *x = a, *y = b;
+    if (x->time_us != y->time_us) {
+        return x->time_us < y->time_us ? -1 : 1;
+    }
+    return x->line - y->line; // Mesmo instante: ordem do roteiro
+}
+
+static void sim_load_script(FILE *file) {
+    char text[SIM_MAX_LINE];
+    uint64_t previous = 0;
+    for (int line = 1; fgets(text, sizeof(text), file); line++) {
+        char *comment = strchr(text, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        char *time_text = strtok(text, " \t\r\n");
+        if (!time_text) {
+            continue;
+        }
+        char *verb = strtok(NULL, " \t\r\n");
+        if (!verb) {
+            sim_fail(line, "comando ausente", time_text);
+        }
+        bool relative;
+        uint64_t time_us = sim_parse_time(time_text, &relative, line);
+        if (relative) {
+            time_us += previous;
+        }
+        previous = time_us;
+
+        char *argument = strtok(NULL, " \t\r\n");
+        if (strcmp(verb, "press") == 0 || strcmp(verb, "release") == 0) {
+            sim_add(time_us, verb[0] == 'p' ? SIM_PRESS : SIM_RELEASE, line)->gpio = sim_parse_button(argument, line);
+        } else if (strcmp(verb, "click") == 0) {
+            uint gpio = sim_parse_button(argument, line);
+            char *duration = strtok(NULL, " \t\r\n");
+            uint64_t hold_us = 100000;
+            if (duration) {
+                hold_us = sim_parse_time(duration, &relative, line);
+            }
+            sim_add(time_us, SIM_PRESS, line)->gpio = gpio;
+            sim_add(time_us + hold_us, SIM_RELEASE, line)->gpio = gpio;
+        } else if (strcmp(verb, "usb") == 0) {
+            sim_command_t *command = sim_add(time_us, SIM_USB, line);
+            for (; argument; argument = strtok(NULL, " \t\r\n")) {
+                for (char *digit = argument; digit[0]; digit += 2) {
+                    if (!isxdigit((unsigned char)digit[0]) || !isxdigit((unsigned char)digit[1]) ||
+                        command->length == sizeof(command->data)) {
+                        sim_fail(line, "bytes hexadecimais inválidos", argument);
+                    }
+                    char pair[3] = {digit[0], digit[1], '\0'};
+                    command->data[command->length++] = (uint8_t)strtoul(pair, NULL, 16);
+                }
+            }
+        } else if (strcmp(verb, "snapshot") == 0) {
+            if (!argument) {
+                sim_fail(line, "snapshot sem nome", verb);
+            }
+            snprintf(sim_add(time_us, SIM_SNAPSHOT, line)->name, sizeof(sim_commands[0].name), "%s", argument);
+        } else if (strcmp(verb, "end") == 0) {
+            sim_add(time_us, SIM_END, line);
+        } else {
+            sim_fail(line, "comando desconhecido", verb);
+        }
+    }
+    qsort(sim_commands, sim_command_count, sizeof(sim_command_t), sim_compare);
+}
+
+// Índice do LED em (x, y) na fita: mesmo layout serpentina de tools/gen_led_tables.py
+static int sim_led_index(int x, int y) {
+    return y % 2 == 0 ? 24 - (y * SIM_MATRIX_SIZE + x) : 24 - (y * SIM_MATRIX_SIZE + (SIM_MATRIX_SIZE - 1 - x));
+}
+
+static void sim_snapshot(const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s.pbm", sim_prefix, name);
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        perror(path);
+        exit(1);
+    }
+    host_ssd1306_write_pbm(&sim_oled, file);
+    fclose(file);
+
+    // Matriz de LEDs como a vista de frente, em PPM texto (cores já corrigidas pelo compositor)
+    snprintf(path, sizeof(path), "%s%s.ppm", sim_prefix, name);
+    file = fopen(path, "w");
+    if (!file) {
+        perror(path);
+        exit(1);
+    }
+    fprintf(file, "P3\n%d %d\n255\n", SIM_MATRIX_SIZE, SIM_MATRIX_SIZE);
+    for (int y = 0; y < SIM_MATRIX_SIZE; y++) {
+        for (int x = 0; x < SIM_MATRIX_SIZE; x++) {
+            uint32_t grb = sim_leds[sim_led_index(x, y)];
+            fprintf(file, "%3u %3u %3u%s", (grb >> 16) & 0xFF, (grb >> 24) & 0xFF, (grb >> 8) & 0xFF,
+                    x + 1 < SIM_MATRIX_SIZE ? "  " : "\n");
+        }
+    }
+    fclose(file);
+}
+
+static void sim_schedule_next(void);
+
+// Executa os comandos do roteiro vencidos e agenda o seguinte (um por vez na fila do relógio)
+static void sim_run_command(void *context) {
+    while (sim_command_next < sim_command_count && sim_commands[sim_command_next].time_us <= time_us_64()) {
+        sim_command_t *command = &sim_commands[sim_command_next++];
+        switch (command->kind) {
+        case SIM_PRESS:
+            host_gpio_drive(command->gpio, false); // Botão ligado ao terra
+            break;
+        case SIM_RELEASE:
+            host_gpio_float(command->gpio);
+            break;
+        case SIM_USB:
+            host_usb_receive(command->data, command->length);
+            break;
+        case SIM_SNAPSHOT:
+            sim_snapshot(command->name);
+            break;
+        case SIM_END:
+            break;
+        }
+        if (sim_trace && command->kind != SIM_END) {
+            static const char *names[] = {"press", "release", "usb", "snapshot"};
+            fprintf(sim_trace, "%llu script %s", (unsigned long long)time_us_64(), names[command->kind]);
+            if (command->kind == SIM_PRESS || command->kind == SIM_RELEASE) {
+                fprintf(sim_trace, " %c", command->gpio == SIM_BUTTON_A ? 'A' : 'B');
+            } else if (command->kind == SIM_SNAPSHOT) {
+                fprintf(sim_trace, " %s", command->name);
+            } else {
+                fprintf(sim_trace, " %zu", command->length);
+            }
+            fputc('\n', sim_trace);
+        }
+    }
+    sim_schedule_next();
+}
+
+static void sim_schedule_next(void) {
+    if (sim_command_next < sim_command_count) {
+        host_at(sim_commands[sim_command_next].time_us, sim_run_command, NULL);
+    }
+}
+
+// Cada transação do OLED que muda a imagem visível entra no registro
+static bool (*sim_oled_write)(host_i2c_device_t *, const uint8_t *, size_t, uint64_t);
+
+static bool sim_oled_observe(host_i2c_device_t *device, const uint8_t *data, size_t length, uint64_t time_us) {
+    bool ack = sim_oled_write(device, data, length, time_us);
+    uint32_t hash = host_ssd1306_hash(&sim_oled);
+    if (hash != sim_oled_hash) {
+        sim_oled_hash = hash;
+        sim_oled_changes++;
+        if (sim_trace) {
+            fprintf(sim_trace, "%llu oled %08x on=%d inverse=%d contrast=%u start=%u\n", (unsigned long long)time_us,
+                    hash, sim_oled.display_on, sim_oled.inverse, sim_oled.contrast, sim_oled.start_line);
+        }
+    } else if (sim_trace && length == 3 && data[1] == 0x81) {
+        fprintf(sim_trace, "%llu oled contrast=%u\n", (unsigned long long)time_us, sim_oled.contrast);
+    }
+    return ack;
+}
+
+static void sim_pio_listener(PIO pio, uint sm, const uint32_t *words, uint count, uint64_t time_us, void *context) {
+    if (count != SIM_LED_COUNT) {
+        return;
+    }
+    sim_led_frames++;
+    if (memcmp(sim_leds, words, sizeof(sim_leds)) == 0) {
+        return;
+    }
+    memcpy(sim_leds, words, sizeof(sim_leds));
+    sim_led_changes++;
+    if (sim_trace) {
+        fprintf(sim_trace, "%llu leds", (unsigned long long)time_us);
+        for (int i = 0; i < SIM_LED_COUNT; i++) {
+            fprintf(sim_trace, " %06x", words[i] >> 8);
+        }
+        fputc('\n', sim_trace);
+    }
+}
+
+// Buzzers: frequência e ciclo de trabalho a cada mudança de uma fatia PWM ligada
+static void sim_pwm_listener(uint slice, void *context) {
+    if (!sim_trace) {
+        return;
+    }
+    const host_pwm_slice_t *pwm = host_pwm_slice(slice);
+    uint16_t level = pwm->level[0] > pwm->level[1] ? pwm->level[0] : pwm->level[1];
+    double divider = pwm->div_int + pwm->div_frac / 16.0;
+    double hz = pwm->enabled && divider > 0 ? 125e6 / (divider * (pwm->wrap + 1)) : 0;
+    fprintf(sim_trace, "%llu pwm %u %.0fHz level=%u\n", (unsigned long long)time_us_64(), slice, hz, level);
+}
+
+static void sim_usb_output(const uint8_t *data, size_t length, void *context) {
+    sim_usb_bytes += length;
+    if (sim_trace) {
+        fprintf(sim_trace, "%llu usb", (unsigned long long)time_us_64());
+        for (size_t i = 0; i < length; i++) {
+            fprintf(sim_trace, " %02x", data[i]);
+        }
+        fputc('\n', sim_trace);
+    }
+}
+
+static void sim_firmware(void) {
+    chrono_main();
+}
+
+int main(int argc, char **argv) {
+    const char *script_path = NULL, *trace_path = NULL;
+    uint64_t duration_us = 0;
+    int option;
+    while ((option = getopt(argc, argv, "s:t:o:d:")) != -1) {
+        bool relative;
+        switch (option) {
+        case 's':
+            script_path = optarg;
+            break;
+        case 't':
+            trace_path = optarg;
+            break;
+        case 'o':
+            sim_prefix = optarg;
+            break;
+        case 'd':
+            duration_us = sim_parse_time(optarg, &relative, 0);
+            break;
+        default:
+            fprintf(stderr, "uso: %s [-s roteiro] [-t registro] [-o prefixo] [-d duração]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *script = script_path ? fopen(script_path, "r") : stdin;
+    if (!script) {
+        perror(script_path);
+        return 1;
+    }
+    sim_load_script(script);
+    if (script != stdin) {
+        fclose(script);
+    }
+    if (trace_path) {
+        sim_trace = fopen(trace_path, "w");
+        if (!sim_trace) {
+            perror(trace_path);
+            return 1;
+        }
+    }
+    if (!duration_us) {
+        duration_us = sim_command_count ? sim_commands[sim_command_count - 1].time_us : 0;
+        bool ends = sim_command_count && sim_commands[sim_command_count - 1].kind == SIM_END;
+        duration_us += ends ? 0 : 1000000;
+    }
+
+    host_ssd1306_attach(&sim_oled, i2c1, 0x3C);
+    sim_oled_write = sim_oled.device.write;
+    sim_oled.device.write = sim_oled_observe;
+    host_pio_set_listener(sim_pio_listener, NULL);
+    host_pwm_set_listener(sim_pwm_listener, NULL);
+    host_usb_set_output(sim_usb_output, NULL);
+    sim_schedule_next();
+
+    clock_t started = clock();
+    host_run(sim_firmware, duration_us);
+    double wall_s = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+    printf("simulado: %.3f s em %.2f s\n", time_us_64() / 1e6, wall_s);
+    printf("oled: %u transações, %llu bytes (%u na GDDRAM), %u mudanças de imagem\n", sim_oled.transactions,
+           (unsigned long long)sim_oled.bytes, sim_oled.data_bytes, sim_oled_changes);
+    printf("leds: %u quadros recebidos, %u mudanças, %u repetidos descartados pelo firmware\n", sim_led_frames,
+           sim_led_changes, np_frames_skipped);
+    printf("usb: %llu bytes enviados\n", (unsigned long long)sim_usb_bytes);
+    printf("latência máxima de interrupção: botões %llu us, temporizador %llu us, dma %llu us\n",
+           (unsigned long long)host_irq_latency_max_us(IO_IRQ_BANK0),
+           (unsigned long long)host_irq_latency_max_us(TIMER_IRQ_0),
+           (unsigned long long)host_irq_latency_max_us(DMA_IRQ_0));
+    if (sim_trace) {
+        fclose(sim_trace);
+    }
+    return 0;
+}
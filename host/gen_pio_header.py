@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""Gera, para a compilação no host, o equivalente ao cabeçalho do pioasm de um arquivo .pio.
+
+Cada programa vira um pio_program_t do substituto do SDK (host/include/hardware/pio.h), sem as
+instruções: o emulador só precisa do ritmo com que a máquina de estados consome a FIFO. Os
+blocos "% c-sdk" são copiados como estão, como faz o pioasm.
+
+Uso: gen_pio_header.py <entrada.pio> <saída.h>
+"""
+import re
+import sys
+
+# Ciclos por tempo de bit e bits consumidos pela instrução out a cada tempo de bit. Um programa
+# novo precisa entrar aqui (os caminhos de desvio impedem deduzir o ritmo das instruções)
+TIMING = {
+    "ws2818b": (10, 1),
+    "ws2818b_parallel": (10, 8),
+}
+
+
+def main():
+    source_path, output_path = sys.argv[1:3]
+    with open(source_path) as f:
+        source = f.read()
+
+    programs = []
+    blocks = []
+    current = None
+    in_block = False
+    for line in source.splitlines():
+        stripped = line.strip()
+        if in_block:
+            if stripped == "%}":
+                in_block = False
+            else:
+                blocks[-1][1].append(line)
+            continue
+        match = re.match(r"\.program\s+(\w+)", stripped)
+        if match:
+            current = {"name": match.group(1), "length": 0}
+            programs.append(current)
+        elif stripped.startswith("% c-sdk {"):
+            in_block = True
+            blocks.append((current["name"] if current else None, []))
+        elif current and stripped and not stripped.startswith((".", ";")) and not stripped.endswith(":"):
+            current["length"] += 1
+
+    out = [
+        f"// Gerado por host/gen_pio_header.py a partir de {source_path.split('/')[-1]} (não editar)",
+        "#pragma once",
+        "",
+        '#include "hardware/pio.h"',
+        "",
+    ]
+    for program in programs:
+        name = program["name"]
+        if name not in TIMING:
+            sys.exit(f"{source_path}: programa {name} sem ritmo definido em gen_pio_header.py")
+        cycles, out_bits = TIMING[name]
+        out += [
+            f"static const pio_program_t {name}_program = {{",
+            f"    NULL, {program['length']}, -1, {cycles}, {out_bits}",
+            "};",
+            "",
+            f"static inline pio_sm_config {name}_program_get_default_config(uint offset) {{",
+            "    pio_sm_config c = pio_get_default_sm_config();",
+            "    c.offset = offset;",
+            "    return c;",
+            "}",
+            "",
+        ]
+    for _, lines in blocks:
+        out += lines + [""]
+
+    with open(output_path, "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+#include <string.h>
+#include "host_ssd1306.h"
+
+// Argumentos que seguem cada comando (os demais não têm nenhum)
+static uint8_t host_ssd1306_arguments(uint8_t command) {
+    switch (command) {
+    case 0x20: // Modo de endereçamento
+    case 0x81: // Contraste
+    case 0x8D: // Bomba de carga
+    case 0xA8: // Multiplexação
+    case 0xD3: // Deslocamento vertical
+    case 0xD5: // Divisor do relógio
+    case 0xD9: // Pré-carga
+    case 0xDA: // Pinos COM
+    case 0xDB: // Nível VCOMH
+        return 1;
+    case 0x21: // Janela de colunas
+    case 0x22: // Janela de páginas
+    case 0xA3: // Área de rolagem vertical
+        return 2;
+    case 0x29: // Rolagem vertical e horizontal
+    case 0x2A:
+        return 5;
+    case 0x26: // Rolagem horizontal
+    case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void host_ssd1306_execute(host_ssd1306_t *panel) {
+    const uint8_t *c = panel->command;
+    switch (c[0]) {
+    case 0x20:
+        panel->memory_mode = c[1] & 0x03;
+        break;
+    case 0x21:
+        panel->column_start = panel->column = c[1] & 0x7F;
+        panel->column_end = c[2] & 0x7F;
+        break;
+    case 0x22:
+        panel->page_start = panel->page = c[1] & 0x07;
+        panel->page_end = c[2] & 0x07;
+        break;
+    case 0x2E:
+        panel->scrolling = false;
+        break;
+    case 0x2F:
+        panel->scrolling = true;
+        break;
+    case 0x81:
+        panel->contrast = c[1];
+        break;
+    case 0xA4:
+    case 0xA5:
+        panel->entire_on = c[0] & 0x01;
+        break;
+    case 0xA6:
+    case 0xA7:
+        panel->inverse = c[0] & 0x01;
+        break;
+    case 0xAE:
+    case 0xAF:
+        panel->display_on = c[0] & 0x01;
+        break;
+    default:
+        if (c[0] >= 0x40 && c[0] <= 0x7F) {
+            panel->start_line = c[0] & 0x3F;
+        } else if (c[0] >= 0xB0 && c[0] <= 0xB7) {
+            panel->page = c[0] & 0x07; // Página inicial no endereçamento de página
+        } else if (c[0] <= 0x0F) {
+            panel->column = (panel->column & 0xF0) | c[0];
+        } else if (c[0] <= 0x1F) {
+            panel->column = (panel->column & 0x0F) | (uint8_t)((c[0] & 0x07) << 4);
+        }
+        break;
+    }
+}
+
+static void host_ssd1306_command_byte(host_ssd1306_t *panel, uint8_t byte) {
+    if (panel->command_length == 0) {
+        panel->command_expected = host_ssd1306_arguments(byte);
+    }
+    panel->command[panel->command_length++] = byte;
+    if (panel->command_length > panel->command_expected) {
+        host_ssd1306_execute(panel);
+        panel->command_length = 0;
+    }
+}
+
+// Grava um byte na GDDRAM e avança o ponteiro dentro da janela, como no controlador
+static void host_ssd1306_data_byte(host_ssd1306_t *panel, uint8_t byte) {
+    panel->gddram[panel->page][panel->column] = byte;
+    panel->data_bytes++;
+    if (panel->memory_mode == 2) {
+        panel->column = (panel->column + 1) & 0x7F;
+        return;
+    }
+    if (panel->memory_mode == 0) {
+        if (panel->column++ >= panel->column_end) {
+            panel->column = panel->column_start;
+            panel->page = panel->page >= panel->page_end ? panel->page_start : panel->page + 1;
+        }
+    } else if (panel->page++ >= panel->page_end) {
+        panel->page = panel->page_start;
+        panel->column = panel->column >= panel->column_end ? panel->column_start : panel->column + 1;
+    }
+}
+
+// Transação completa: bytes de controle com Co = 1 valem para um único byte; com Co = 0, para
+// todos os seguintes. D/C# escolhe entre comandos e dados da GDDRAM
+static bool host_ssd1306_write(host_i2c_device_t *device, const uint8_t *data, size_t length, uint64_t time_us) {
+    host_ssd1306_t *panel = device->context;
+    panel->transactions++;
+    panel->bytes += length;
+
+    size_t i = 0;
+    while (i < length) {
+        uint8_t control = data[i++];
+        bool is_data = control & 0x40;
+        size_t end = (control & 0x80) ? (i + 1 < length ? i + 1 : length) : length;
+        for (; i < end; i++) {
+            if (is_data) {
+                host_ssd1306_data_byte(panel, data[i]);
+            } else {
+                host_ssd1306_command_byte(panel, data[i]);
+            }
+        }
+    }
+    return true;
+}
+
+void host_ssd1306_attach(host_ssd1306_t *panel, i2c_inst_t *i2c, uint8_t address) {
+    memset(panel, 0, sizeof(*panel));
+    panel->column_end = host_ssd1306_width - 1;
+    panel->page_end = host_ssd1306_pages - 1;
+    panel->memory_mode = 2; // Estado após o reset do controlador
+    panel->contrast = 0x7F;
+    panel->device.address = address;
+    panel->device.write = host_ssd1306_write;
+    panel->device.context = panel;
+    host_i2c_attach(i2c, &panel->device);
+}
+
+bool host_ssd1306_pixel(const host_ssd1306_t *panel, int x, int y) {
+    if (!panel->display_on) {
+        return false;
+    }
+    if (panel->entire_on) {
+        return true;
+    }
+    int row = (y + panel->start_line) % host_ssd1306_height;
+    bool lit = panel->gddram[row / 8][x] & (1 << (row % 8));
+    return lit != panel->inverse;
+}
+
+uint32_t host_ssd1306_hash(const host_ssd1306_t *panel) {
+    uint32_t hash = 2166136261u;
+    for (int y = 0; y < host_ssd1306_height; y++) {
+        for (int x = 0; x < host_ssd1306_width; x += 8) {
+            uint8_t bits = 0;
+            for (int i = 0; i < 8; i++) {
+                bits = (uint8_t)(bits << 1 | host_ssd1306_pixel(panel, x + i, y));
+            }
+            hash = (hash ^ bits) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+void host_ssd1306_write_pbm(const host_ssd1306_t *panel, FILE *file) {
+    fprintf(file, "P1\n%d %d\n", host_ssd1306_width, host_ssd1306_height);
+    for (int y = 0; y < host_ssd1306_height; y++) {
+        for (int x = 0; x < host_ssd1306_width; x++) {
+            fputc(host_ssd1306_pixel(panel, x, y) ? '1' : '0', file);
+        }
+        fputc('\n', file);
+    }
+}
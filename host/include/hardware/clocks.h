@@ -0,0 +1,27 @@
+#ifndef _HARDWARE_CLOCKS_H
+#define _HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_peri = 6,
+};
+
+#define host_clk_sys_hz 125000000u
+
+static inline uint32_t clock_get_hz(enum clock_index clk_index) {
+    return clk_index == clk_ref ? 12000000u : host_clk_sys_hz;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
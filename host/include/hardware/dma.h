@@ -0,0 +1,66 @@
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+// Campos de ctrl, nas mesmas posições do registrador CTRL do RP2040
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB 2
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS 0x0000000cu
+#define DMA_CH0_CTRL_TRIG_INCR_READ_BITS 0x00000010u
+#define DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS 0x00000020u
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB 15
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS 0x001f8000u
+
+extern int dma_claim_unused_channel(bool required);
+extern void dma_channel_unclaim(uint channel);
+extern dma_channel_config dma_channel_get_default_config(uint channel);
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) | ((uint32_t)size << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? c->ctrl | DMA_CH0_CTRL_TRIG_INCR_READ_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_READ_BITS;
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->ctrl = incr ? c->ctrl | DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS : c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS;
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) | (dreq << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB);
+}
+
+extern void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                                  const volatile void *read_addr, uint transfer_count, bool trigger);
+extern void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+extern void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+extern void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count);
+extern bool dma_channel_is_busy(uint channel);
+extern void dma_channel_wait_for_finish_blocking(uint channel);
+extern void dma_channel_abort(uint channel);
+extern void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+extern bool dma_channel_get_irq0_status(uint channel);
+extern void dma_channel_acknowledge_irq0(uint channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef _HARDWARE_FLASH_H
+#define _HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define FLASH_BLOCK_SIZE (1u << 16)
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#endif
+
+// A flash emulada fica na RAM; XIP_BASE aponta para ela, e a leitura "mapeada" é um acesso comum
+extern uint8_t host_flash_memory[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)host_flash_memory)
+
+extern void flash_range_erase(uint32_t flash_offs, size_t count);
+extern void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
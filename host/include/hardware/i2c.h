@@ -0,0 +1,59 @@
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Registradores do controlador acessados diretamente pelo firmware. No host são campos comuns:
+// o emulador atualiza status e raw_intr_stat com o tempo e lê tar e data_cmd (via DMA)
+typedef struct {
+    volatile uint32_t con, tar, sar, _pad0, data_cmd, ss_scl_hcnt, ss_scl_lcnt, fs_scl_hcnt, fs_scl_lcnt, _pad1[2];
+    volatile uint32_t intr_stat, intr_mask, raw_intr_stat, rx_tl, tx_tl, clr_intr, clr_rx_under, clr_rx_over;
+    volatile uint32_t clr_tx_over, clr_rd_req, clr_tx_abrt, clr_rx_done, clr_activity, clr_stop_det;
+    volatile uint32_t clr_start_det, clr_gen_call, enable, status, txflr, rxflr, sda_hold, tx_abrt_source;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    i2c_hw_t *hw;
+    bool restart_on_next;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_STATUS_ACTIVITY_BITS 0x00000001u
+#define I2C_IC_STATUS_TFE_BITS 0x00000004u
+#define I2C_IC_TAR_IC_TAR_BITS 0x000003ffu
+
+extern uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+extern void i2c_deinit(i2c_inst_t *i2c);
+extern uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+extern int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                                uint timeout_us);
+extern int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return i2c->hw;
+}
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c == i2c1 ? 1 : 0;
+}
+
+// DREQ_I2C0_TX = 32, DREQ_I2C0_RX = 33, DREQ_I2C1_TX = 34, DREQ_I2C1_RX = 35
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return 32 + 2 * i2c_hw_index(i2c) + (is_tx ? 0 : 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
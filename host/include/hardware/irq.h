@@ -0,0 +1,36 @@
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Números das interrupções do RP2040 usadas pelo projeto
+#define TIMER_IRQ_0 0
+#define USBCTRL_IRQ 5
+#define PIO0_IRQ_0 7
+#define PIO1_IRQ_0 9
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+#define IO_IRQ_BANK0 13
+#define I2C0_IRQ 23
+#define I2C1_IRQ 24
+#define NUM_IRQS 32
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+#define PICO_SHARED_IRQ_HANDLER_HIGHEST_ORDER_PRIORITY 0xff
+#define PICO_SHARED_IRQ_HANDLER_LOWEST_ORDER_PRIORITY 0x00
+
+typedef void (*irq_handler_t)(void);
+
+extern void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+extern void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+extern void irq_set_enabled(uint num, bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef _HARDWARE_PIO_H
+#define _HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_PIO_STATE_MACHINES 4
+#define PIO_INSTRUCTION_COUNT 32
+
+// Só as FIFOs de transmissão são endereçadas pelo firmware (destino do DMA)
+typedef struct {
+    volatile uint32_t ctrl, fstat, fdebug, flevel;
+    volatile uint32_t txf[NUM_PIO_STATE_MACHINES];
+    volatile uint32_t rxf[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t host_pio_hw[2];
+#define pio0 (&host_pio_hw[0])
+#define pio1 (&host_pio_hw[1])
+
+// O programa não é executado: o emulador só precisa do ritmo de consumo da FIFO, dado pelos
+// ciclos por tempo de bit e pelos bits consumidos a cada tempo de bit (instrução out)
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+    uint8_t host_cycles_per_bit;
+    uint8_t host_out_bits;
+} pio_program_t;
+
+typedef struct {
+    uint32_t offset;
+    float clkdiv;
+    uint8_t shift_threshold;
+    bool shift_right;
+    uint out_base, out_count, sideset_base;
+} pio_sm_config;
+
+enum pio_fifo_join {
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+static inline pio_sm_config pio_get_default_sm_config(void) {
+    pio_sm_config c = {0, 1.0f, 32, true, 0, 0, 0};
+    return c;
+}
+
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold) {
+    c->shift_right = shift_right;
+    c->shift_threshold = (uint8_t)pull_threshold;
+}
+
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div) {
+    c->clkdiv = div;
+}
+
+static inline void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count) {
+    c->out_base = out_base;
+    c->out_count = out_count;
+}
+
+static inline void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base) {
+    c->sideset_base = sideset_base;
+}
+
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) {
+}
+
+extern bool pio_can_add_program(PIO pio, const pio_program_t *program);
+extern uint pio_add_program(PIO pio, const pio_program_t *program);
+extern int pio_claim_unused_sm(PIO pio, bool required);
+extern void pio_gpio_init(PIO pio, uint pin);
+extern void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+extern void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+extern void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+extern void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+static inline uint pio_get_index(PIO pio) {
+    return pio == pio1 ? 1 : 0;
+}
+
+// DREQ_PIO0_TX0 = 0 ... DREQ_PIO1_RX3 = 15
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    return pio_get_index(pio) * 8 + (is_tx ? 0 : 4) + sm;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef _HARDWARE_PWM_H
+#define _HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_PWM_SLICES 8
+
+enum pwm_chan {
+    PWM_CHAN_A = 0,
+    PWM_CHAN_B = 1,
+};
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1u) & 7u;
+}
+
+static inline uint pwm_gpio_to_channel(uint gpio) {
+    return gpio & 1u;
+}
+
+extern void pwm_set_wrap(uint slice_num, uint16_t wrap);
+extern void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract);
+extern void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level);
+extern void pwm_set_enabled(uint slice_num, bool enabled);
+
+static inline void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
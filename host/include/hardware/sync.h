@@ -0,0 +1,7 @@
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+// save_and_disable_interrupts e restore_interrupts ficam em pico/stdlib.h, que todo módulo inclui
+#include "pico/stdlib.h"
+
+#endif
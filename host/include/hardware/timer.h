@@ -0,0 +1,6 @@
+#ifndef _HARDWARE_TIMER_H
+#define _HARDWARE_TIMER_H
+
+#include "pico/stdlib.h"
+
+#endif
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include "pico_host.h"
+
+#ifndef host_ssd1306_inc_h
+#define host_ssd1306_inc_h
+
+// Modelo de um painel SSD1306 128x64 escravo num barramento i2c emulado: interpreta os bytes de
+// controle, os comandos (com seus argumentos) e os dados gravados na GDDRAM pelo endereçamento
+// horizontal ou de página, e expõe a imagem visível (ligado, vídeo inverso, linha inicial)
+#define host_ssd1306_width 128
+#define host_ssd1306_pages 8
+#define host_ssd1306_height (host_ssd1306_pages * 8)
+
+typedef struct {
+    host_i2c_device_t device;
+
+    uint8_t gddram[host_ssd1306_pages][host_ssd1306_width];
+    uint8_t memory_mode; // 0: horizontal, 1: vertical, 2: página
+    uint8_t column_start, column_end, page_start, page_end;
+    uint8_t column, page; // Ponteiro de escrita
+    uint8_t contrast;
+    uint8_t start_line;
+    bool display_on;
+    bool inverse;
+    bool entire_on;
+    bool scrolling;
+
+    // Comando em recepção, à espera dos seus argumentos
+    uint8_t command[8];
+    uint8_t command_length;
+    uint8_t command_expected;
+
+    uint32_t transactions;
+    uint64_t bytes;
+    uint32_t data_bytes;
+} host_ssd1306_t;
+
+extern void host_ssd1306_attach(host_ssd1306_t *panel, i2c_inst_t *i2c, uint8_t address);
+
+// Pixel visível em (x, y), com o estado do painel aplicado (desligado: apagado)
+extern bool host_ssd1306_pixel(const host_ssd1306_t *panel, int x, int y);
+
+// Resumo da imagem visível (FNV-1a), para detectar mudanças e comparar execuções
+extern uint32_t host_ssd1306_hash(const host_ssd1306_t *panel);
+
+// Grava a imagem visível como PBM (P1, texto, 1 = aceso)
+extern void host_ssd1306_write_pbm(const host_ssd1306_t *panel, FILE *file);
+
+#endif
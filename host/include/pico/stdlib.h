@@ -0,0 +1,105 @@
+// Substituto do Pico SDK para compilar o firmware no host (Linux), usado pelos testes e pela
+// simulação. Só o subconjunto da API usado pelo projeto, com a mesma semântica: relógio virtual
+// (avança apenas quando o código espera ou dorme), alarmes, interrupções adiadas enquanto
+// mascaradas e periféricos emulados em host/pico_host.c. O controle fica em pico_host.h
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef unsigned int uint;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __not_in_flash_func(f) f
+#define __time_critical_func(f) f
+#define __aligned(x) __attribute__((aligned(x)))
+
+#define PICO_OK 0
+#define PICO_ERROR_TIMEOUT -1
+#define PICO_ERROR_GENERIC -2
+
+extern void panic(const char *fmt, ...) __attribute__((noreturn));
+
+// Núcleo: a espera por interrupção avança o relógio até o próximo evento; laços de espera ativa
+// avançam 1 us por volta, como se cada volta custasse esse tempo
+extern void tight_loop_contents(void);
+extern void __wfi(void);
+extern void __wfe(void);
+static inline void __sev(void) {}
+static inline void __dmb(void) { __sync_synchronize(); }
+static inline void __compiler_memory_barrier(void) { __asm__ volatile("" ::: "memory"); }
+static inline uint get_core_num(void) { return 0; }
+
+extern uint32_t save_and_disable_interrupts(void);
+extern void restore_interrupts(uint32_t status);
+
+// Tempo
+typedef uint64_t absolute_time_t;
+
+extern uint64_t time_us_64(void);
+extern uint32_t time_us_32(void);
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return time_us_64() + ms * 1000ull; }
+
+extern void busy_wait_us(uint64_t delay_us);
+extern void busy_wait_until(absolute_time_t t);
+static inline void busy_wait_us_32(uint32_t delay_us) { busy_wait_us(delay_us); }
+static inline void busy_wait_ms(uint32_t delay_ms) { busy_wait_us(delay_ms * 1000ull); }
+extern void sleep_until(absolute_time_t t);
+static inline void sleep_us(uint64_t delay_us) { sleep_until(time_us_64() + delay_us); }
+static inline void sleep_ms(uint32_t delay_ms) { sleep_us(delay_ms * 1000ull); }
+
+// Alarmes (um único grupo, como o grupo padrão do SDK: 16 alarmes)
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+extern alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past);
+static inline alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_at(time_us_64() + us, callback, user_data, fire_if_past);
+}
+static inline alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_in_us(ms * 1000ull, callback, user_data, fire_if_past);
+}
+extern bool cancel_alarm(alarm_id_t id);
+
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+
+struct repeating_timer {
+    int64_t delay_us;
+    void *pool;
+    alarm_id_t alarm_id;
+    repeating_timer_callback_t callback;
+    void *user_data;
+};
+
+extern bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data,
+                                   repeating_timer_t *out);
+static inline bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data,
+                                          repeating_timer_t *out) {
+    return add_repeating_timer_us(delay_ms * (int64_t)1000, callback, user_data, out);
+}
+extern bool cancel_repeating_timer(repeating_timer_t *timer);
+
+// stdio: printf vai para a saída padrão do processo; a entrada é a da USB emulada (tusb.h)
+extern bool stdio_init_all(void);
+extern int getchar_timeout_us(uint32_t timeout_us);
+extern void stdio_set_chars_available_callback(void (*fn)(void *), void *param);
+
+#ifdef __cplusplus
+}
+#endif
+
+#include "hardware/gpio.h"
+
+#endif
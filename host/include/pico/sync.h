@@ -0,0 +1,31 @@
+#ifndef _PICO_SYNC_H
+#define _PICO_SYNC_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Um só núcleo no host: a seção crítica é apenas a máscara de interrupções
+typedef struct {
+    uint32_t save;
+} critical_section_t;
+
+static inline void critical_section_init(critical_section_t *crit_sec) {
+    crit_sec->save = 0;
+}
+
+static inline void critical_section_enter_blocking(critical_section_t *crit_sec) {
+    crit_sec->save = save_and_disable_interrupts();
+}
+
+static inline void critical_section_exit(critical_section_t *crit_sec) {
+    restore_interrupts(crit_sec->save);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/pio.h"
+
+#ifndef pico_host_inc_h
+#define pico_host_inc_h
+
+// Controle do substituto do SDK pelos testes e pela simulação.
+//
+// O relógio virtual só avança quando o firmware espera (busy_wait, sleep, tight_loop_contents,
+// transferências bloqueantes) ou dorme em __wfi, ou quando o teste chama host_advance_*. Ao
+// avançar, as ações agendadas vencidas (fim de DMA, bordas de botões, alarmes) são aplicadas em
+// ordem de tempo; as interrupções que elas levantam são atendidas assim que não estiverem
+// mascaradas, como num núcleo com um único nível de prioridade
+
+typedef void (*host_action_t)(void *context);
+
+// Agenda uma ação do "mundo externo" (fora das interrupções do firmware) no relógio virtual
+extern void host_at(uint64_t time_us, host_action_t action, void *context);
+extern void host_advance_to(uint64_t time_us);
+extern void host_advance_us(uint64_t delay_us);
+
+// Executa entry (ex.: o main do firmware) até o relógio chegar a until_us. Retorna true se
+// parou pelo tempo, false se entry retornou antes
+extern bool host_run(void (*entry)(void), uint64_t until_us);
+
+// Maior atraso, desde o boot, entre uma interrupção ficar pendente e seu atendimento (irq de
+// hardware/irq.h, ex.: IO_IRQ_BANK0 para as bordas dos botões)
+extern uint64_t host_irq_latency_max_us(uint irq);
+
+// Nível imposto por um circuito externo a um pino de entrada (ex.: botão ligado ao terra),
+// gerando as bordas correspondentes; host_gpio_float devolve o pino aos pull-ups
+extern void host_gpio_drive(uint gpio, bool level);
+extern void host_gpio_drive_at(uint64_t time_us, uint gpio, bool level);
+extern void host_gpio_float(uint gpio);
+
+// Dispositivo escravo num barramento i2c emulado. write recebe cada transação de escrita
+// completa (até o STOP) e retorna false para responder NAK aos dados
+typedef struct host_i2c_device {
+    uint8_t address;
+    uint max_baudrate; // Maior velocidade aceita (0: qualquer); acima dela o endereço recebe NAK
+    bool (*write)(struct host_i2c_device *device, const uint8_t *data, size_t length, uint64_t time_us);
+    void *context;
+    struct host_i2c_device *next;
+} host_i2c_device_t;
+
+extern void host_i2c_attach(i2c_inst_t *i2c, host_i2c_device_t *device);
+
+// Falha as próximas count transações do barramento: PICO_ERROR_GENERIC responde NAK ao
+// endereço; PICO_ERROR_TIMEOUT trava o barramento (SDA preso) até a recuperação (i2c_deinit)
+extern void host_i2c_fail(i2c_inst_t *i2c, uint count, int error);
+
+// Recebe as palavras de cada envio via DMA à FIFO de uma máquina de estados, ao fim da transmissão
+typedef void (*host_pio_listener_t)(PIO pio, uint sm, const uint32_t *words, uint count, uint64_t time_us,
+                                    void *context);
+extern void host_pio_set_listener(host_pio_listener_t listener, void *context);
+
+// Estado de uma fatia PWM; o observador é chamado a cada mudança
+typedef struct {
+    uint16_t wrap;
+    uint8_t div_int;
+    uint8_t div_frac;
+    uint16_t level[2];
+    bool enabled;
+} host_pwm_slice_t;
+
+extern const host_pwm_slice_t *host_pwm_slice(uint slice);
+extern void host_pwm_set_listener(void (*listener)(uint slice, void *context), void *context);
+
+// USB CDC: bytes vindos do host chegam de imediato e disparam a interrupção da stdio; o que o
+// firmware envia é entregue a output a cada tud_cdc_write_flush
+extern void host_usb_receive(const uint8_t *data, size_t length);
+extern void host_usb_set_output(void (*output)(const uint8_t *data, size_t length, void *context), void *context);
+extern void host_usb_set_connected(bool connected);
+
+#endif
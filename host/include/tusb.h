@@ -0,0 +1,24 @@
+#ifndef _TUSB_H_
+#define _TUSB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Interface CDC emulada: o host injeta bytes com host_usb_receive e recolhe o que foi enviado
+// com host_usb_set_output (pico_host.h)
+extern bool tud_cdc_connected(void);
+extern uint32_t tud_cdc_available(void);
+extern uint32_t tud_cdc_read(void *buffer, uint32_t bufsize);
+extern uint32_t tud_cdc_write_available(void);
+extern uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize);
+extern uint32_t tud_cdc_write_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
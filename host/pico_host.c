@@ -0,0 +1,1167 @@
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "tusb.h"
+#include "pico_host.h"
+
+// ---------------------------------------------------------------------------------------------
+// Relógio virtual e ações agendadas
+
+#define host_max_actions 512
+
+typedef struct {
+    uint64_t time_us;
+    uint64_t order; // Desempate: ações do mesmo instante seguem a ordem de agendamento
+    host_action_t action;
+    void *context;
+} host_scheduled_t;
+
+static uint64_t host_now = 0;
+static host_scheduled_t host_actions[host_max_actions];
+static int host_action_count = 0;
+static uint64_t host_action_order = 0;
+
+static bool host_running = false;
+static uint64_t host_run_until = 0;
+static jmp_buf host_run_exit;
+
+void panic(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "panic em %llu us: ", (unsigned long long)host_now);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    abort();
+}
+
+void host_at(uint64_t time_us, host_action_t action, void *context) {
+    if (host_action_count == host_max_actions) {
+        panic("host: mais de %d ações agendadas", host_max_actions);
+    }
+    host_actions[host_action_count++] = (host_scheduled_t){time_us, host_action_order++, action, context};
+}
+
+// Índice da próxima ação (-1: nenhuma)
+static int host_next_action(void) {
+    int next = -1;
+    for (int i = 0; i < host_action_count; i++) {
+        if (next < 0 || host_actions[i].time_us < host_actions[next].time_us ||
+            (host_actions[i].time_us == host_actions[next].time_us && host_actions[i].order < host_actions[next].order)) {
+            next = i;
+        }
+    }
+    return next;
+}
+
+// Aplica a próxima ação se ela vence até limit; retorna false se não havia nenhuma
+static bool host_apply_next(uint64_t limit) {
+    int next = host_next_action();
+    if (next < 0 || host_actions[next].time_us > limit) {
+        return false;
+    }
+    host_scheduled_t scheduled = host_actions[next];
+    host_actions[next] = host_actions[--host_action_count];
+    if (scheduled.time_us > host_now) {
+        host_now = scheduled.time_us;
+    }
+    scheduled.action(scheduled.context);
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Interrupções: um único nível de prioridade, atendidas quando não mascaradas (PRIMASK) e fora
+// de outra interrupção. As internas (alarmes, bordas, USB) estão sempre habilitadas no NVIC
+
+#define host_max_shared_handlers 4
+
+static bool host_masked = false;
+static bool host_in_irq = false;
+static uint32_t host_irq_pending = 0;
+static uint32_t host_irq_enabled = (1u << TIMER_IRQ_0) | (1u << IO_IRQ_BANK0) | (1u << USBCTRL_IRQ);
+static uint64_t host_irq_pending_since[NUM_IRQS];
+static uint64_t host_irq_latency_max[NUM_IRQS];
+static irq_handler_t host_irq_handlers[NUM_IRQS][host_max_shared_handlers];
+static uint8_t host_irq_priorities[NUM_IRQS][host_max_shared_handlers];
+static int host_irq_handler_count[NUM_IRQS];
+
+static void host_timer_irq(void);
+static void host_gpio_irq(void);
+static void host_usb_irq(void);
+static void host_dma_irq(void);
+
+static void host_raise(uint irq) {
+    if (!(host_irq_pending & (1u << irq))) {
+        host_irq_pending |= 1u << irq;
+        host_irq_pending_since[irq] = host_now;
+    }
+}
+
+static void host_dispatch(uint irq) {
+    switch (irq) {
+    case TIMER_IRQ_0:
+        host_timer_irq();
+        break;
+    case IO_IRQ_BANK0:
+        host_gpio_irq();
+        break;
+    case USBCTRL_IRQ:
+        host_usb_irq();
+        break;
+    case DMA_IRQ_0:
+        host_dma_irq();
+        break;
+    default:
+        for (int i = 0; i < host_irq_handler_count[irq]; i++) {
+            host_irq_handlers[irq][i]();
+        }
+        break;
+    }
+}
+
+// Atende as interrupções pendentes, se permitido, da menor para a maior numeração
+static void host_service(void) {
+    while (!host_masked && !host_in_irq && (host_irq_pending & host_irq_enabled)) {
+        uint irq = __builtin_ctz(host_irq_pending & host_irq_enabled);
+        host_irq_pending &= ~(1u << irq);
+        uint64_t latency = host_now - host_irq_pending_since[irq];
+        if (latency > host_irq_latency_max[irq]) {
+            host_irq_latency_max[irq] = latency;
+        }
+        host_in_irq = true;
+        host_dispatch(irq);
+        host_in_irq = false;
+    }
+}
+
+uint64_t host_irq_latency_max_us(uint irq) {
+    return host_irq_latency_max[irq];
+}
+
+void host_advance_to(uint64_t time_us) {
+    bool stop = host_running && time_us >= host_run_until;
+    if (stop) {
+        time_us = host_run_until;
+    }
+    host_service();
+    while (host_apply_next(time_us)) {
+        host_service();
+    }
+    if (time_us > host_now) {
+        host_now = time_us;
+    }
+    if (stop) {
+        longjmp(host_run_exit, 1);
+    }
+}
+
+void host_advance_us(uint64_t delay_us) {
+    host_advance_to(host_now + delay_us);
+}
+
+bool host_run(void (*entry)(void), uint64_t until_us) {
+    host_run_until = until_us;
+    host_running = true;
+    if (setjmp(host_run_exit)) {
+        host_running = false;
+        host_masked = false;
+        host_in_irq = false;
+        return true;
+    }
+    entry();
+    host_running = false;
+    return false;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    uint32_t status = host_masked;
+    host_masked = true;
+    return status;
+}
+
+void restore_interrupts(uint32_t status) {
+    host_masked = status;
+    host_service();
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    host_irq_handlers[num][0] = handler;
+    host_irq_handler_count[num] = 1;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    int count = host_irq_handler_count[num];
+    if (count == host_max_shared_handlers) {
+        panic("host: tratadores demais na interrupção %u", num);
+    }
+    // Maior prioridade de ordem é chamada primeiro
+    int i = count;
+    while (i > 0 && host_irq_priorities[num][i - 1] < order_priority) {
+        host_irq_handlers[num][i] = host_irq_handlers[num][i - 1];
+        host_irq_priorities[num][i] = host_irq_priorities[num][i - 1];
+        i--;
+    }
+    host_irq_handlers[num][i] = handler;
+    host_irq_priorities[num][i] = order_priority;
+    host_irq_handler_count[num] = count + 1;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (enabled) {
+        host_irq_enabled |= 1u << num;
+    } else {
+        host_irq_enabled &= ~(1u << num);
+    }
+    host_service();
+}
+
+// Laço de espera ativa: cada volta custa 1 us
+void tight_loop_contents(void) {
+    host_advance_to(host_now + 1);
+}
+
+void __wfe(void) {
+    tight_loop_contents();
+}
+
+// Dorme até alguma interrupção habilitada ficar pendente (mesmo mascarada, como no Cortex-M0+)
+void __wfi(void) {
+    while (!(host_irq_pending & host_irq_enabled)) {
+        int next = host_next_action();
+        if (next < 0) {
+            if (host_running) {
+                host_advance_to(host_run_until);
+            }
+            panic("host: __wfi sem nenhuma ação agendada (o firmware nunca acordaria)");
+        }
+        host_advance_to(host_actions[next].time_us);
+    }
+}
+
+uint64_t time_us_64(void) {
+    return host_now;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)host_now;
+}
+
+void busy_wait_us(uint64_t delay_us) {
+    host_advance_to(host_now + delay_us);
+}
+
+void busy_wait_until(absolute_time_t t) {
+    if (t > host_now) {
+        host_advance_to(t);
+    }
+}
+
+void sleep_until(absolute_time_t t) {
+    busy_wait_until(t);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Alarmes: grupo único de 16, atendidos na interrupção do temporizador. O retorno da chamada
+// segue o SDK: < 0 reagenda em relação ao instante anterior do alarme, > 0 em relação ao fim
+// da chamada, 0 encerra
+
+#define host_max_alarms 16
+
+typedef struct {
+    alarm_id_t id; // 0: livre
+    uint64_t target;
+    bool due; // Venceu e aguarda a interrupção do temporizador
+    alarm_callback_t callback;
+    void *user_data;
+} host_alarm_t;
+
+static host_alarm_t host_alarms[host_max_alarms];
+static alarm_id_t host_alarm_next_id = 1;
+
+static void host_alarm_fire(void *context) {
+    alarm_id_t id = (alarm_id_t)(intptr_t)context;
+    for (int i = 0; i < host_max_alarms; i++) {
+        if (host_alarms[i].id == id && host_alarms[i].target <= host_now) {
+            host_alarms[i].due = true;
+            host_raise(TIMER_IRQ_0);
+        }
+    }
+}
+
+// Chama o alarme e aplica o reagendamento pedido
+static void host_alarm_call(host_alarm_t *alarm) {
+    alarm_id_t id = alarm->id;
+    alarm->due = false;
+    int64_t repeat = alarm->callback(id, alarm->user_data);
+    if (alarm->id != id) {
+        return; // Cancelado durante a chamada
+    }
+    if (repeat == 0) {
+        alarm->id = 0;
+        return;
+    }
+    alarm->target = repeat < 0 ? alarm->target + (uint64_t)-repeat : host_now + (uint64_t)repeat;
+    host_at(alarm->target, host_alarm_fire, (void *)(intptr_t)id);
+}
+
+static void host_timer_irq(void) {
+    while (true) {
+        host_alarm_t *earliest = NULL;
+        for (int i = 0; i < host_max_alarms; i++) {
+            if (host_alarms[i].id && host_alarms[i].due && (!earliest || host_alarms[i].target < earliest->target)) {
+                earliest = &host_alarms[i];
+            }
+        }
+        if (!earliest) {
+            return;
+        }
+        host_alarm_call(earliest);
+    }
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    host_alarm_t *alarm = NULL;
+    for (int i = 0; i < host_max_alarms && !alarm; i++) {
+        if (!host_alarms[i].id) {
+            alarm = &host_alarms[i];
+        }
+    }
+    if (!alarm) {
+        return -1;
+    }
+    alarm_id_t id = host_alarm_next_id++;
+    *alarm = (host_alarm_t){id, time, false, callback, user_data};
+
+    if (time <= host_now) {
+        if (!fire_if_past) {
+            alarm->id = 0;
+            return 0;
+        }
+        // Como no SDK: vencido durante a chamada, o alarme é chamado aqui mesmo
+        host_alarm_call(alarm);
+        return alarm->id == id ? id : 0;
+    }
+    host_at(time, host_alarm_fire, (void *)(intptr_t)id);
+    return id;
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    for (int i = 0; i < host_max_alarms; i++) {
+        if (id > 0 && host_alarms[i].id == id) {
+            host_alarms[i].id = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int64_t host_repeating_timer_callback(alarm_id_t id, void *user_data) {
+    repeating_timer_t *rt = user_data;
+    rt->alarm_id = id;
+    if (rt->callback(rt)) {
+        return rt->delay_us;
+    }
+    rt->alarm_id = 0;
+    return 0;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data,
+                            repeating_timer_t *out) {
+    if (!delay_us) {
+        delay_us = 1;
+    }
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+    out->pool = NULL;
+    out->alarm_id = add_alarm_in_us((uint64_t)(delay_us < 0 ? -delay_us : delay_us), host_repeating_timer_callback,
+                                    out, true);
+    return out->alarm_id > 0;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    bool cancelled = timer->alarm_id && cancel_alarm(timer->alarm_id);
+    timer->alarm_id = 0;
+    return cancelled;
+}
+
+// ---------------------------------------------------------------------------------------------
+// GPIO: nível de cada pino a partir da saída, de um circuito externo ou dos pulls
+
+typedef struct {
+    enum gpio_function function;
+    bool out;
+    bool value;
+    bool pull_up;
+    bool pull_down;
+    bool driven;
+    bool drive_level;
+    bool level;
+    uint32_t irq_mask;
+    uint32_t irq_events; // Bordas acumuladas desde o último atendimento
+} host_gpio_t;
+
+static host_gpio_t host_gpios[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t host_gpio_callback = NULL;
+
+static void host_gpio_update(uint gpio) {
+    host_gpio_t *pin = &host_gpios[gpio];
+    bool level;
+    if (pin->out && pin->function == GPIO_FUNC_SIO) {
+        level = pin->value;
+    } else if (pin->driven) {
+        level = pin->drive_level;
+    } else {
+        level = pin->pull_up;
+    }
+    if (level == pin->level) {
+        return;
+    }
+    pin->level = level;
+    uint32_t edge = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (pin->irq_mask & edge) {
+        pin->irq_events |= edge;
+        host_raise(IO_IRQ_BANK0);
+    }
+}
+
+static void host_gpio_irq(void) {
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        uint32_t events = host_gpios[gpio].irq_events;
+        if (events) {
+            host_gpios[gpio].irq_events = 0; // Reconhecida antes da chamada, como no SDK
+            if (host_gpio_callback) {
+                host_gpio_callback(gpio, events);
+            }
+        }
+    }
+}
+
+void gpio_init(uint gpio) {
+    host_gpios[gpio].function = GPIO_FUNC_SIO;
+    host_gpios[gpio].out = false;
+    host_gpios[gpio].value = false;
+    host_gpio_update(gpio);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    host_gpios[gpio].function = fn;
+    host_gpio_update(gpio);
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    host_gpios[gpio].out = out;
+    host_gpio_update(gpio);
+}
+
+void gpio_put(uint gpio, bool value) {
+    host_gpios[gpio].value = value;
+    host_gpio_update(gpio);
+}
+
+bool gpio_get(uint gpio) {
+    return host_gpios[gpio].level;
+}
+
+void gpio_set_pulls(uint gpio, bool up, bool down) {
+    host_gpios[gpio].pull_up = up;
+    host_gpios[gpio].pull_down = down;
+    host_gpio_update(gpio);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (enabled) {
+        host_gpios[gpio].irq_mask |= event_mask;
+    } else {
+        host_gpios[gpio].irq_mask &= ~event_mask;
+    }
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    host_gpio_callback = callback;
+}
+
+void host_gpio_drive(uint gpio, bool level) {
+    host_gpios[gpio].driven = true;
+    host_gpios[gpio].drive_level = level;
+    host_gpio_update(gpio);
+}
+
+void host_gpio_float(uint gpio) {
+    host_gpios[gpio].driven = false;
+    host_gpio_update(gpio);
+}
+
+static void host_gpio_drive_action(void *context) {
+    uintptr_t packed = (uintptr_t)context;
+    host_gpio_drive(packed >> 1, packed & 1);
+}
+
+void host_gpio_drive_at(uint64_t time_us, uint gpio, bool level) {
+    host_at(time_us, host_gpio_drive_action, (void *)(((uintptr_t)gpio << 1) | level));
+}
+
+// ---------------------------------------------------------------------------------------------
+// I2C: transações com a duração do barramento (9 bits por byte, mais START/STOP), dispositivos
+// escravos emulados e falhas injetadas
+
+#define host_i2c_fifo_depth 16
+
+typedef struct {
+    i2c_hw_t hw;
+    uint baudrate;
+    host_i2c_device_t *devices;
+    uint fail_count;
+    int fail_error;
+    bool stuck;          // SDA preso em nível baixo: nada termina até i2c_deinit
+    uint32_t generation; // Muda a cada i2c_deinit, descartando as entregas ainda agendadas
+    uint64_t idle_at;    // Fim da atividade em curso
+} host_i2c_t;
+
+static host_i2c_t host_i2c[2];
+i2c_inst_t i2c0_inst = {&host_i2c[0].hw, false};
+i2c_inst_t i2c1_inst = {&host_i2c[1].hw, false};
+
+static host_i2c_t *host_i2c_of(i2c_inst_t *i2c) {
+    return &host_i2c[i2c_hw_index(i2c)];
+}
+
+// Duração de uma transação de length bytes de dados (mais o endereço)
+static uint64_t host_i2c_duration_us(const host_i2c_t *bus, size_t length) {
+    return ((length + 1) * 9 + 2) * 1000000ull / bus->baudrate + 1;
+}
+
+static host_i2c_device_t *host_i2c_find(host_i2c_t *bus, uint8_t address) {
+    for (host_i2c_device_t *device = bus->devices; device; device = device->next) {
+        if (device->address == address) {
+            return device->max_baudrate && bus->baudrate > device->max_baudrate ? NULL : device;
+        }
+    }
+    return NULL;
+}
+
+// Consome uma falha injetada, se houver; retorna o erro (0: transação normal)
+static int host_i2c_take_failure(host_i2c_t *bus) {
+    if (bus->stuck) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    if (bus->fail_count == 0) {
+        return 0;
+    }
+    bus->fail_count--;
+    if (bus->fail_error == PICO_ERROR_TIMEOUT) {
+        bus->stuck = true;
+    }
+    return bus->fail_error;
+}
+
+void host_i2c_attach(i2c_inst_t *i2c, host_i2c_device_t *device) {
+    host_i2c_t *bus = host_i2c_of(i2c);
+    device->next = bus->devices;
+    bus->devices = device;
+}
+
+void host_i2c_fail(i2c_inst_t *i2c, uint count, int error) {
+    host_i2c_t *bus = host_i2c_of(i2c);
+    bus->fail_count = count;
+    bus->fail_error = error;
+}
+
+// Mesmo cálculo do SDK: período inteiro de ciclos de clk_sys, velocidade efetiva retornada
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    uint32_t period = (host_clk_sys_hz + baudrate / 2) / baudrate;
+    host_i2c_of(i2c)->baudrate = host_clk_sys_hz / period;
+    return host_i2c_of(i2c)->baudrate;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    host_i2c_t *bus = host_i2c_of(i2c);
+    bus->hw.enable = 1;
+    bus->hw.status = 0;
+    bus->hw.raw_intr_stat = 0;
+    bus->hw.tar = 0x055;
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+// O reset do bloco esvazia a FIFO; com os pinos como GPIO a recuperação solta o SDA
+void i2c_deinit(i2c_inst_t *i2c) {
+    host_i2c_t *bus = host_i2c_of(i2c);
+    bus->hw.enable = 0;
+    bus->hw.status = 0;
+    bus->hw.raw_intr_stat = 0;
+    bus->stuck = false;
+    bus->generation++;
+    bus->idle_at = host_now;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us) {
+    host_i2c_t *bus = host_i2c_of(i2c);
+    uint64_t deadline = host_now + timeout_us;
+
+    // Bytes de um envio via DMA ainda na FIFO saem antes
+    while ((bus->hw.status & I2C_IC_STATUS_ACTIVITY_BITS) && host_now < deadline) {
+        tight_loop_contents();
+    }
+    bus->hw.tar = addr;
+
+    int error = host_i2c_take_failure(bus);
+    host_i2c_device_t *device = error ? NULL : host_i2c_find(bus, addr);
+    if (error == PICO_ERROR_TIMEOUT) {
+        busy_wait_until(deadline);
+        return PICO_ERROR_TIMEOUT;
+    }
+    if (!device) {
+        busy_wait_us(host_i2c_duration_us(bus, 0));
+        return PICO_ERROR_GENERIC;
+    }
+    uint64_t duration = host_i2c_duration_us(bus, len);
+    if (host_now + duration > deadline) {
+        busy_wait_until(deadline);
+        return PICO_ERROR_TIMEOUT;
+    }
+    busy_wait_us(duration);
+    if (!device->write(device, src, len, host_now)) {
+        return PICO_ERROR_GENERIC;
+    }
+    return (int)len;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    return i2c_write_timeout_us(i2c, addr, src, len, nostop, UINT32_MAX);
+}
+
+
+// Entrega agendada de uma transação recebida via DMA
+typedef struct {
+    host_i2c_t *bus;
+    uint32_t generation;
+    uint8_t address;
+    bool nak;  // Endereço sem resposta: o envio é abortado nesse instante
+    bool last; // Última transação do envio: o controlador fica ocioso
+    size_t length;
+    uint8_t data[];
+} host_i2c_delivery_t;
+
+static void host_i2c_deliver(void *context) {
+    host_i2c_delivery_t *delivery = context;
+    host_i2c_t *bus = delivery->bus;
+    if (delivery->generation == bus->generation) {
+        if (delivery->nak) {
+            bus->hw.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+        } else {
+            host_i2c_device_t *device = host_i2c_find(bus, delivery->address);
+            if (!device || !device->write(device, delivery->data, delivery->length, host_now)) {
+                bus->hw.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+            }
+        }
+        if (delivery->last) {
+            bus->hw.status &= ~I2C_IC_STATUS_ACTIVITY_BITS;
+        }
+    }
+    free(delivery);
+}
+
+static void host_i2c_schedule(host_i2c_t *bus, uint64_t time_us, const uint8_t *data, size_t length, bool nak,
+                              bool last) {
+    host_i2c_delivery_t *delivery = malloc(sizeof(host_i2c_delivery_t) + length);
+    delivery->bus = bus;
+    delivery->generation = bus->generation;
+    delivery->address = bus->hw.tar & I2C_IC_TAR_IC_TAR_BITS;
+    delivery->nak = nak;
+    delivery->last = last;
+    delivery->length = length;
+    memcpy(delivery->data, data, length);
+    host_at(time_us, host_i2c_deliver, delivery);
+}
+
+// Palavras de IC_DATA_CMD escritas pelo DMA: cada STOP fecha uma transação. Retorna o instante em
+// que a última palavra entra na FIFO (fim do DMA), ou 0 se o barramento travou e o DMA não termina
+static uint64_t host_i2c_dma(host_i2c_t *bus, const uint16_t *words, uint32_t count) {
+    // Um aborto anterior já foi lido pelo firmware (IC_CLR_TX_ABRT) antes de um novo envio
+    bus->hw.raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+    bus->hw.status |= I2C_IC_STATUS_ACTIVITY_BITS;
+
+    uint64_t time = host_now > bus->idle_at ? host_now : bus->idle_at;
+    uint8_t data[count];
+    size_t length = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        data[length++] = (uint8_t)words[i];
+        if (!(words[i] & I2C_IC_DATA_CMD_STOP_BITS) && i + 1 < count) {
+            continue;
+        }
+        int error = host_i2c_take_failure(bus);
+        if (error == PICO_ERROR_TIMEOUT) {
+            return 0; // A FIFO enche e nunca esvazia
+        }
+        if (error || !host_i2c_find(bus, bus->hw.tar & I2C_IC_TAR_IC_TAR_BITS)) {
+            // NAK do endereço: a FIFO descarta o resto do envio até a leitura de IC_CLR_TX_ABRT
+            time += host_i2c_duration_us(bus, 0);
+            host_i2c_schedule(bus, time, NULL, 0, true, true);
+            bus->idle_at = time;
+            return time;
+        }
+        time += host_i2c_duration_us(bus, length);
+        host_i2c_schedule(bus, time, data, length, false, i + 1 == count);
+        length = 0;
+    }
+    bus->idle_at = time;
+
+    // O DMA termina quando a última palavra entra na FIFO, antes do fim da transmissão
+    uint64_t fifo_us = (count < host_i2c_fifo_depth ? count : host_i2c_fifo_depth) * 9 * 1000000ull / bus->baudrate;
+    return time > host_now + fifo_us ? time - fifo_us : host_now;
+}
+
+// ---------------------------------------------------------------------------------------------
+// PIO: só o ritmo de consumo da FIFO de transmissão e a captura das palavras enviadas
+
+#define host_pio_fifo_depth 8 // FIFO de transmissão com as duas unidas
+
+typedef struct {
+    const pio_program_t *programs[PIO_INSTRUCTION_COUNT]; // Programa carregado em cada endereço
+    uint32_t used;                                        // Instruções ocupadas
+    uint8_t claimed;                                      // Máquinas de estados reservadas
+    pio_sm_config configs[NUM_PIO_STATE_MACHINES];
+    bool enabled[NUM_PIO_STATE_MACHINES];
+} host_pio_t;
+
+pio_hw_t host_pio_hw[2];
+static host_pio_t host_pio[2];
+static host_pio_listener_t host_pio_listener = NULL;
+static void *host_pio_listener_context = NULL;
+
+static int host_pio_find_offset(host_pio_t *pio, const pio_program_t *program) {
+    uint32_t mask = (1u << program->length) - 1;
+    for (int offset = PIO_INSTRUCTION_COUNT - program->length; offset >= 0; offset--) {
+        if (!(pio->used & (mask << offset))) {
+            return offset;
+        }
+    }
+    return -1;
+}
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program) {
+    return host_pio_find_offset(&host_pio[pio_get_index(pio)], program) >= 0;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    host_pio_t *state = &host_pio[pio_get_index(pio)];
+    int offset = host_pio_find_offset(state, program);
+    if (offset < 0) {
+        panic("host: sem espaço para o programa PIO");
+    }
+    state->used |= ((1u << program->length) - 1) << offset;
+    state->programs[offset] = program;
+    return (uint)offset;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    host_pio_t *state = &host_pio[pio_get_index(pio)];
+    for (int sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+        if (!(state->claimed & (1u << sm))) {
+            state->claimed |= 1u << sm;
+            return sm;
+        }
+    }
+    if (required) {
+        panic("host: nenhuma máquina de estados livre");
+    }
+    return -1;
+}
+
+void pio_gpio_init(PIO pio, uint pin) {
+    gpio_set_function(pin, pio == pio0 ? GPIO_FUNC_PIO0 : GPIO_FUNC_PIO1);
+}
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+    host_pio[pio_get_index(pio)].configs[sm] = *config;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+    host_pio[pio_get_index(pio)].enabled[sm] = enabled;
+}
+
+// Duração, em ns, do consumo de uma palavra da FIFO
+static uint64_t host_pio_word_ns(PIO pio, uint sm) {
+    host_pio_t *state = &host_pio[pio_get_index(pio)];
+    const pio_sm_config *config = &state->configs[sm];
+    const pio_program_t *program = state->programs[config->offset];
+    if (!program || !state->enabled[sm]) {
+        panic("host: máquina de estados %u sem programa em execução", sm);
+    }
+    uint bits = config->shift_threshold / program->host_out_bits;
+    return (uint64_t)(bits * program->host_cycles_per_bit * config->clkdiv * 1e9 / host_clk_sys_hz + 0.5);
+}
+
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint count;
+    uint32_t words[];
+} host_pio_capture_t;
+
+static void host_pio_deliver(void *context) {
+    host_pio_capture_t *capture = context;
+    if (host_pio_listener) {
+        host_pio_listener(capture->pio, capture->sm, capture->words, capture->count, host_now,
+                          host_pio_listener_context);
+    }
+    free(capture);
+}
+
+// Palavras enviadas à FIFO de uma máquina de estados a partir de agora. Retorna o fim do DMA
+static uint64_t host_pio_transmit(PIO pio, uint sm, const uint32_t *words, uint32_t count) {
+    uint64_t word_ns = host_pio_word_ns(pio, sm);
+    host_pio_capture_t *capture = malloc(sizeof(host_pio_capture_t) + count * sizeof(uint32_t));
+    capture->pio = pio;
+    capture->sm = sm;
+    capture->count = count;
+    memcpy(capture->words, words, count * sizeof(uint32_t));
+    uint64_t end = host_now + (count * word_ns + 999) / 1000;
+    host_at(end, host_pio_deliver, capture);
+
+    uint32_t queued = count < host_pio_fifo_depth ? count : host_pio_fifo_depth;
+    return host_now + ((count - queued) * word_ns + 999) / 1000;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+    busy_wait_until(host_pio_transmit(pio, sm, &data, 1));
+}
+
+void host_pio_set_listener(host_pio_listener_t listener, void *context) {
+    host_pio_listener = listener;
+    host_pio_listener_context = context;
+}
+
+// ---------------------------------------------------------------------------------------------
+// DMA: cada envio vai para um periférico emulado conforme o endereço de destino; o fim do envio
+// levanta DMA_IRQ_0 nos canais habilitados
+
+typedef struct {
+    bool claimed;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+    bool busy;
+    uint32_t generation; // Muda a cada envio ou aborto, descartando o fim agendado do anterior
+} host_dma_t;
+
+static host_dma_t host_dma[NUM_DMA_CHANNELS];
+static uint32_t host_dma_intr = 0;  // Fins de envio não reconhecidos
+static uint32_t host_dma_inte0 = 0; // Canais habilitados em DMA_IRQ_0
+
+static void host_dma_done(void *context) {
+    uintptr_t packed = (uintptr_t)context;
+    host_dma_t *channel = &host_dma[packed & 0xF];
+    if (channel->generation != packed >> 4) {
+        return;
+    }
+    channel->busy = false;
+    host_dma_intr |= 1u << (packed & 0xF);
+    if (host_dma_intr & host_dma_inte0) {
+        host_raise(DMA_IRQ_0);
+    }
+}
+
+// Chama os tratadores compartilhados; enquanto houver canal sinalizado, a linha segue ativa
+static void host_dma_irq(void) {
+    for (int i = 0; i < host_irq_handler_count[DMA_IRQ_0]; i++) {
+        host_irq_handlers[DMA_IRQ_0][i]();
+    }
+    if (host_dma_intr & host_dma_inte0) {
+        host_raise(DMA_IRQ_0);
+    }
+}
+
+static void host_dma_start(uint ch) {
+    host_dma_t *channel = &host_dma[ch];
+    channel->busy = true;
+    channel->generation++;
+
+    uint64_t done = 0;
+    bool found = false;
+    for (int i = 0; i < 2 && !found; i++) {
+        if (channel->write_addr == &host_i2c[i].hw.data_cmd) {
+            done = host_i2c_dma(&host_i2c[i], (const uint16_t *)channel->read_addr, channel->count);
+            found = true;
+        }
+        for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES && !found; sm++) {
+            if (channel->write_addr == &host_pio_hw[i].txf[sm]) {
+                done = host_pio_transmit(&host_pio_hw[i], sm, (const uint32_t *)channel->read_addr, channel->count);
+                found = true;
+            }
+        }
+    }
+    if (!found) {
+        panic("host: destino de DMA não emulado (canal %u)", ch);
+    }
+    if (done) {
+        host_at(done, host_dma_done, (void *)(uintptr_t)((channel->generation << 4) | ch));
+    }
+}
+
+int dma_claim_unused_channel(bool required) {
+    for (int ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (!host_dma[ch].claimed) {
+            host_dma[ch].claimed = true;
+            return ch;
+        }
+    }
+    if (required) {
+        panic("host: nenhum canal de DMA livre");
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    host_dma[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {0};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, 0x3f);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    return c;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    host_dma[channel].config = *config;
+    host_dma[channel].write_addr = write_addr;
+    host_dma[channel].read_addr = read_addr;
+    host_dma[channel].count = transfer_count;
+    if (trigger) {
+        host_dma_start(channel);
+    }
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {
+    host_dma[channel].read_addr = read_addr;
+    if (trigger) {
+        host_dma_start(channel);
+    }
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    host_dma[channel].count = trans_count;
+    if (trigger) {
+        host_dma_start(channel);
+    }
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    host_dma[channel].read_addr = read_addr;
+    host_dma[channel].count = transfer_count;
+    host_dma_start(channel);
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return host_dma[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    while (dma_channel_is_busy(channel)) {
+        tight_loop_contents();
+    }
+}
+
+void dma_channel_abort(uint channel) {
+    host_dma[channel].busy = false;
+    host_dma[channel].generation++;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    if (enabled) {
+        host_dma_inte0 |= 1u << channel;
+    } else {
+        host_dma_inte0 &= ~(1u << channel);
+    }
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return (host_dma_intr & host_dma_inte0) & (1u << channel);
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    host_dma_intr &= ~(1u << channel);
+}
+
+// ---------------------------------------------------------------------------------------------
+// PWM: só o estado das fatias, para observação
+
+static host_pwm_slice_t host_pwm[NUM_PWM_SLICES];
+static void (*host_pwm_listener)(uint slice, void *context) = NULL;
+static void *host_pwm_listener_context = NULL;
+
+static void host_pwm_changed(uint slice) {
+    if (host_pwm_listener) {
+        host_pwm_listener(slice, host_pwm_listener_context);
+    }
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+    host_pwm[slice_num].wrap = wrap;
+    host_pwm_changed(slice_num);
+}
+
+void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract) {
+    host_pwm[slice_num].div_int = integer;
+    host_pwm[slice_num].div_frac = fract;
+    host_pwm_changed(slice_num);
+}
+
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) {
+    host_pwm[slice_num].level[chan] = level;
+    host_pwm_changed(slice_num);
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    host_pwm[slice_num].enabled = enabled;
+    host_pwm_changed(slice_num);
+}
+
+const host_pwm_slice_t *host_pwm_slice(uint slice) {
+    return &host_pwm[slice];
+}
+
+void host_pwm_set_listener(void (*listener)(uint slice, void *context), void *context) {
+    host_pwm_listener = listener;
+    host_pwm_listener_context = context;
+}
+
+// ---------------------------------------------------------------------------------------------
+// USB CDC e stdio
+
+#define host_usb_fifo_size 256 // Tamanho das FIFOs da CDC no TinyUSB (CFG_TUD_CDC_RX/TX_BUFSIZE)
+
+static uint8_t host_usb_rx[host_usb_fifo_size];
+static uint32_t host_usb_rx_count = 0;
+static uint8_t host_usb_tx[host_usb_fifo_size];
+static uint32_t host_usb_tx_count = 0;
+static bool host_usb_connected = true;
+static void (*host_usb_output)(const uint8_t *data, size_t length, void *context) = NULL;
+static void *host_usb_output_context = NULL;
+static void (*host_stdio_chars_available)(void *) = NULL;
+static void *host_stdio_chars_available_param = NULL;
+
+static void host_usb_irq(void) {
+    if (host_stdio_chars_available && host_usb_rx_count) {
+        host_stdio_chars_available(host_stdio_chars_available_param);
+    }
+}
+
+void host_usb_receive(const uint8_t *data, size_t length) {
+    if (length > host_usb_fifo_size - host_usb_rx_count) {
+        length = host_usb_fifo_size - host_usb_rx_count; // Sem espaço o host espera; aqui, descarta
+    }
+    memcpy(host_usb_rx + host_usb_rx_count, data, length);
+    host_usb_rx_count += length;
+    host_raise(USBCTRL_IRQ);
+    host_service();
+}
+
+void host_usb_set_output(void (*output)(const uint8_t *data, size_t length, void *context), void *context) {
+    host_usb_output = output;
+    host_usb_output_context = context;
+}
+
+void host_usb_set_connected(bool connected) {
+    host_usb_connected = connected;
+}
+
+bool tud_cdc_connected(void) {
+    return host_usb_connected;
+}
+
+uint32_t tud_cdc_available(void) {
+    return host_usb_rx_count;
+}
+
+uint32_t tud_cdc_read(void *buffer, uint32_t bufsize) {
+    uint32_t count = bufsize < host_usb_rx_count ? bufsize : host_usb_rx_count;
+    memcpy(buffer, host_usb_rx, count);
+    memmove(host_usb_rx, host_usb_rx + count, host_usb_rx_count - count);
+    host_usb_rx_count -= count;
+    return count;
+}
+
+uint32_t tud_cdc_write_available(void) {
+    return host_usb_fifo_size - host_usb_tx_count;
+}
+
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize) {
+    uint32_t count = bufsize < tud_cdc_write_available() ? bufsize : tud_cdc_write_available();
+    memcpy(host_usb_tx + host_usb_tx_count, buffer, count);
+    host_usb_tx_count += count;
+    return count;
+}
+
+uint32_t tud_cdc_write_flush(void) {
+    uint32_t count = host_usb_tx_count;
+    if (host_usb_output && count) {
+        host_usb_output(host_usb_tx, count, host_usb_output_context);
+    }
+    host_usb_tx_count = 0;
+    return count;
+}
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    return PICO_ERROR_TIMEOUT;
+}
+
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param) {
+    host_stdio_chars_available = fn;
+    host_stdio_chars_available_param = param;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Flash: memória NOR na RAM (apagar leva os bits a 1, gravar só os leva a 0), com os tempos
+// típicos de um setor (45 ms) e de uma página (1 ms) passados em espera ativa
+
+#define host_flash_sector_erase_us 45000
+#define host_flash_page_program_us 1000
+
+uint8_t host_flash_memory[PICO_FLASH_SIZE_BYTES];
+
+__attribute__((constructor)) static void host_flash_init(void) {
+    memset(host_flash_memory, 0xFF, sizeof(host_flash_memory));
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        panic("host: apagamento fora de setores (0x%x, %zu)", flash_offs, count);
+    }
+    memset(host_flash_memory + flash_offs, 0xFF, count);
+    busy_wait_us(count / FLASH_SECTOR_SIZE * host_flash_sector_erase_us);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        panic("host: gravação fora de páginas (0x%x, %zu)", flash_offs, count);
+    }
+    for (size_t i = 0; i < count; i++) {
+        host_flash_memory[flash_offs + i] &= data[i];
+    }
+    busy_wait_us(count / FLASH_PAGE_SIZE * host_flash_page_program_us);
+}
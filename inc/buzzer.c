@@ -0,0 +1,93 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "buzzer.h"
+#include "perf.h"
+
+// Programa divisor e wrap do slice para a frequência da nota, com o duty pedido
+static void buzzer_set_tone(buzzer_t *buzzer, uint16_t frequency_hz, uint8_t duty_percent) {
+    if (frequency_hz == 0 || duty_percent == 0) {
+        pwm_set_gpio_level(buzzer->gpio, 0);
+        return;
+    }
+
+    // Menor divisor inteiro que mantém o wrap dentro de 16 bits, preservando a resolução
+    uint32_t sys_hz = clock_get_hz(clk_sys);
+    uint32_t divider = (sys_hz / frequency_hz + 65535) / 65536;
+    if (divider < 1) divider = 1;
+    if (divider > 255) divider = 255;
+    uint32_t wrap = sys_hz / (divider * frequency_hz) - 1;
+    if (wrap > 65535) wrap = 65535;
+
+    pwm_set_clkdiv_int_frac(buzzer->slice, divider, 0);
+    pwm_set_wrap(buzzer->slice, wrap);
+    pwm_set_gpio_level(buzzer->gpio, (wrap + 1) * duty_percent / 100);
+}
+
+// Inicia a próxima nota da fila; retorna sua duração em us, ou 0 se a fila acabou
+static int64_t buzzer_next(buzzer_t *buzzer) {
+    if (buzzer->tail == buzzer->head) {
+        pwm_set_gpio_level(buzzer->gpio, 0); // Fila vazia: silêncio
+        buzzer->playing = false;
+        return 0;
+    }
+    buzzer_note_t note = buzzer->queue[buzzer->tail];
+    buzzer->tail = (buzzer->tail + 1) & (buzzer_queue_length - 1);
+
+    buzzer_set_tone(buzzer, note.frequency_hz, note.duty_percent);
+    return (int64_t)note.duration_ms * 1000;
+}
+
+// Fim de uma nota: o valor positivo retornado reagenda o alarme relativo ao disparo anterior,
+// então a sequência não acumula atraso
+static int64_t buzzer_alarm_callback(alarm_id_t id, void *user_data) {
+    return buzzer_next((buzzer_t *)user_data);
+}
+
+// Configura o pino do buzzer como saída PWM, inicialmente em silêncio
+void buzzer_init(buzzer_t *buzzer, uint gpio) {
+    buzzer->gpio = gpio;
+    buzzer->slice = pwm_gpio_to_slice_num(gpio);
+    buzzer->head = 0;
+    buzzer->tail = 0;
+    buzzer->playing = false;
+
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    pwm_set_gpio_level(gpio, 0);
+    pwm_set_enabled(buzzer->slice, true);
+}
+
+// Coloca uma nota na fila e retorna imediatamente; false se a fila estiver cheia ou a duração for nula
+bool buzzer_play(buzzer_t *buzzer, uint16_t frequency_hz, uint8_t duty_percent, uint16_t duration_ms) {
+    if (duration_ms == 0) {
+        return false;
+    }
+    uint8_t next_head = (buzzer->head + 1) & (buzzer_queue_length - 1);
+    if (next_head == buzzer->tail) {
+        return false;
+    }
+    PERF_BEGIN(PERF_BEEP);
+    buzzer_note_t note = {frequency_hz, duty_percent, duration_ms};
+    buzzer->queue[buzzer->head] = note;
+    buzzer->head = next_head;
+
+    // Se nada estiver tocando, a primeira nota começa aqui e o alarme cuida das seguintes
+    uint32_t status = save_and_disable_interrupts();
+    if (!buzzer->playing) {
+        buzzer->playing = true;
+        int64_t duration_us = buzzer_next(buzzer);
+        if (add_alarm_in_us(duration_us, buzzer_alarm_callback, buzzer, true) <= 0) {
+            buzzer->tail = buzzer->head; // Sem alarmes livres: descarta a fila para não tocar indefinidamente
+            buzzer_next(buzzer);
+        }
+    }
+    restore_interrupts(status);
+    PERF_END(PERF_BEEP);
+    return true;
+}
+
+// Indica se o buzzer ainda tem notas tocando ou na fila
+bool buzzer_busy(const buzzer_t *buzzer) {
+    return buzzer->playing;
+}
@@ -0,0 +1,29 @@
+#include "pico/stdlib.h"
+
+#ifndef buzzer_inc_h
+#define buzzer_inc_h
+
+#define buzzer_queue_length 8 // Notas em espera por buzzer (potência de 2)
+
+// Nota a ser tocada: frequência 0 produz uma pausa (silêncio) com a duração indicada
+typedef struct {
+    uint16_t frequency_hz;
+    uint8_t duty_percent;
+    uint16_t duration_ms;
+} buzzer_note_t;
+
+// Buzzer com fila circular própria: cada um toca de forma independente dos demais
+typedef struct {
+    uint gpio;
+    uint slice;
+    buzzer_note_t queue[buzzer_queue_length];
+    volatile uint8_t head; // Escrito apenas por buzzer_play
+    volatile uint8_t tail; // Escrito apenas pelo alarme de fim de nota
+    volatile bool playing;
+} buzzer_t;
+
+extern void buzzer_init(buzzer_t *buzzer, uint gpio);
+extern bool buzzer_play(buzzer_t *buzzer, uint16_t frequency_hz, uint8_t duty_percent, uint16_t duration_ms);
+extern bool buzzer_busy(const buzzer_t *buzzer);
+
+#endif
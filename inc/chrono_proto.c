@@ -0,0 +1,187 @@
+#include <string.h>
+#include "chrono_proto.h"
+
+// Etapas da leitura de um quadro
+enum {
+    CHRONO_PROTO_SYNC,
+    CHRONO_PROTO_TYPE,
+    CHRONO_PROTO_SEQ,
+    CHRONO_PROTO_LENGTH,
+    CHRONO_PROTO_PAYLOAD,
+    CHRONO_PROTO_CRC
+};
+
+uint8_t chrono_proto_crc8(uint8_t crc, const uint8_t *data, size_t length) {
+    while (length--) {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 0x80 ? (uint8_t)(crc << 1) ^ 0x07 : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Monta um quadro em out (chrono_proto_frame_size(length) bytes); retorna o tamanho
+size_t chrono_proto_encode(uint8_t *out, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length) {
+    out[0] = chrono_proto_sync;
+    out[1] = type;
+    out[2] = seq;
+    out[3] = length;
+    if (length) {
+        memcpy(out + chrono_proto_header_size, payload, length);
+    }
+    out[chrono_proto_header_size + length] = chrono_proto_crc8(0, out + 1, chrono_proto_header_size - 1 + length);
+    return chrono_proto_frame_size(length);
+}
+
+static void chrono_proto_put32(uint8_t *out, uint32_t value) {
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+}
+
+static uint32_t chrono_proto_get32(const uint8_t *in) {
+    return in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+// Registro de estado em posições fixas, sem formatação de texto
+size_t chrono_proto_encode_state(uint8_t *out, uint8_t seq, const chrono_proto_state_t *state) {
+    uint8_t payload[chrono_proto_state_payload];
+    chrono_proto_put32(payload, state->time_us);
+    chrono_proto_put32(payload + 4, state->elapsed_ms);
+    payload[8] = state->laps;
+    payload[9] = state->laps >> 8;
+    payload[10] = state->flags;
+    payload[11] = state->cause;
+    return chrono_proto_encode(out, CHRONO_MSG_STATE, seq, payload, sizeof(payload));
+}
+
+bool chrono_proto_decode_state(const chrono_proto_frame_t *frame, chrono_proto_state_t *state) {
+    if (frame->type != CHRONO_MSG_STATE || frame->length != chrono_proto_state_payload) {
+        return false;
+    }
+    state->time_us = chrono_proto_get32(frame->payload);
+    state->elapsed_ms = chrono_proto_get32(frame->payload + 4);
+    state->laps = frame->payload[8] | frame->payload[9] << 8;
+    state->flags = frame->payload[10];
+    state->cause = frame->payload[11];
+    return true;
+}
+
+void chrono_proto_parser_init(chrono_proto_parser_t *parser) {
+    memset(parser, 0, sizeof(*parser));
+}
+
+// Comando do host com a carga do tamanho esperado; tipo desconhecido ou tamanho diferente é
+// malformado e deve ser recusado com CHRONO_MSG_NAK
+bool chrono_proto_command_valid(const chrono_proto_frame_t *frame) {
+    switch (frame->type) {
+    case CHRONO_CMD_START:
+    case CHRONO_CMD_PAUSE:
+    case CHRONO_CMD_RESET:
+    case CHRONO_CMD_LAP:
+    case CHRONO_CMD_QUERY:
+        return frame->length == 0;
+    case CHRONO_CMD_SUBSCRIBE:
+        return frame->length == 4;
+    default:
+        return false;
+    }
+}
+
+// Avança a leitura com um byte: 1 com um quadro completo e válido em parser->frame, -1 com o
+// quadro recusado (tamanho ou CRC), 0 enquanto lê
+static int chrono_proto_step(chrono_proto_parser_t *parser, uint8_t byte) {
+    chrono_proto_frame_t *frame = &parser->frame;
+    if (parser->stage == CHRONO_PROTO_SYNC) {
+        if (byte == chrono_proto_sync) {
+            parser->raw[0] = byte;
+            parser->raw_count = 1;
+            parser->stage = CHRONO_PROTO_TYPE;
+        }
+        return 0;
+    }
+    parser->raw[parser->raw_count++] = byte;
+    switch (parser->stage) {
+    case CHRONO_PROTO_TYPE:
+        frame->type = byte;
+        parser->stage = CHRONO_PROTO_SEQ;
+        return 0;
+    case CHRONO_PROTO_SEQ:
+        frame->seq = byte;
+        parser->stage = CHRONO_PROTO_LENGTH;
+        return 0;
+    case CHRONO_PROTO_LENGTH:
+        if (byte > chrono_proto_max_payload) {
+            return -1;
+        }
+        frame->length = byte;
+        parser->index = 0;
+        parser->stage = byte ? CHRONO_PROTO_PAYLOAD : CHRONO_PROTO_CRC;
+        return 0;
+    case CHRONO_PROTO_PAYLOAD:
+        frame->payload[parser->index++] = byte;
+        if (parser->index == frame->length) {
+            parser->stage = CHRONO_PROTO_CRC;
+        }
+        return 0;
+    default: {
+        uint8_t crc = chrono_proto_crc8(0, parser->raw + 1, chrono_proto_header_size - 1 + frame->length);
+        if (crc != byte) {
+            return -1;
+        }
+        parser->stage = CHRONO_PROTO_SYNC;
+        parser->raw_count = 0;
+        parser->frames++;
+        return 1;
+    }
+    }
+}
+
+// Quadro recusado: os bytes depois do seu sincronismo voltam para a busca, antes dos ainda não
+// lidos
+static void chrono_proto_reject(chrono_proto_parser_t *parser) {
+    uint8_t returned = parser->raw_count - 1;
+    uint8_t unread = parser->rescan_count - parser->rescan_index;
+    parser->bad++;
+    parser->stage = CHRONO_PROTO_SYNC;
+    parser->raw_count = 0;
+    memmove(parser->rescan + returned, parser->rescan + parser->rescan_index, unread);
+    memcpy(parser->rescan, parser->raw + 1, returned);
+    parser->rescan_index = 0;
+    parser->rescan_count = returned + unread;
+}
+
+// Continua a leitura pelos bytes ainda não lidos; retorna true com o próximo quadro completo e
+// válido em parser->frame
+bool chrono_proto_next(chrono_proto_parser_t *parser) {
+    while (parser->rescan_index < parser->rescan_count) {
+        int result = chrono_proto_step(parser, parser->rescan[parser->rescan_index++]);
+        if (result > 0) {
+            return true;
+        }
+        if (result < 0) {
+            chrono_proto_reject(parser);
+        }
+    }
+    parser->rescan_index = parser->rescan_count = 0;
+    return false;
+}
+
+// Consome um byte; retorna true quando parser->frame contém um quadro completo e válido (outros
+// podem seguir, por chrono_proto_next)
+bool chrono_proto_parse(chrono_proto_parser_t *parser, uint8_t byte) {
+    // O quadro em leitura e os bytes não lidos cabem sempre em rescan quando chrono_proto_next é
+    // chamado até o fim; se não foi, os bytes não lidos se perdem
+    uint8_t unread = parser->rescan_count - parser->rescan_index;
+    if (unread && unread + parser->raw_count >= sizeof(parser->rescan)) {
+        parser->bad++;
+        unread = 0;
+    }
+    memmove(parser->rescan, parser->rescan + parser->rescan_index, unread);
+    parser->rescan_index = 0;
+    parser->rescan[unread] = byte;
+    parser->rescan_count = unread + 1;
+    return chrono_proto_next(parser);
+}
@@ -0,0 +1,91 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef chrono_proto_inc_h
+#define chrono_proto_inc_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Protocolo binário do cronômetro na USB CDC. Sem dependências do SDK: o mesmo código monta e
+// interpreta os quadros na placa e na ferramenta do host (tools/chrono_ctl.c).
+//
+// Quadro: 0xA5, tipo, sequência, tamanho, carga (até chrono_proto_max_payload bytes), CRC-8
+// (polinômio 0x07) de tipo até o fim da carga. Campos multibyte em little-endian
+#define chrono_proto_sync 0xA5
+#define chrono_proto_header_size 4
+#define chrono_proto_max_payload 16
+#define chrono_proto_frame_size(length) (chrono_proto_header_size + (length) + 1)
+
+// Comandos do host. Cada um é respondido com um CHRONO_MSG_STATE de mesma sequência (ou um
+// CHRONO_MSG_NAK), de modo que o host mede o tempo de ida e volta por comando
+#define CHRONO_CMD_START 0x01     // Inicia ou retoma (cancela um pedido de reset)
+#define CHRONO_CMD_PAUSE 0x02
+#define CHRONO_CMD_RESET 0x03     // Zera sem confirmação
+#define CHRONO_CMD_LAP 0x04       // Marca uma volta (só contando)
+#define CHRONO_CMD_QUERY 0x05
+#define CHRONO_CMD_SUBSCRIBE 0x06 // Carga: período em us (uint32); 0 só mudanças de estado, 1..999 valem 1000 (1 kHz)
+
+// Mensagens da placa
+#define CHRONO_MSG_STATE 0x81 // Carga: chrono_proto_state_t codificado (chrono_proto_state_payload bytes)
+#define CHRONO_MSG_NAK 0x82   // Carga: tipo do comando recusado
+
+// Causa de um registro de estado: o comando (ou botão) que mudou o estado, ou periódico
+#define CHRONO_CAUSE_PERIODIC 0x00
+
+#define CHRONO_STATE_RUNNING 0x1
+#define CHRONO_STATE_RESET_PROMPT 0x2
+#define CHRONO_STATE_HIRES 0x4
+
+#define chrono_proto_state_payload 12
+#define chrono_proto_state_frame chrono_proto_frame_size(chrono_proto_state_payload)
+
+// Registro de estado com marca de tempo; tamanho fixo na linha (17 bytes com o quadro)
+typedef struct {
+    uint32_t time_us;    // time_us_32() da placa no instante do registro
+    uint32_t elapsed_ms; // Tempo decorrido do cronômetro
+    uint16_t laps;       // Voltas marcadas na sessão
+    uint8_t flags;       // CHRONO_STATE_*
+    uint8_t cause;       // CHRONO_CMD_* ou CHRONO_CAUSE_PERIODIC
+} chrono_proto_state_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t seq; // 0 nos registros espontâneos da assinatura
+    uint8_t length;
+    uint8_t payload[chrono_proto_max_payload];
+} chrono_proto_frame_t;
+
+// Leitura byte a byte: quadros com CRC inválido ou tamanho excessivo são descartados e a busca
+// recomeça no byte seguinte ao sincronismo recusado, relendo os bytes já recebidos (um 0xA5 no
+// lixo não engole o quadro verdadeiro que vem logo depois). Como esses bytes podem conter mais de
+// um quadro, depois de chrono_proto_parse retornar true chame chrono_proto_next até retornar false
+typedef struct {
+    uint8_t stage;
+    uint8_t index;
+    chrono_proto_frame_t frame;
+    uint8_t raw[chrono_proto_frame_size(chrono_proto_max_payload)];    // Quadro em leitura, desde o sincronismo
+    uint8_t raw_count;
+    uint8_t rescan[chrono_proto_frame_size(chrono_proto_max_payload)]; // Bytes ainda não lidos (devolvidos por um quadro recusado)
+    uint8_t rescan_index;
+    uint8_t rescan_count;
+    uint32_t frames; // Quadros válidos
+    uint32_t bad;    // Quadros descartados
+} chrono_proto_parser_t;
+
+extern uint8_t chrono_proto_crc8(uint8_t crc, const uint8_t *data, size_t length);
+extern size_t chrono_proto_encode(uint8_t *out, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length);
+extern size_t chrono_proto_encode_state(uint8_t *out, uint8_t seq, const chrono_proto_state_t *state);
+extern bool chrono_proto_decode_state(const chrono_proto_frame_t *frame, chrono_proto_state_t *state);
+extern void chrono_proto_parser_init(chrono_proto_parser_t *parser);
+extern bool chrono_proto_parse(chrono_proto_parser_t *parser, uint8_t byte);
+extern bool chrono_proto_next(chrono_proto_parser_t *parser);
+extern bool chrono_proto_command_valid(const chrono_proto_frame_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "events.h"
+#include "perf.h"
+
+static event_handler_t events_handlers[EVENT_COUNT];
+static volatile uint32_t events_pending = 0; // Um bit por evento aguardando despacho
+
+static repeating_timer_t events_tick_timer;
+
+// Associa a função que trata um evento
+void events_set_handler(event_t event, event_handler_t handler) {
+    events_handlers[event] = handler;
+}
+
+// Marca um evento como pendente (pode ser chamada de interrupções)
+void events_post(event_t event) {
+    uint32_t status = save_and_disable_interrupts();
+    events_pending |= 1u << event;
+    restore_interrupts(status);
+}
+
+static int64_t events_alarm_callback(alarm_id_t id, void *user_data) {
+    events_post((event_t)(uintptr_t)user_data);
+    return 0; // Alarme de disparo único
+}
+
+// Agenda um evento para daqui a delay_us microssegundos; retorna o alarme (0 se já despachado)
+alarm_id_t events_post_in_us(event_t event, uint64_t delay_us) {
+    alarm_id_t id = add_alarm_in_us(delay_us, events_alarm_callback, (void *)(uintptr_t)event, true);
+    if (id <= 0) {
+        events_post(event); // Sem alarmes livres ou prazo já vencido: despacha imediatamente
+        return 0;
+    }
+    return id;
+}
+
+// Cancela um evento agendado que ainda não disparou
+void events_cancel(alarm_id_t id) {
+    if (id > 0) {
+        cancel_alarm(id);
+    }
+}
+
+static bool events_tick_callback(repeating_timer_t *timer) {
+    events_post((event_t)(uintptr_t)timer->user_data);
+    return true;
+}
+
+// Gera o evento periodicamente a partir de um alarme de hardware repetitivo
+void events_start_tick(uint32_t period_ms, event_t event) {
+    // Período negativo: intervalo medido entre inícios de chamadas, sem acumular atraso
+    add_repeating_timer_ms(-(int32_t)period_ms, events_tick_callback, (void *)(uintptr_t)event, &events_tick_timer);
+}
+
+// Laço de despacho: trata os eventos pendentes e dorme em __wfi enquanto não houver nenhum
+void events_run(void) {
+    while (true) {
+        uint32_t status = save_and_disable_interrupts();
+        uint32_t pending = events_pending;
+        events_pending = 0;
+        if (!pending) {
+            // Com as interrupções mascaradas o núcleo ainda acorda quando uma delas fica pendente,
+            // evitando perder um evento postado entre a verificação e o __wfi
+            __wfi();
+            restore_interrupts(status);
+            continue;
+        }
+        restore_interrupts(status);
+
+        PERF_LOOP();
+        PERF_BEGIN(PERF_DISPATCH);
+        for (int event = 0; event < EVENT_COUNT; event++) {
+            if ((pending & (1u << event)) && events_handlers[event]) {
+                events_handlers[event]();
+            }
+        }
+        PERF_END(PERF_DISPATCH);
+    }
+}
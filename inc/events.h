@@ -0,0 +1,27 @@
+#include "pico/stdlib.h"
+
+#ifndef events_inc_h
+#define events_inc_h
+
+// Eventos tratados pelo laço principal, em ordem de prioridade de despacho
+typedef enum {
+    EVENT_INPUT,
+    EVENT_HOST,
+    EVENT_TICK,
+    EVENT_RENDER,
+    EVENT_EFFECT,
+    EVENT_STORAGE,
+    EVENT_TELEMETRY,
+    EVENT_COUNT
+} event_t;
+
+typedef void (*event_handler_t)(void);
+
+extern void events_set_handler(event_t event, event_handler_t handler);
+extern void events_post(event_t event);
+extern alarm_id_t events_post_in_us(event_t event, uint64_t delay_us);
+extern void events_cancel(alarm_id_t id);
+extern void events_start_tick(uint32_t period_ms, event_t event);
+extern void events_run(void);
+
+#endif
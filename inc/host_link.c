@@ -0,0 +1,66 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "tusb.h"
+#include "host_link.h"
+
+// Quadros do protocolo sobre a mesma interface CDC da stdio USB. A pilha USB roda numa
+// interrupção de baixa prioridade (tud_task da stdio), por isso cada acesso às FIFOs da CDC é
+// feito com as interrupções desligadas; são cópias curtas, sem espera
+static chrono_proto_parser_t host_link_parser;
+static host_link_stats_t host_link_stats;
+static void (*host_link_notify)(void);
+
+// Chamada pela stdio USB, na interrupção, quando chegam bytes do host
+static void host_link_rx_callback(void *param) {
+    host_link_notify();
+}
+
+void host_link_init(void (*notify)(void)) {
+    chrono_proto_parser_init(&host_link_parser);
+    host_link_notify = notify;
+    stdio_set_chars_available_callback(host_link_rx_callback, NULL);
+}
+
+// Lê tudo o que chegou e entrega cada comando completo ao tratador
+void host_link_process(host_link_handler_t handler) {
+    uint8_t buffer[64];
+    while (true) {
+        uint32_t status = save_and_disable_interrupts();
+        uint32_t count = tud_cdc_available() ? tud_cdc_read(buffer, sizeof(buffer)) : 0;
+        restore_interrupts(status);
+        if (count == 0) {
+            break;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            bool found = chrono_proto_parse(&host_link_parser, buffer[i]);
+            for (; found; found = chrono_proto_next(&host_link_parser)) {
+                host_link_stats.rx_frames++;
+                handler(&host_link_parser.frame);
+            }
+        }
+    }
+    host_link_stats.rx_bad = host_link_parser.bad;
+}
+
+// Envia um quadro inteiro sem bloquear: sem espaço na FIFO (ou sem host), o quadro é descartado
+// em vez de esperar, e nunca sai pela metade
+bool host_link_send(const uint8_t *frame, size_t length) {
+    bool sent = false;
+    uint32_t status = save_and_disable_interrupts();
+    if (tud_cdc_connected() && tud_cdc_write_available() >= length) {
+        tud_cdc_write(frame, length);
+        tud_cdc_write_flush();
+        sent = true;
+    }
+    restore_interrupts(status);
+    if (sent) {
+        host_link_stats.tx_frames++;
+    } else {
+        host_link_stats.tx_dropped++;
+    }
+    return sent;
+}
+
+const host_link_stats_t *host_link_get_stats(void) {
+    return &host_link_stats;
+}
@@ -0,0 +1,21 @@
+#include "pico/stdlib.h"
+#include "chrono_proto.h"
+
+#ifndef host_link_inc_h
+#define host_link_inc_h
+
+typedef void (*host_link_handler_t)(const chrono_proto_frame_t *frame);
+
+typedef struct {
+    uint32_t rx_frames;  // Comandos válidos recebidos
+    uint32_t rx_bad;     // Quadros descartados (CRC ou tamanho)
+    uint32_t tx_frames;  // Quadros enviados
+    uint32_t tx_dropped; // Quadros descartados com a FIFO de envio da USB cheia ou sem host
+} host_link_stats_t;
+
+extern void host_link_init(void (*notify)(void));
+extern void host_link_process(host_link_handler_t handler);
+extern bool host_link_send(const uint8_t *frame, size_t length);
+extern const host_link_stats_t *host_link_get_stats(void);
+
+#endif
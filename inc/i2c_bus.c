@@ -0,0 +1,147 @@
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/gpio.h"
+#include "i2c_bus.h"
+
+// Velocidades tentadas, da mais rápida à mais lenta: Fast-mode Plus, intermediária, Fast-mode, Standard
+static const uint i2c_bus_speeds[] = {1000000, 800000, 400000, i2c_bus_min_baudrate};
+
+// Programa a velocidade de índice speed
+static void i2c_bus_set_speed(i2c_bus_t *bus, uint8_t speed) {
+    bus->speed = speed;
+    bus->baudrate = i2c_set_baudrate(bus->i2c, i2c_bus_speeds[speed]);
+    bus->failures = 0;
+}
+
+// Configura o controlador e os pinos (com pull-up) a 400 kHz, até que i2c_bus_probe escolha outra
+void i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint sda, uint scl) {
+    bus->i2c = i2c;
+    bus->sda = sda;
+    bus->scl = scl;
+    bus->probed = false;
+    bus->recovering = false;
+    bus->on_recover = NULL;
+    bus->recover_context = NULL;
+    bus->stats = (i2c_bus_stats_t){0};
+
+    bus->speed = 2;
+    bus->baudrate = i2c_init(i2c, i2c_bus_speeds[bus->speed]);
+    bus->failures = 0;
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+}
+
+// Tempo máximo de uma transação: 9 bits por byte (com o ACK) mais o endereço, com folga de 2x
+uint i2c_bus_timeout_us(uint baudrate, size_t length) {
+    return (uint)((length + 1) * 9 * 2000000ull / baudrate) + 1000;
+}
+
+// Escolhe a maior velocidade em que o dispositivo aceita todas as escritas de teste. Com vários
+// dispositivos, cada teste parte da velocidade escolhida pelos anteriores, que todos suportam.
+// Retorna a velocidade escolhida em Hz, ou 0 se o dispositivo não respondeu (fica na mais lenta)
+uint i2c_bus_probe(i2c_bus_t *bus, uint8_t address, const uint8_t *probe, size_t length) {
+    uint8_t first = bus->probed ? bus->speed : 0;
+    bus->probed = true;
+    for (uint8_t speed = first; speed < count_of(i2c_bus_speeds); speed++) {
+        i2c_bus_set_speed(bus, speed);
+        int passed = 0;
+        while (passed < i2c_bus_probe_writes &&
+               i2c_write_timeout_us(bus->i2c, address, probe, length, false,
+                                    i2c_bus_timeout_us(bus->baudrate, length)) == (int)length) {
+            passed++;
+        }
+        if (passed == i2c_bus_probe_writes) {
+            return bus->baudrate;
+        }
+        i2c_bus_recover(bus); // A falha pode ter deixado o barramento travado
+    }
+    return 0;
+}
+
+// Registra uma falha (também as detectadas fora de i2c_bus_write, como num envio via DMA).
+// Tempo esgotado indica barramento travado e dispara a recuperação; falhas seguidas reduzem a velocidade
+void i2c_bus_report_error(i2c_bus_t *bus, int error) {
+    if (error == PICO_ERROR_TIMEOUT) {
+        bus->stats.timeouts++;
+    } else {
+        bus->stats.errors++;
+    }
+
+    if (++bus->failures >= i2c_bus_fallback_failures && bus->speed + 1 < (int)count_of(i2c_bus_speeds)) {
+        i2c_bus_set_speed(bus, bus->speed + 1);
+        bus->stats.fallbacks++;
+    }
+    if (error == PICO_ERROR_TIMEOUT) {
+        i2c_bus_recover(bus);
+    }
+}
+
+// Escrita com tempo limitado e novas tentativas. Retorna o número de bytes escritos ou o erro
+// (PICO_ERROR_GENERIC ou PICO_ERROR_TIMEOUT) da última tentativa; nunca bloqueia indefinidamente.
+// Uma falha que recuperou o barramento encerra a escrita com o erro, sem nova tentativa: o retorno
+// de recuperação reconfigurou os dispositivos, e a transação (ex.: dados de uma janela de
+// endereços definida antes) precisa ser refeita desde o início por quem a chamou
+int i2c_bus_write(i2c_bus_t *bus, uint8_t address, const uint8_t *src, size_t length) {
+    int result = PICO_ERROR_GENERIC;
+    for (int attempt = 0; attempt < i2c_bus_attempts; attempt++) {
+        if (attempt > 0) {
+            bus->stats.retries++;
+        }
+        result = i2c_write_timeout_us(bus->i2c, address, src, length, false, i2c_bus_timeout_us(bus->baudrate, length));
+        if (result == (int)length) {
+            bus->stats.transactions++;
+            bus->failures = 0;
+            return result;
+        }
+        uint32_t recoveries = bus->stats.recoveries;
+        i2c_bus_report_error(bus, result);
+        if (bus->stats.recoveries != recoveries) {
+            return result;
+        }
+    }
+    return result;
+}
+
+// Recuperação padrão de barramento travado: com os pinos como GPIO em dreno aberto, alterna SCL
+// até 9 vezes até o escravo soltar SDA, gera START e STOP e reinicia o controlador. Em seguida
+// chama o retorno de recuperação, que reconfigura os dispositivos
+void i2c_bus_recover(i2c_bus_t *bus) {
+    bus->stats.recoveries++;
+    i2c_deinit(bus->i2c);
+
+    // Nível baixo: saída ligada com valor 0; nível alto: entrada, com o pull-up
+    gpio_init(bus->sda);
+    gpio_init(bus->scl);
+    gpio_pull_up(bus->sda);
+    gpio_pull_up(bus->scl);
+    busy_wait_us_32(5);
+
+    for (int i = 0; i < 9 && !gpio_get(bus->sda); i++) {
+        gpio_set_dir(bus->scl, GPIO_OUT);
+        busy_wait_us_32(5);
+        gpio_set_dir(bus->scl, GPIO_IN);
+        busy_wait_us_32(5);
+    }
+    gpio_set_dir(bus->sda, GPIO_OUT); // START (SDA desce com SCL alto)
+    busy_wait_us_32(5);
+    gpio_set_dir(bus->sda, GPIO_IN); // STOP (SDA sobe com SCL alto)
+    busy_wait_us_32(5);
+
+    bus->baudrate = i2c_init(bus->i2c, i2c_bus_speeds[bus->speed]);
+    gpio_set_function(bus->sda, GPIO_FUNC_I2C);
+    gpio_set_function(bus->scl, GPIO_FUNC_I2C);
+
+    if (bus->on_recover && !bus->recovering) {
+        bus->recovering = true;
+        bus->on_recover(bus->recover_context);
+        bus->recovering = false;
+    }
+}
+
+// Define a função chamada após cada recuperação do barramento
+void i2c_bus_set_recover_callback(i2c_bus_t *bus, void (*callback)(void *context), void *context) {
+    bus->on_recover = callback;
+    bus->recover_context = context;
+}
@@ -0,0 +1,53 @@
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+#ifndef i2c_bus_inc_h
+#define i2c_bus_inc_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define i2c_bus_attempts 3 // Tentativas por transação antes de desistir
+#define i2c_bus_fallback_failures 4 // Falhas seguidas que reduzem a velocidade do barramento
+#define i2c_bus_probe_writes 8 // Escritas de teste que precisam passar em cada velocidade
+#define i2c_bus_min_baudrate 100000
+
+// Contadores de saúde do barramento, acumulados desde o boot
+typedef struct {
+    uint32_t transactions; // Transações concluídas
+    uint32_t errors;       // Falhas por NAK ou abortadas pelo controlador
+    uint32_t timeouts;     // Falhas por tempo esgotado (barramento travado)
+    uint32_t retries;      // Novas tentativas após uma falha
+    uint32_t recoveries;   // Recuperações com SCL alternado manualmente
+    uint32_t fallbacks;    // Reduções de velocidade
+} i2c_bus_stats_t;
+
+// Barramento i2c com escrita limitada por tempo, recuperação e redução automática de velocidade
+typedef struct {
+    i2c_inst_t *i2c;
+    uint sda;
+    uint scl;
+    uint8_t speed;            // Índice da velocidade atual na tabela de velocidades
+    uint baudrate;            // Velocidade efetivamente programada (Hz)
+    uint8_t failures;         // Falhas seguidas na velocidade atual
+    bool probed;              // Já passou por i2c_bus_probe: novos testes só podem reduzir a velocidade
+    bool recovering;          // Evita recuperações aninhadas dentro da chamada de retorno
+    void (*on_recover)(void *context); // Chamada após recuperar o barramento (reconfigurar os dispositivos)
+    void *recover_context;
+    i2c_bus_stats_t stats;
+} i2c_bus_t;
+
+extern void i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint sda, uint scl);
+extern uint i2c_bus_probe(i2c_bus_t *bus, uint8_t address, const uint8_t *probe, size_t length);
+extern int i2c_bus_write(i2c_bus_t *bus, uint8_t address, const uint8_t *src, size_t length);
+extern void i2c_bus_report_error(i2c_bus_t *bus, int error);
+extern void i2c_bus_recover(i2c_bus_t *bus);
+extern void i2c_bus_set_recover_callback(i2c_bus_t *bus, void (*callback)(void *context), void *context);
+extern uint i2c_bus_timeout_us(uint baudrate, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
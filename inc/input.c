@@ -0,0 +1,228 @@
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "input.h"
+
+// Borda capturada na interrupção
+typedef struct {
+    uint64_t time_us;
+    uint8_t button;
+    bool pressed;
+} input_edge_t;
+
+// Estado do reconhecimento de cada botão (acessado apenas pelo consumidor)
+typedef struct {
+    uint gpio;
+    bool pressed;          // Estado estável após o debounce
+    bool resync;           // Houve repique na janela: confere o nível real quando ela acabar
+    bool long_sent;        // O toque longo deste pressionamento já foi emitido
+    bool double_sent;      // Este pressionamento completou um toque duplo
+    bool click_pending;    // Soltou após um toque curto: aguarda a janela de toque duplo
+    uint64_t lock_until;   // Fim da janela de debounce da última borda aceita
+    uint64_t press_at;
+    uint64_t release_at;
+    uint64_t click_at;     // Pressionamento do toque simples pendente (instante do CLICK)
+} input_button_t;
+
+static input_button_t input_buttons[input_max_buttons];
+static int input_button_count = 0;
+static int8_t input_gpio_button[32]; // Botão associado a cada pino (-1: nenhum)
+
+// Fila circular de produtor único (interrupção) e consumidor único (input_process), sem travas:
+// apenas a interrupção escreve input_head e apenas o consumidor escreve input_tail
+static input_edge_t input_queue[input_queue_length];
+static volatile uint32_t input_head = 0;
+static volatile uint32_t input_tail = 0;
+
+static input_stats_t input_stats;
+static uint64_t input_last_edge = 0; // Instante da última borda consumida (só o consumidor escreve)
+static void (*input_notify)(void) = NULL;
+
+// Interrupção de borda: registra o instante e o nível, sem nenhum processamento
+static void input_gpio_callback(uint gpio, uint32_t event_mask) {
+    int8_t button = input_gpio_button[gpio];
+    if (button < 0) {
+        return;
+    }
+    input_stats.edges++;
+
+    uint32_t head = input_head;
+    if (head - input_tail == input_queue_length) {
+        input_stats.overflows++;
+        return;
+    }
+
+    // Com as duas bordas acumuladas vale o nível atual; com pull-up, descida é pressionar
+    bool pressed;
+    if ((event_mask & GPIO_IRQ_EDGE_FALL) && (event_mask & GPIO_IRQ_EDGE_RISE)) {
+        pressed = !gpio_get(gpio);
+    } else {
+        pressed = event_mask & GPIO_IRQ_EDGE_FALL;
+    }
+
+    input_edge_t *edge = &input_queue[head & (input_queue_length - 1)];
+    edge->time_us = time_us_64();
+    edge->button = button;
+    edge->pressed = pressed;
+    __compiler_memory_barrier(); // A borda fica completa antes de ser publicada
+    input_head = head + 1;
+
+    if (input_notify) {
+        input_notify();
+    }
+}
+
+// Define a função chamada (em contexto de interrupção) quando novas bordas chegam
+void input_init(void (*notify)(void)) {
+    for (int i = 0; i < 32; i++) {
+        input_gpio_button[i] = -1;
+    }
+    input_notify = notify;
+}
+
+// Configura o pino como botão com pull-up e captura das duas bordas; retorna seu índice
+int input_add_button(uint gpio) {
+    if (input_button_count == input_max_buttons) {
+        return -1;
+    }
+    int index = input_button_count++;
+    input_button_t *b = &input_buttons[index];
+    b->gpio = gpio;
+    b->pressed = false;
+    b->resync = false;
+    b->long_sent = false;
+    b->double_sent = false;
+    b->click_pending = false;
+    b->lock_until = 0;
+
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_IN);
+    gpio_pull_up(gpio);
+    input_gpio_button[gpio] = index;
+    gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, input_gpio_callback);
+    return index;
+}
+
+static void input_emit(input_handler_t handler, int button, input_gesture_t gesture, uint64_t time_us) {
+    input_event_t event = {button, gesture, time_us};
+    handler(&event);
+}
+
+// Mudança de estado estável de um botão
+static void input_transition(input_handler_t handler, int index, bool pressed, uint64_t time_us) {
+    input_button_t *b = &input_buttons[index];
+    b->pressed = pressed;
+    b->lock_until = time_us + input_debounce_us;
+
+    if (pressed) {
+        bool double_press = b->click_pending && time_us - b->release_at <= input_double_press_us;
+        if (b->click_pending && !double_press) {
+            // Janela vencida antes do processamento: o toque anterior sai antes deste pressionamento
+            input_emit(handler, index, INPUT_CLICK, b->click_at);
+        }
+        b->click_pending = false;
+        b->press_at = time_us;
+        b->long_sent = false;
+        b->double_sent = double_press;
+        input_emit(handler, index, INPUT_PRESS, time_us);
+        if (double_press) {
+            input_emit(handler, index, INPUT_DOUBLE, time_us);
+        }
+    } else {
+        input_emit(handler, index, INPUT_RELEASE, time_us);
+        if (!b->long_sent && !b->double_sent) {
+            b->click_pending = true;
+            b->release_at = time_us;
+            b->click_at = b->press_at;
+        }
+    }
+}
+
+static uint64_t input_earliest(uint64_t deadline, uint64_t candidate) {
+    return (deadline == 0 || candidate < deadline) ? candidate : deadline;
+}
+
+// Consome as bordas pendentes e emite os gestos reconhecidos até o instante now.
+// Retorna o próximo instante em que o processamento deve ser repetido (0: nenhum)
+uint64_t input_process(uint64_t now, input_handler_t handler) {
+    while (input_tail != input_head) {
+        input_edge_t edge = input_queue[input_tail & (input_queue_length - 1)];
+        __compiler_memory_barrier();
+        input_tail = input_tail + 1;
+        input_last_edge = edge.time_us;
+
+        // Borda capturada depois de o chamador ler o relógio: now não pode ficar antes dela, ou as
+        // diferenças abaixo (latência, toque longo, janela do toque duplo) dão a volta
+        if (edge.time_us > now) {
+            now = edge.time_us;
+        }
+
+        uint32_t latency = now - edge.time_us;
+        if (latency > input_stats.max_latency_us) {
+            input_stats.max_latency_us = latency;
+        }
+
+        input_button_t *b = &input_buttons[edge.button];
+        if (edge.time_us < b->lock_until) {
+            input_stats.bounces++;
+            b->resync = true;
+            continue;
+        }
+        if (edge.pressed != b->pressed) {
+            input_transition(handler, edge.button, edge.pressed, edge.time_us);
+        }
+    }
+
+    uint64_t deadline = 0;
+    for (int i = 0; i < input_button_count; i++) {
+        input_button_t *b = &input_buttons[i];
+
+        // Repiques podem ter escondido a última borda: ao fim da janela vale o nível do pino
+        if (b->resync) {
+            if (now >= b->lock_until) {
+                b->resync = false;
+                bool pressed = !gpio_get(b->gpio);
+                if (pressed != b->pressed) {
+                    input_transition(handler, i, pressed, b->lock_until);
+                }
+            } else {
+                deadline = input_earliest(deadline, b->lock_until);
+            }
+        }
+
+        if (b->pressed && !b->long_sent && !b->double_sent) {
+            if (now - b->press_at >= input_long_press_us) {
+                b->long_sent = true;
+                b->click_pending = false;
+                input_emit(handler, i, INPUT_LONG, b->press_at + input_long_press_us);
+            } else {
+                deadline = input_earliest(deadline, b->press_at + input_long_press_us);
+            }
+        }
+
+        if (b->click_pending && !b->pressed) {
+            if (now - b->release_at > input_double_press_us) {
+                b->click_pending = false;
+                input_emit(handler, i, INPUT_CLICK, b->click_at);
+            } else {
+                deadline = input_earliest(deadline, b->release_at + input_double_press_us + 1);
+            }
+        }
+    }
+    return deadline;
+}
+
+// Há bordas capturadas que input_process ainda não consumiu
+bool input_pending(void) {
+    return input_tail != input_head;
+}
+
+// Instante da última borda consumida por input_process, repique ou não (0: nenhuma). Junto com
+// input_pending diz há quanto tempo os botões estão parados
+uint64_t input_last_edge_us(void) {
+    return input_last_edge;
+}
+
+// Contadores de diagnóstico do subsistema de entrada
+const input_stats_t *input_get_stats(void) {
+    return &input_stats;
+}
@@ -0,0 +1,47 @@
+#include "pico/stdlib.h"
+
+#ifndef input_inc_h
+#define input_inc_h
+
+#define input_max_buttons 4
+#define input_queue_length 32 // Bordas em espera entre a interrupção e o processamento (potência de 2)
+
+#define input_debounce_us 20000 // Após uma borda aceita, repiques nesta janela são ignorados
+#define input_long_press_us 800000 // Tempo pressionado para um toque longo
+#define input_double_press_us 300000 // Intervalo máximo entre soltar e pressionar de novo para um toque duplo
+
+// Gestos reconhecidos. PRESS e RELEASE saem assim que a borda é aceita; CLICK só sai depois
+// de esgotada a janela de toque duplo, para não ser confundido com o primeiro toque de um DOUBLE,
+// mas leva o instante em que o botão foi pressionado
+typedef enum {
+    INPUT_PRESS,
+    INPUT_RELEASE,
+    INPUT_CLICK,
+    INPUT_DOUBLE,
+    INPUT_LONG
+} input_gesture_t;
+
+typedef struct {
+    uint8_t button;          // Índice retornado por input_add_button
+    input_gesture_t gesture;
+    uint64_t time_us;        // Instante da borda que originou o gesto (CLICK: a de pressionar)
+} input_event_t;
+
+typedef void (*input_handler_t)(const input_event_t *event);
+
+// Contadores de diagnóstico
+typedef struct {
+    uint32_t edges;          // Bordas capturadas pela interrupção
+    uint32_t bounces;        // Bordas descartadas pela janela de debounce
+    uint32_t overflows;      // Bordas perdidas com a fila cheia
+    uint32_t max_latency_us; // Maior atraso entre a borda e seu processamento
+} input_stats_t;
+
+extern void input_init(void (*notify)(void));
+extern int input_add_button(uint gpio);
+extern uint64_t input_process(uint64_t now, input_handler_t handler);
+extern bool input_pending(void);
+extern uint64_t input_last_edge_us(void);
+extern const input_stats_t *input_get_stats(void);
+
+#endif
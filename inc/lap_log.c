@@ -0,0 +1,203 @@
+#include <string.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "lap_log.h"
+
+// CRC-32 (polinômio refletido 0xEDB88320), bit a bit: os registros são poucos e pequenos
+static uint32_t lap_log_crc(uint32_t crc, const void *data, size_t length) {
+    const uint8_t *bytes = data;
+    crc = ~crc;
+    while (length--) {
+        crc ^= *bytes++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static const lap_log_sector_t *lap_log_header(const lap_log_t *log, uint sector) {
+    return (const lap_log_sector_t *)(log->base + sector * lap_log_sector_size);
+}
+
+static const lap_log_record_t *lap_log_record(const lap_log_t *log, uint sector, uint page) {
+    return (const lap_log_record_t *)(log->base + sector * lap_log_sector_size + page * lap_log_page_size);
+}
+
+static uint32_t lap_log_header_crc(const lap_log_sector_t *header) {
+    return lap_log_crc(0, header, offsetof(lap_log_sector_t, crc));
+}
+
+static bool lap_log_header_valid(const lap_log_sector_t *header) {
+    return header->magic == lap_log_sector_magic && header->crc == lap_log_header_crc(header);
+}
+
+static uint32_t lap_log_record_crc(const lap_log_record_t *record) {
+    uint32_t crc = lap_log_crc(0, record, offsetof(lap_log_record_t, crc));
+    return lap_log_crc(crc, record->split_ms, record->count * sizeof(uint32_t));
+}
+
+static bool lap_log_record_valid(const lap_log_record_t *record) {
+    return record->magic == lap_log_record_magic && record->count <= lap_log_batch_max &&
+           record->crc == lap_log_record_crc(record);
+}
+
+// Página nunca gravada (ou cuja gravação nem começou)
+static bool lap_log_page_erased(const lap_log_t *log, uint sector, uint page) {
+    const uint32_t *words = (const uint32_t *)lap_log_record(log, sector, page);
+    for (uint i = 0; i < lap_log_page_size / sizeof(uint32_t); i++) {
+        if (words[i] != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Copia um lote para o anel, do mais recente para o mais antigo. Retorna false quando não há
+// mais o que buscar: início de sessão ou voltas antigas demais para o anel
+static bool lap_log_restore(lap_log_t *log, const lap_log_record_t *record, laps_t *laps, bool *found) {
+    if (!*found) {
+        *found = true;
+        laps->count = record->first_lap + record->count - 1;
+        laps->persisted = laps->count;
+    }
+    for (uint i = 0; i < record->count; i++) {
+        uint32_t number = record->first_lap + i;
+        if (number <= laps->count && number + laps_capacity > laps->count) {
+            lap_t *entry = &laps->entries[(number - 1) & (laps_capacity - 1)];
+            entry->number = number;
+            entry->split_ms = record->split_ms[i];
+            log->stats.recovered++;
+        }
+    }
+    return !(record->flags & lap_log_session_start) && record->first_lap + laps_capacity > laps->count + 1;
+}
+
+// Monta o log e recupera as voltas da última sessão. Só os cabeçalhos dos setores são lidos para
+// achar o mais recente; nele, a primeira página livre sai por busca binária (as gravadas formam
+// um prefixo) e os lotes são lidos de trás para frente até completar o anel
+void lap_log_mount(lap_log_t *log, const uint8_t *base, void (*erase)(uint32_t offset),
+                   void (*program)(uint32_t offset, const uint8_t *page), laps_t *laps) {
+    memset(log, 0, sizeof(*log));
+    log->base = base;
+    log->erase = erase;
+    log->program = program;
+    log->sector = -1;
+    log->erased = -1;
+    laps_init(laps);
+
+    for (uint sector = 0; sector < lap_log_sectors; sector++) {
+        const lap_log_sector_t *header = lap_log_header(log, sector);
+        if (!lap_log_header_valid(header)) {
+            continue;
+        }
+        if (header->erase_count > log->stats.max_erase_count) {
+            log->stats.max_erase_count = header->erase_count;
+        }
+        if (log->sector < 0 || (int32_t)(header->sequence - log->sequence) > 0) {
+            log->sector = sector;
+            log->sequence = header->sequence;
+        }
+    }
+    if (log->sector < 0) {
+        return; // Região vazia (ou nunca formatada)
+    }
+
+    uint low = 1, high = lap_log_pages_per_sector;
+    while (low < high) {
+        uint middle = (low + high) / 2;
+        if (lap_log_page_erased(log, log->sector, middle)) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    log->page = low;
+
+    // Lotes do setor atual e, se preciso, dos anteriores na sequência
+    bool found = false;
+    uint sector = log->sector;
+    uint32_t sequence = log->sequence;
+    uint end = log->page;
+    for (uint visited = 0; visited < lap_log_sectors; visited++) {
+        for (uint page = end; page-- > 1;) {
+            const lap_log_record_t *record = lap_log_record(log, sector, page);
+            if (!lap_log_record_valid(record)) {
+                log->stats.torn++;
+                continue;
+            }
+            if (!lap_log_restore(log, record, laps, &found)) {
+                return;
+            }
+        }
+        sector = (sector + lap_log_sectors - 1) % lap_log_sectors;
+        const lap_log_sector_t *header = lap_log_header(log, sector);
+        if (!lap_log_header_valid(header) || header->sequence != --sequence) {
+            return;
+        }
+        end = lap_log_pages_per_sector;
+    }
+}
+
+// Há voltas (ou o início de uma sessão) ainda não gravadas
+bool lap_log_dirty(const laps_t *laps) {
+    return laps->new_session || laps_pending(laps) > 0;
+}
+
+// Executa no máximo uma operação de flash (apagar um setor, gravar um cabeçalho ou um lote) para
+// levar as voltas pendentes à flash. Retorna true se ainda resta trabalho
+bool lap_log_step(lap_log_t *log, laps_t *laps) {
+    if (!lap_log_dirty(laps)) {
+        return false;
+    }
+    uint32_t page[lap_log_page_size / sizeof(uint32_t)]; // Alinhada para os registros
+    memset(page, 0xFF, sizeof(page));
+
+    if (log->sector < 0 || log->page >= lap_log_pages_per_sector) {
+        uint next = log->sector < 0 ? 0 : (log->sector + 1) % lap_log_sectors;
+        if (log->erased != (int)next) {
+            // Setor mais antigo do rodízio: preserva sua contagem de apagamentos
+            const lap_log_sector_t *old = lap_log_header(log, next);
+            log->erased_count = lap_log_header_valid(old) ? old->erase_count + 1 : 1;
+            log->erase(next * lap_log_sector_size);
+            log->erased = next;
+            log->stats.erases++;
+            if (log->erased_count > log->stats.max_erase_count) {
+                log->stats.max_erase_count = log->erased_count;
+            }
+            return true;
+        }
+        lap_log_sector_t *header = (lap_log_sector_t *)page;
+        header->magic = lap_log_sector_magic;
+        header->sequence = log->sector < 0 ? 1 : log->sequence + 1;
+        header->erase_count = log->erased_count;
+        header->crc = lap_log_header_crc(header);
+        log->program(next * lap_log_sector_size, (const uint8_t *)page);
+        log->stats.headers++;
+        log->sector = next;
+        log->sequence = header->sequence;
+        log->page = 1;
+        log->erased = -1;
+        return true;
+    }
+
+    // Lote com todas as voltas pendentes que ainda estão no anel
+    lap_log_record_t *record = (lap_log_record_t *)page;
+    uint32_t pending = laps_pending(laps);
+    record->magic = lap_log_record_magic;
+    record->first_lap = pending ? laps->count - pending + 1 : 1;
+    record->count = pending;
+    record->flags = laps->new_session ? lap_log_session_start : 0;
+    for (uint i = 0; i < pending; i++) {
+        record->split_ms[i] = laps_find(laps, record->first_lap + i)->split_ms;
+    }
+    record->crc = lap_log_record_crc(record);
+    log->program(log->sector * lap_log_sector_size + log->page * lap_log_page_size, (const uint8_t *)page);
+    log->page++;
+    log->stats.batches++;
+    log->stats.payload_bytes += pending * sizeof(uint32_t);
+
+    laps->persisted = laps->count;
+    laps->new_session = false;
+    return lap_log_dirty(laps);
+}
@@ -0,0 +1,69 @@
+#include "pico/stdlib.h"
+#include "laps.h"
+
+#ifndef lap_log_inc_h
+#define lap_log_inc_h
+
+// Região da flash reservada para as voltas: setores de 4 KB com páginas de 256 bytes. A página 0
+// de cada setor é o cabeçalho; as demais recebem um lote de voltas cada, sempre em ordem e nunca
+// regravadas. Os setores são usados em rodízio (o mais antigo é apagado e reaproveitado), o que
+// distribui o desgaste igualmente
+#define lap_log_sectors 8
+#define lap_log_sector_size 4096
+#define lap_log_page_size 256
+#define lap_log_pages_per_sector (lap_log_sector_size / lap_log_page_size)
+#define lap_log_batch_max 60 // Voltas por página
+
+#define lap_log_sector_magic 0x4C415053u // "LAPS"
+#define lap_log_record_magic 0x4C415052u // "LAPR"
+#define lap_log_session_start 0x1        // O lote abre uma sessão: voltas anteriores não valem mais
+
+// Cabeçalho de setor, no início da página 0
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;    // Ordem de uso do setor; o maior é o mais recente
+    uint32_t erase_count; // Apagamentos deste setor
+    uint32_t crc;
+} lap_log_sector_t;
+
+// Lote de voltas: uma página inteira. Uma gravação interrompida deixa o CRC inválido e o lote
+// é ignorado
+typedef struct {
+    uint32_t magic;
+    uint32_t first_lap; // Número da primeira volta do lote
+    uint16_t count;
+    uint16_t flags;     // lap_log_session_start
+    uint32_t crc;
+    uint32_t split_ms[lap_log_batch_max];
+} lap_log_record_t;
+
+typedef struct {
+    uint32_t batches;       // Páginas de voltas gravadas
+    uint32_t headers;       // Páginas de cabeçalho gravadas
+    uint32_t erases;        // Setores apagados
+    uint32_t payload_bytes; // Bytes de voltas gravados (4 por volta); (batches + headers) * 256 / payload_bytes é a amplificação de escrita
+    uint32_t recovered;     // Voltas recuperadas na montagem
+    uint32_t torn;          // Registros inválidos encontrados na montagem
+    uint32_t max_erase_count;
+} lap_log_stats_t;
+
+// A leitura é direta pela região mapeada em memória; apagar e gravar ficam com o chamador, que
+// sabe como parar o outro núcleo e as interrupções (no host, uma flash emulada em RAM)
+typedef struct {
+    const uint8_t *base;
+    void (*erase)(uint32_t offset);                        // Apaga o setor em offset (relativo à região)
+    void (*program)(uint32_t offset, const uint8_t *page); // Grava uma página em offset
+    int sector;             // Setor em uso (-1: nenhum)
+    uint page;              // Próxima página livre no setor em uso
+    uint32_t sequence;      // Sequência do setor em uso
+    int erased;             // Setor seguinte já apagado, aguardando o cabeçalho (-1: nenhum)
+    uint32_t erased_count;  // Contagem de apagamentos a registrar no seu cabeçalho
+    lap_log_stats_t stats;
+} lap_log_t;
+
+extern void lap_log_mount(lap_log_t *log, const uint8_t *base, void (*erase)(uint32_t offset),
+                          void (*program)(uint32_t offset, const uint8_t *page), laps_t *laps);
+extern bool lap_log_step(lap_log_t *log, laps_t *laps);
+extern bool lap_log_dirty(const laps_t *laps);
+
+#endif
@@ -0,0 +1,57 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "laps.h"
+
+// Anel vazio, sem sessão a registrar (estado antes de recuperar a flash)
+void laps_init(laps_t *laps) {
+    memset(laps, 0, sizeof(*laps));
+}
+
+// Inicia uma nova sessão: as voltas anteriores deixam de valer, também na flash
+void laps_reset(laps_t *laps) {
+    uint32_t dropped = laps->dropped;
+    bool had_laps = laps->count > 0 || laps->persisted > 0;
+    laps_init(laps);
+    laps->dropped = dropped;
+    laps->new_session = had_laps;
+}
+
+// Marca uma volta; retorna seu número
+uint32_t laps_record(laps_t *laps, uint32_t split_ms) {
+    uint32_t number = ++laps->count;
+    lap_t *entry = &laps->entries[(number - 1) & (laps_capacity - 1)];
+    if (entry->number && entry->number > laps->persisted) {
+        laps->dropped++; // A flash não acompanhou: a volta mais antiga ainda não gravada se perde
+    }
+    entry->number = number;
+    entry->split_ms = split_ms;
+    return number;
+}
+
+// Volta de número dado, ou NULL se já saiu do anel (ou nunca existiu)
+const lap_t *laps_find(const laps_t *laps, uint32_t number) {
+    if (number == 0) {
+        return NULL;
+    }
+    const lap_t *entry = &laps->entries[(number - 1) & (laps_capacity - 1)];
+    return entry->number == number ? entry : NULL;
+}
+
+// Duração da volta: diferença para o tempo parcial da anterior (0 se ela não está no anel)
+uint32_t laps_lap_ms(const laps_t *laps, uint32_t number) {
+    const lap_t *lap = laps_find(laps, number);
+    if (!lap) {
+        return 0;
+    }
+    if (number == 1) {
+        return lap->split_ms;
+    }
+    const lap_t *previous = laps_find(laps, number - 1);
+    return previous ? lap->split_ms - previous->split_ms : 0;
+}
+
+// Voltas marcadas que ainda não estão na flash e continuam no anel
+uint32_t laps_pending(const laps_t *laps) {
+    uint32_t pending = laps->count - laps->persisted;
+    return pending < laps_capacity ? pending : laps_capacity;
+}
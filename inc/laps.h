@@ -0,0 +1,31 @@
+#include "pico/stdlib.h"
+
+#ifndef laps_inc_h
+#define laps_inc_h
+
+#define laps_capacity 32 // Voltas mantidas em RAM (potência de 2)
+
+typedef struct {
+    uint32_t number;   // Número da volta na sessão (1 = primeira; 0 = posição vazia)
+    uint32_t split_ms; // Tempo decorrido do cronômetro na marcação
+} lap_t;
+
+// Anel de voltas da sessão atual: a volta n fica na posição (n - 1) % laps_capacity, então marcar
+// e consultar custam O(1) e as mais antigas são sobrescritas. persisted acompanha o que já está
+// na flash (inc/lap_log)
+typedef struct {
+    lap_t entries[laps_capacity];
+    uint32_t count;      // Voltas marcadas na sessão (número da última)
+    uint32_t persisted;  // Número da última volta já gravada
+    bool new_session;    // Sessão zerada que ainda não foi registrada na flash
+    uint32_t dropped;    // Voltas sobrescritas no anel antes de serem gravadas
+} laps_t;
+
+extern void laps_init(laps_t *laps);
+extern void laps_reset(laps_t *laps);
+extern uint32_t laps_record(laps_t *laps, uint32_t split_ms);
+extern const lap_t *laps_find(const laps_t *laps, uint32_t number);
+extern uint32_t laps_lap_ms(const laps_t *laps, uint32_t number);
+extern uint32_t laps_pending(const laps_t *laps);
+
+#endif
@@ -0,0 +1,209 @@
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+#include "led_comp.h"
+#include "led_tables.h"
+#include "perf.h"
+
+// Estado de um pixel, por canal na ordem G, R, B. Os valores lógicos (antes do gama) ficam em
+// ponto fixo 8.8 para que as transições avancem menos de um degrau por quadro
+typedef struct {
+    uint32_t target;     // Cor final, GRB alinhado à esquerda
+    uint16_t current[3]; // Valor lógico atual
+    int32_t step[3];     // Avanço por quadro até o alvo
+    uint8_t dither[3];   // Fração acumulada do pontilhamento temporal (sigma-delta de 1ª ordem)
+} led_comp_pixel_t;
+
+static led_comp_pixel_t led_comp_pixels[led_comp_max_pixels];
+static uint32_t led_comp_frame[led_comp_max_pixels];
+static uint led_comp_count;
+static uint led_comp_refresh_hz;
+static uint led_comp_scale = 256; // Brilho global: 0 a 256 (256 = intensidade da curva de gama)
+static led_comp_output_t led_comp_output;
+static led_comp_stats_t led_comp_stats;
+static critical_section_t led_comp_lock; // Alvos mudam no laço principal (ou no núcleo 1) e são lidos no temporizador
+
+// Sem transição em andamento e com todos os canais num degrau exato (sem fração a pontilhar), o
+// compositor entrega um último quadro e para o temporizador, até a próxima mudança de alvo ou de
+// brilho; um canal com fração segue pontilhado, e o temporizador ligado. Dois temporizadores se
+// alternam: o que parou ainda pode estar retornando da chamada quando outro núcleo religa o
+// compositor
+typedef enum {
+    LED_COMP_STOPPED,
+    LED_COMP_RUNNING,
+    LED_COMP_SETTLING // Último quadro composto; para se nada mudar até a entrega
+} led_comp_state_t;
+
+static repeating_timer_t led_comp_timers[2];
+static uint led_comp_timer_index = 0;
+static led_comp_state_t led_comp_state = LED_COMP_STOPPED;
+
+// Canal c (G, R, B) de uma cor GRB alinhada à esquerda
+static inline uint led_comp_channel(uint32_t grb, int c) {
+    return (grb >> (24 - 8 * c)) & 0xFF;
+}
+
+// Define o alvo de um pixel e o passo para alcançá-lo em fade_ms (chamada com a trava)
+static void led_comp_retarget(led_comp_pixel_t *pixel, uint32_t grb, uint32_t fade_ms) {
+    pixel->target = grb;
+    uint32_t frames = fade_ms * led_comp_refresh_hz / 1000;
+    for (int c = 0; c < 3; c++) {
+        int32_t distance = (int32_t)(led_comp_channel(grb, c) << 8) - pixel->current[c];
+        if (frames == 0 || distance == 0) {
+            pixel->current[c] = led_comp_channel(grb, c) << 8;
+            pixel->step[c] = 0;
+        } else {
+            int32_t step = distance / (int32_t)frames;
+            pixel->step[c] = step ? step : (distance > 0 ? 1 : -1);
+        }
+    }
+}
+
+// Indica se algum canal ainda está em transição (chamada com a trava)
+static bool led_comp_fading(void) {
+    for (uint i = 0; i < led_comp_count; i++) {
+        const led_comp_pixel_t *pixel = &led_comp_pixels[i];
+        if (pixel->step[0] || pixel->step[1] || pixel->step[2]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Compõe um quadro: transição, gama com interpolação da fração, brilho global e pontilhamento.
+// Retorna true se todos os canais caíram num degrau exato: o quadro se repetiria igual, sem
+// nada a pontilhar
+static bool led_comp_compose(void) {
+    bool exact = true;
+    for (uint i = 0; i < led_comp_count; i++) {
+        led_comp_pixel_t *pixel = &led_comp_pixels[i];
+        uint32_t word = 0;
+        for (int c = 0; c < 3; c++) {
+            int32_t value = pixel->current[c];
+            if (pixel->step[c]) {
+                int32_t target = led_comp_channel(pixel->target, c) << 8;
+                value += pixel->step[c];
+                if ((pixel->step[c] > 0 && value >= target) || (pixel->step[c] < 0 && value <= target)) {
+                    value = target;
+                    pixel->step[c] = 0;
+                }
+                pixel->current[c] = value;
+            }
+
+            uint index = value >> 8;
+            uint fraction = value & 0xFF;
+            uint32_t linear = led_gamma[index];
+            if (fraction && index < 255) {
+                linear += ((led_gamma[index + 1] - linear) * fraction) >> 8;
+            }
+            linear = (linear * led_comp_scale) >> 8;
+
+            // Num degrau exato a fração acumulada não altera a saída
+            uint32_t accumulated = pixel->dither[c] + linear; // No máximo 255 + 65280
+            pixel->dither[c] = accumulated & 0xFF;
+            exact &= (linear & 0xFF) == 0;
+            word |= (accumulated >> 8) << (24 - 8 * c);
+        }
+        led_comp_frame[i] = word;
+    }
+    return exact;
+}
+
+// Temporizador de atualização: a taxa alta é o que permite ao pontilhamento recuperar os
+// degraus abaixo de 1/255 sem cintilação visível, nas transições e nos níveis com fração
+static bool led_comp_refresh(repeating_timer_t *timer) {
+    PERF_BEGIN(PERF_LED_COMPOSE);
+    uint32_t start = time_us_32();
+
+    critical_section_enter_blocking(&led_comp_lock);
+    bool settled = !led_comp_fading();
+    settled &= led_comp_compose();
+    led_comp_state = settled ? LED_COMP_SETTLING : LED_COMP_RUNNING;
+    critical_section_exit(&led_comp_lock);
+
+    uint32_t elapsed = time_us_32() - start;
+    led_comp_stats.compose_total_us += elapsed;
+    if (elapsed > led_comp_stats.compose_max_us) {
+        led_comp_stats.compose_max_us = elapsed;
+    }
+    bool delivered = led_comp_output(led_comp_frame, led_comp_count);
+    if (delivered) {
+        led_comp_stats.frames++;
+    } else {
+        led_comp_stats.skipped++;
+    }
+    PERF_END(PERF_LED_COMPOSE);
+
+    // Quadro de repouso (exato) entregue e nenhuma mudança desde a composição: o temporizador para
+    bool keep = true;
+    critical_section_enter_blocking(&led_comp_lock);
+    if (delivered && led_comp_state == LED_COMP_SETTLING) {
+        led_comp_state = LED_COMP_STOPPED;
+        led_comp_stats.idle_stops++;
+        keep = false;
+    }
+    critical_section_exit(&led_comp_lock);
+    return keep;
+}
+
+// Religa a atualização após uma mudança (chamada com a trava); um compositor prestes a parar
+// apenas continua
+static void led_comp_wake(void) {
+    if (led_comp_state == LED_COMP_STOPPED) {
+        led_comp_timer_index ^= 1;
+        add_repeating_timer_us(-(int64_t)(1000000 / led_comp_refresh_hz), led_comp_refresh, NULL,
+                               &led_comp_timers[led_comp_timer_index]);
+    }
+    led_comp_state = LED_COMP_RUNNING;
+}
+
+// Inicia o compositor para count pixels (todos apagados), atualizados refresh_hz vezes por
+// segundo pela saída dada. A taxa precisa caber no tempo de um quadro da fita
+void led_comp_init(uint count, uint refresh_hz, led_comp_output_t output) {
+    led_comp_count = count < led_comp_max_pixels ? count : led_comp_max_pixels;
+    led_comp_refresh_hz = refresh_hz;
+    led_comp_output = output;
+    critical_section_init(&led_comp_lock);
+    critical_section_enter_blocking(&led_comp_lock);
+    led_comp_wake(); // Primeiro quadro: todos apagados
+    critical_section_exit(&led_comp_lock);
+}
+
+// Brilho global (0 a 255), aplicado depois do gama para não perder resolução nos tons baixos
+void led_comp_set_brightness(uint8_t brightness) {
+    critical_section_enter_blocking(&led_comp_lock);
+    uint scale = brightness + (brightness >> 7);
+    if (scale != led_comp_scale) {
+        led_comp_scale = scale;
+        led_comp_wake();
+    }
+    critical_section_exit(&led_comp_lock);
+}
+
+// Define a cor lógica (GRB alinhado à esquerda) de um pixel, com transição de fade_ms (0: imediata)
+void led_comp_set_pixel(uint index, uint32_t grb, uint32_t fade_ms) {
+    if (index >= led_comp_count) {
+        return;
+    }
+    critical_section_enter_blocking(&led_comp_lock);
+    if (led_comp_pixels[index].target != grb) {
+        led_comp_retarget(&led_comp_pixels[index], grb, fade_ms);
+        led_comp_wake();
+    }
+    critical_section_exit(&led_comp_lock);
+}
+
+// Define todos os pixels a partir de um buffer lógico; só os que mudaram iniciam uma transição
+void led_comp_submit(const uint32_t *grb, uint32_t fade_ms) {
+    critical_section_enter_blocking(&led_comp_lock);
+    for (uint i = 0; i < led_comp_count; i++) {
+        if (led_comp_pixels[i].target != grb[i]) {
+            led_comp_retarget(&led_comp_pixels[i], grb[i], fade_ms);
+            led_comp_wake();
+        }
+    }
+    critical_section_exit(&led_comp_lock);
+}
+
+const led_comp_stats_t *led_comp_get_stats(void) {
+    return &led_comp_stats;
+}
@@ -0,0 +1,27 @@
+#include "pico/stdlib.h"
+
+#ifndef led_comp_inc_h
+#define led_comp_inc_h
+
+#define led_comp_max_pixels 32
+
+// Recebe um quadro pronto (pixels GRB alinhados à esquerda, como nos WS2812) e inicia seu envio
+// sem bloquear. Chamada em contexto de interrupção; retorna false se o quadro anterior ainda
+// está em andamento
+typedef bool (*led_comp_output_t)(const uint32_t *frame, uint count);
+
+typedef struct {
+    uint32_t frames;           // Quadros compostos e entregues à saída
+    uint32_t skipped;          // Quadros descartados com a saída ocupada
+    uint32_t compose_total_us; // Tempo de CPU acumulado na composição
+    uint32_t compose_max_us;   // Maior tempo de composição de um quadro
+    uint32_t idle_stops;       // Paradas do temporizador com os LEDs em repouso
+} led_comp_stats_t;
+
+extern void led_comp_init(uint count, uint refresh_hz, led_comp_output_t output);
+extern void led_comp_set_brightness(uint8_t brightness);
+extern void led_comp_set_pixel(uint index, uint32_t grb, uint32_t fade_ms);
+extern void led_comp_submit(const uint32_t *grb, uint32_t fade_ms);
+extern const led_comp_stats_t *led_comp_get_stats(void);
+
+#endif
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "perf.h"
+#include "host_link.h"
+
+#if CHRONO_PERF
+
+perf_counters_t perf_counters;
+static const i2c_bus_t *perf_bus = NULL;
+static const laps_t *perf_laps = NULL;
+static const lap_log_t *perf_lap_log = NULL;
+
+static const char *perf_site_names[PERF_SITE_COUNT] = {
+    "render_on_display", "send_buffer", "render_async", "np_write", "beep", "dispatch", "led_compose"
+};
+
+// Inclui a saúde do barramento no relatório
+void perf_watch_bus(const i2c_bus_t *bus) {
+    perf_bus = bus;
+}
+
+// Inclui as voltas e o desgaste da flash no relatório
+void perf_watch_laps(const laps_t *laps, const lap_log_t *log) {
+    perf_laps = laps;
+    perf_lap_log = log;
+}
+
+// Registra uma iteração do laço de eventos: período desde a anterior e sua variação
+void perf_loop_iteration(void) {
+    uint32_t now = time_us_32();
+    if (perf_counters.last_loop_us) {
+        uint32_t period = now - perf_counters.last_loop_us;
+        uint32_t jitter = period > perf_counters.last_period_us ? period - perf_counters.last_period_us
+                                                                : perf_counters.last_period_us - period;
+        perf_counters.loop_period[perf_bin(period)]++;
+        perf_counters.loop_jitter[perf_bin(jitter)]++;
+        perf_counters.last_period_us = period;
+    }
+    perf_counters.last_loop_us = now;
+}
+
+// Envia um relatório CSV compacto pela stdio USB. Os contadores são acumulados desde o boot:
+//   bus,<ms>,<bytes i2c>,<transações i2c>,<palavras pio>
+//   i2c,<Hz>,<quadros oled>,<erros>,<tempos esgotados>,<novas tentativas>,<recuperações>,<reduções>
+//   hires,<quadros>,<centésimos pulados>,<quadros com oled ocupado>,<maior atraso us>
+//   laps,<voltas>,<descartadas>,<lotes>,<cabeçalhos>,<apagamentos>,<bytes de voltas>,<maior desgaste>
+//   host,<comandos>,<quadros descartados>,<quadros enviados>,<envios descartados>
+//   site,<nome>,<chamadas>,<total us>,<máximo us>
+//   period|jitter,<faixa 0>,...,<faixa 15>
+void perf_report(void) {
+    printf("bus,%lu,%lu,%lu,%lu\n", (unsigned long)(time_us_64() / 1000), (unsigned long)perf_counters.i2c_bytes,
+           (unsigned long)perf_counters.i2c_transactions, (unsigned long)perf_counters.pio_words);
+    if (perf_bus) {
+        const i2c_bus_stats_t *stats = &perf_bus->stats;
+        printf("i2c,%u,%lu,%lu,%lu,%lu,%lu,%lu\n", perf_bus->baudrate, (unsigned long)perf_counters.oled_frames,
+               (unsigned long)stats->errors, (unsigned long)stats->timeouts, (unsigned long)stats->retries,
+               (unsigned long)stats->recoveries, (unsigned long)stats->fallbacks);
+    }
+    printf("hires,%lu,%lu,%lu,%lu\n", (unsigned long)perf_counters.hires_frames, (unsigned long)perf_counters.hires_missed,
+           (unsigned long)perf_counters.hires_busy, (unsigned long)perf_counters.hires_late_max_us);
+    if (perf_laps && perf_lap_log) {
+        const lap_log_stats_t *stats = &perf_lap_log->stats;
+        printf("laps,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)perf_laps->count, (unsigned long)perf_laps->dropped,
+               (unsigned long)stats->batches, (unsigned long)stats->headers, (unsigned long)stats->erases,
+               (unsigned long)stats->payload_bytes, (unsigned long)stats->max_erase_count);
+    }
+    const host_link_stats_t *host = host_link_get_stats();
+    printf("host,%lu,%lu,%lu,%lu\n", (unsigned long)host->rx_frames, (unsigned long)host->rx_bad,
+           (unsigned long)host->tx_frames, (unsigned long)host->tx_dropped);
+    for (int i = 0; i < PERF_SITE_COUNT; i++) {
+        const perf_timer_t *timer = &perf_counters.sites[i];
+        printf("site,%s,%lu,%lu,%lu\n", perf_site_names[i], (unsigned long)timer->calls,
+               (unsigned long)timer->total_us, (unsigned long)timer->max_us);
+    }
+    printf("period");
+    for (int i = 0; i < perf_histogram_bins; i++) {
+        printf(",%lu", (unsigned long)perf_counters.loop_period[i]);
+    }
+    printf("\njitter");
+    for (int i = 0; i < perf_histogram_bins; i++) {
+        printf(",%lu", (unsigned long)perf_counters.loop_jitter[i]);
+    }
+    printf("\n");
+}
+
+#endif
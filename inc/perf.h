@@ -0,0 +1,88 @@
+#include "pico/stdlib.h"
+#include "i2c_bus.h"
+#include "laps.h"
+#include "lap_log.h"
+
+#ifndef perf_inc_h
+#define perf_inc_h
+
+// Contadores de desempenho. Com CHRONO_PERF desligado (padrão) todas as macros viram
+// expressões vazias e nada é compilado; ligado, cada registro custa poucas instruções
+#if CHRONO_PERF
+
+// Pontos instrumentados com medição de tempo
+typedef enum {
+    PERF_RENDER_ON_DISPLAY,
+    PERF_SEND_BUFFER,
+    PERF_RENDER_ASYNC,
+    PERF_NP_WRITE,
+    PERF_BEEP,
+    PERF_DISPATCH,
+    PERF_LED_COMPOSE,
+    PERF_SITE_COUNT
+} perf_site_t;
+
+#define perf_histogram_bins 16 // Faixas em potências de 2 de microssegundos (1 us a 32 ms ou mais)
+#define perf_report_period_ms 5000
+
+typedef struct {
+    uint32_t calls;
+    uint32_t total_us;
+    uint32_t max_us;
+} perf_timer_t;
+
+typedef struct {
+    perf_timer_t sites[PERF_SITE_COUNT];
+    uint32_t i2c_bytes;
+    uint32_t i2c_transactions;
+    uint32_t pio_words;
+    uint32_t oled_frames; // Quadros completos entregues ao display
+    uint32_t hires_frames;       // Quadros do modo de centésimos
+    uint32_t hires_missed;       // Centésimos pulados: o tique chegou depois da virada seguinte
+    uint32_t hires_busy;         // Quadros que encontraram o envio anterior ao OLED ainda em curso
+    uint32_t hires_late_max_us;  // Maior atraso de um tique em relação ao instante agendado
+    uint32_t loop_period[perf_histogram_bins]; // Intervalo entre iterações do laço de eventos
+    uint32_t loop_jitter[perf_histogram_bins]; // Diferença entre intervalos consecutivos
+    uint32_t last_loop_us;
+    uint32_t last_period_us;
+} perf_counters_t;
+
+extern perf_counters_t perf_counters;
+
+// Faixa do histograma: posição do bit mais significativo, limitada ao número de faixas
+static inline uint perf_bin(uint32_t us) {
+    uint bin = us ? 31 - __builtin_clz(us) : 0;
+    return bin < perf_histogram_bins ? bin : perf_histogram_bins - 1;
+}
+
+static inline void perf_record(perf_site_t site, uint32_t us) {
+    perf_timer_t *timer = &perf_counters.sites[site];
+    timer->calls++;
+    timer->total_us += us;
+    if (us > timer->max_us) {
+        timer->max_us = us;
+    }
+}
+
+extern void perf_watch_bus(const i2c_bus_t *bus);
+extern void perf_watch_laps(const laps_t *laps, const lap_log_t *log);
+extern void perf_loop_iteration(void);
+extern void perf_report(void);
+
+#define PERF_BEGIN(site) uint32_t perf_start_##site = time_us_32()
+#define PERF_END(site) perf_record(site, time_us_32() - perf_start_##site)
+#define PERF_ADD(counter, n) (perf_counters.counter += (n))
+#define PERF_MAX(counter, n) (perf_counters.counter = (n) > perf_counters.counter ? (n) : perf_counters.counter)
+#define PERF_LOOP() perf_loop_iteration()
+
+#else
+
+#define PERF_BEGIN(site) ((void)0)
+#define PERF_END(site) ((void)0)
+#define PERF_ADD(counter, n) ((void)0)
+#define PERF_MAX(counter, n) ((void)0)
+#define PERF_LOOP() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "ssd1306_i2c.h"
+
+#ifndef ssd1306_inc_hpp
+#define ssd1306_inc_hpp
+
+// Driver C++17 do SSD1306, só de cabeçalho. A geometria do painel e o barramento são parâmetros
+// de template: sequência de inicialização, janelas de envio e tamanhos de área saem prontos da
+// compilação, o framebuffer é um membro de tamanho fixo (declare o painel como variável estática
+// ou global) e nada é alocado no heap. O framebuffer segue o layout do driver C (128 colunas por
+// página, 8 páginas), então as funções de desenho em C (ssd1306_draw.h, ssd1306_glyph.h,
+// ssd1306.h) recebem panel.buffer() diretamente. O namespace não pode se chamar ssd1306, nome da
+// struct do driver C
+namespace ssd1306_cpp {
+
+// Barramento compartilhado de inc/i2c_bus: tempo limitado, novas tentativas e recuperação
+template <i2c_bus_t &Bus>
+struct shared_bus {
+    static bool write(uint8_t address, const uint8_t *data, size_t length) {
+        return i2c_bus_write(&Bus, address, data, length) == (int)length;
+    }
+};
+
+// Sequência de inicialização numa única transação de comandos (byte de controle 0x00 à frente),
+// a mesma de ssd1306_init
+template <uint8_t Height, bool ExternalVcc>
+constexpr std::array<uint8_t, 27> init_sequence() {
+    return {{
+        0x00,
+        ssd1306_set_display, ssd1306_set_memory_mode, 0x00,
+        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, Height - 1,
+        ssd1306_set_common_output_direction | 0x08, ssd1306_set_display_offset,
+        0x00, ssd1306_set_common_pin_configuration, Height == 64 ? 0x12 : 0x02,
+        ssd1306_set_display_clock_divide_ratio, 0x80, ssd1306_set_precharge,
+        ExternalVcc ? 0x22 : 0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
+        0xFF, ssd1306_set_entire_on, ssd1306_set_normal_display,
+        ssd1306_set_charge_pump, ExternalVcc ? 0x10 : 0x14, ssd1306_set_scroll | 0x00,
+        ssd1306_set_display | 0x01,
+    }};
+}
+
+// Área de renderização verificada na compilação: colunas e páginas inclusivas
+template <uint8_t StartColumn, uint8_t EndColumn, uint8_t StartPage, uint8_t EndPage>
+struct area {
+    static_assert(StartColumn <= EndColumn && EndColumn < ssd1306_width, "colunas fora do display");
+    static_assert(StartPage <= EndPage && EndPage < ssd1306_n_pages, "páginas fora do display");
+
+    static constexpr uint8_t start_column = StartColumn;
+    static constexpr uint8_t end_column = EndColumn;
+    static constexpr uint8_t start_page = StartPage;
+    static constexpr uint8_t end_page = EndPage;
+    static constexpr size_t columns = EndColumn - StartColumn + 1;
+    static constexpr size_t length = columns * (EndPage - StartPage + 1);
+    static constexpr bool full_width = columns == ssd1306_width; // Páginas contíguas no framebuffer
+
+    // Janela de endereçamento numa única transação de comandos
+    static constexpr std::array<uint8_t, 7> window = {{
+        0x00, ssd1306_set_column_address, StartColumn, EndColumn, ssd1306_set_page_address, StartPage, EndPage
+    }};
+
+    // A mesma área para as funções em C (render_on_display), sem calculate_render_area_buffer_length
+    static constexpr render_area c_area() {
+        return render_area{StartColumn, EndColumn, StartPage, EndPage, (int)length};
+    }
+};
+
+template <uint8_t Height, typename Bus, uint8_t Address = ssd1306_i2c_address, bool ExternalVcc = false>
+class panel {
+public:
+    static_assert(Height == 32 || Height == 64, "o SSD1306 tem 32 ou 64 linhas");
+
+    static constexpr uint8_t width = ssd1306_width;
+    static constexpr uint8_t height = Height;
+    static constexpr uint8_t pages = Height / ssd1306_page_height;
+    static constexpr uint8_t address = Address;
+    using full_area = area<0, width - 1, 0, pages - 1>;
+    static constexpr std::array<uint8_t, 27> init_commands = init_sequence<Height, ExternalVcc>();
+
+    bool init() const {
+        return Bus::write(Address, init_commands.data(), init_commands.size());
+    }
+
+    // Framebuffer no layout do driver C. Com 32 linhas as páginas 4 a 7 existem (as funções em C
+    // recortam em 64 linhas), mas nunca são enviadas
+    uint8_t *buffer() {
+        return frame_.data() + 1;
+    }
+
+    const uint8_t *buffer() const {
+        return frame_.data() + 1;
+    }
+
+    // Envia uma área do framebuffer, de forma bloqueante: a janela e os dados, cada um numa transação
+    template <typename Area = full_area>
+    bool flush() {
+        static_assert(Area::end_page < pages, "área abaixo da última página do painel");
+
+        if (!Bus::write(Address, Area::window.data(), Area::window.size())) {
+            return false;
+        }
+        if constexpr (Area::full_width) {
+            // Páginas inteiras são contíguas: envia direto do framebuffer, com o byte de controle
+            // escrito temporariamente sobre o byte que as antecede
+            uint8_t *start = frame_.data() + Area::start_page * width;
+            uint8_t saved = *start;
+            *start = 0x40;
+            bool written = Bus::write(Address, start, Area::length + 1);
+            *start = saved;
+            return written;
+        } else {
+            // Retângulo parcial: copia as colunas de cada página para um buffer do tamanho da área
+            static std::array<uint8_t, Area::length + 1> tx;
+            tx[0] = 0x40;
+            uint8_t *dest = tx.data() + 1;
+            for (uint8_t page = Area::start_page; page <= Area::end_page; page++) {
+                const uint8_t *row = buffer() + page * width + Area::start_column;
+                for (size_t column = 0; column < Area::columns; column++) {
+                    *dest++ = row[column];
+                }
+            }
+            return Bus::write(Address, tx.data(), tx.size());
+        }
+    }
+
+    bool command(uint8_t command) const {
+        const uint8_t data[2] = {0x80, command};
+        return Bus::write(Address, data, sizeof(data));
+    }
+
+private:
+    // frame_[0] é o espaço para o byte de controle do envio de um quadro inteiro
+    alignas(4) std::array<uint8_t, ssd1306_buffer_length + 1> frame_{};
+};
+
+} // namespace ssd1306_cpp
+
+#endif
@@ -0,0 +1,73 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "ssd1306_anim.h"
+
+// Posiciona a reprodução no primeiro quadro
+void ssd1306_anim_start(ssd1306_anim_player_t *player, const ssd1306_anim_t *anim, bool loop) {
+    player->anim = anim;
+    player->cursor = anim->data;
+    player->frame = 0;
+    player->loop = loop;
+}
+
+// Descompacta um trecho RLE diretamente no buffer; retorna o fim dos dados lidos
+static const uint8_t *ssd1306_anim_decode(const uint8_t *src, uint8_t *dest, int length) {
+    while (length > 0) {
+        uint8_t control = *src++;
+        int count = (control & 0x7F) + 1;
+        if (count > length) {
+            count = length; // Fluxo corrompido: não escreve além do trecho
+        }
+        if (control & 0x80) {
+            memset(dest, *src++, count);
+        } else {
+            memcpy(dest, src, count);
+            src += count;
+        }
+        dest += count;
+        length -= count;
+    }
+    return src;
+}
+
+// Aplica ao buffer os trechos alterados do próximo quadro, lendo direto da flash. O buffer deve
+// conter o quadro anterior (no primeiro quadro, qualquer conteúdo: ele cobre a tela inteira).
+// Retorna false quando a animação terminou (sem repetição)
+bool ssd1306_anim_step(ssd1306_anim_player_t *player, uint8_t *buffer) {
+    const ssd1306_anim_t *anim = player->anim;
+
+    if (player->frame == anim->frame_count) {
+        if (!player->loop) {
+            return false;
+        }
+        // Quadro de retorno leva ao primeiro quadro; a reprodução segue do segundo
+        player->cursor = anim->data + anim->wrap_offset;
+    }
+
+    const uint8_t *src = player->cursor;
+    while (*src != ssd1306_anim_end_of_frame) {
+        uint8_t page = *src++;
+        uint8_t column = *src++;
+        uint8_t length = *src++;
+        if (page >= ssd1306_n_pages || column + length > ssd1306_width) {
+            return false; // Fluxo corrompido: um trecho nunca passa da sua página
+        }
+        src = ssd1306_anim_decode(src, buffer + page * ssd1306_width + column, length);
+    }
+    src++;
+
+    if (player->frame == anim->frame_count) {
+        player->cursor = anim->data + anim->restart_offset;
+        player->frame = 1;
+    } else {
+        player->cursor = src;
+        player->frame++;
+    }
+    return true;
+}
+
+// Intervalo entre quadros para a taxa da animação
+uint32_t ssd1306_anim_frame_us(const ssd1306_anim_t *anim) {
+    return 1000000u / anim->fps;
+}
@@ -0,0 +1,39 @@
+#include "pico/stdlib.h"
+#include "ssd1306_i2c.h"
+
+#ifndef ssd1306_anim_inc_h
+#define ssd1306_anim_inc_h
+
+// Animação compactada gravada em flash (gerada por tools/gen_anim.py).
+//
+// Cada quadro é uma lista de trechos alterados em relação ao quadro anterior:
+//   <página> <coluna inicial> <comprimento> <dados RLE com exatamente "comprimento" bytes>
+// terminada pelo byte ssd1306_anim_end_of_frame. O primeiro quadro cobre a tela inteira.
+// Nos dados RLE, um byte de controle c com o bit 7 ligado repete o byte seguinte (c & 0x7F) + 1
+// vezes; sem o bit 7, os c + 1 bytes seguintes são copiados literalmente.
+// Após o último quadro vem o trecho de retorno (último -> primeiro), usado ao repetir a animação
+typedef struct {
+    uint16_t frame_count;
+    uint8_t fps;
+    uint32_t restart_offset; // Início do segundo quadro (continuação após o retorno)
+    uint32_t wrap_offset;    // Início do quadro de retorno
+    const uint8_t *data;
+} ssd1306_anim_t;
+
+#define ssd1306_anim_end_of_frame 0xFF
+
+// Estado de reprodução: apenas a posição no fluxo. Cada passo aplica os trechos do quadro ao
+// buffer do display (ssd1306_buffer_length bytes), que o chamador envia como qualquer outro
+// quadro, de preferência com render_on_display_async: só o que mudou vai ao barramento
+typedef struct {
+    const ssd1306_anim_t *anim;
+    const uint8_t *cursor;
+    uint16_t frame; // Próximo quadro a ser enviado
+    bool loop;
+} ssd1306_anim_player_t;
+
+extern void ssd1306_anim_start(ssd1306_anim_player_t *player, const ssd1306_anim_t *anim, bool loop);
+extern bool ssd1306_anim_step(ssd1306_anim_player_t *player, uint8_t *buffer);
+extern uint32_t ssd1306_anim_frame_us(const ssd1306_anim_t *anim);
+
+#endif
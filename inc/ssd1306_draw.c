@@ -0,0 +1,87 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ssd1306_i2c.h"
+#include "ssd1306_draw.h"
+
+// Máscaras de bits de uma página: a partir da linha n (inclusive) e até a linha n (inclusive)
+static const uint8_t ssd1306_mask_from[8] = {0xFF, 0xFE, 0xFC, 0xF8, 0xF0, 0xE0, 0xC0, 0x80};
+static const uint8_t ssd1306_mask_to[8] = {0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF};
+
+// Aplica a máscara a um trecho de colunas de uma página
+static void ssd1306_apply_mask(uint8_t *row, int columns, uint8_t mask, ssd1306_draw_mode_t mode) {
+    if (mask == 0xFF && mode != SSD1306_DRAW_XOR) {
+        memset(row, mode == SSD1306_DRAW_SET ? 0xFF : 0x00, columns);
+        return;
+    }
+    switch (mode) {
+    case SSD1306_DRAW_SET:
+        for (int i = 0; i < columns; i++) row[i] |= mask;
+        break;
+    case SSD1306_DRAW_CLEAR:
+        for (int i = 0; i < columns; i++) row[i] &= ~mask;
+        break;
+    case SSD1306_DRAW_XOR:
+        for (int i = 0; i < columns; i++) row[i] ^= mask;
+        break;
+    }
+}
+
+// Preenche um retângulo, recortado nas bordas do display. Cada página coberta é tratada
+// de uma vez com uma máscara de bits; páginas inteiras com SET/CLEAR viram memset
+void ssd1306_fill_rect(uint8_t *ssd, int x, int y, int width, int height, ssd1306_draw_mode_t mode) {
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = x + width > ssd1306_width ? ssd1306_width : x + width;     // Exclusivo
+    int y1 = y + height > ssd1306_height ? ssd1306_height : y + height; // Exclusivo
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    int columns = x1 - x0;
+    int first_page = y0 >> 3;
+    int last_page = (y1 - 1) >> 3;
+    for (int page = first_page; page <= last_page; page++) {
+        uint8_t mask = 0xFF;
+        if (page == first_page) mask &= ssd1306_mask_from[y0 & 7];
+        if (page == last_page) mask &= ssd1306_mask_to[(y1 - 1) & 7];
+        ssd1306_apply_mask(ssd + page * ssd1306_width + x0, columns, mask, mode);
+    }
+}
+
+// Contorno de um retângulo com quatro trechos
+void ssd1306_draw_rect(uint8_t *ssd, int x, int y, int width, int height, ssd1306_draw_mode_t mode) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    ssd1306_hline(ssd, x, y, width, mode);
+    if (height > 1) {
+        ssd1306_hline(ssd, x, y + height - 1, width, mode);
+    }
+    if (height > 2) {
+        // As laterais não repetem os cantos, para que o modo XOR não os apague
+        ssd1306_vline(ssd, x, y + 1, height - 2, mode);
+        if (width > 1) {
+            ssd1306_vline(ssd, x + width - 1, y + 1, height - 2, mode);
+        }
+    }
+}
+
+// Trecho horizontal: uma máscara de um bit aplicada a colunas contíguas
+void ssd1306_hline(uint8_t *ssd, int x, int y, int width, ssd1306_draw_mode_t mode) {
+    ssd1306_fill_rect(ssd, x, y, width, 1, mode);
+}
+
+// Trecho vertical: até uma escrita por página
+void ssd1306_vline(uint8_t *ssd, int x, int y, int height, ssd1306_draw_mode_t mode) {
+    ssd1306_fill_rect(ssd, x, y, 1, height, mode);
+}
+
+// Apaga apenas uma sub-região do buffer
+void ssd1306_clear_rect(uint8_t *ssd, int x, int y, int width, int height) {
+    ssd1306_fill_rect(ssd, x, y, width, height, SSD1306_DRAW_CLEAR);
+}
+
+// Inverte os pixels de uma sub-região do buffer
+void ssd1306_invert_rect(uint8_t *ssd, int x, int y, int width, int height) {
+    ssd1306_fill_rect(ssd, x, y, width, height, SSD1306_DRAW_XOR);
+}
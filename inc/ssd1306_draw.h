@@ -0,0 +1,28 @@
+#include "pico/stdlib.h"
+
+#ifndef ssd1306_draw_inc_h
+#define ssd1306_draw_inc_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Modo de escrita dos pixels cobertos
+typedef enum {
+    SSD1306_DRAW_SET,   // Acende
+    SSD1306_DRAW_CLEAR, // Apaga
+    SSD1306_DRAW_XOR    // Inverte
+} ssd1306_draw_mode_t;
+
+extern void ssd1306_fill_rect(uint8_t *ssd, int x, int y, int width, int height, ssd1306_draw_mode_t mode);
+extern void ssd1306_draw_rect(uint8_t *ssd, int x, int y, int width, int height, ssd1306_draw_mode_t mode);
+extern void ssd1306_hline(uint8_t *ssd, int x, int y, int width, ssd1306_draw_mode_t mode);
+extern void ssd1306_vline(uint8_t *ssd, int x, int y, int height, ssd1306_draw_mode_t mode);
+extern void ssd1306_clear_rect(uint8_t *ssd, int x, int y, int width, int height);
+extern void ssd1306_invert_rect(uint8_t *ssd, int x, int y, int width, int height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
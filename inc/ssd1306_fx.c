@@ -0,0 +1,156 @@
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "ssd1306_fx.h"
+
+// Associa o estado de efeitos a um display, sem efeito ativo
+void ssd1306_fx_init(ssd1306_fx_t *fx, ssd1306_t *ssd) {
+    *fx = (ssd1306_fx_t){0};
+    fx->ssd = ssd;
+}
+
+// Troca o efeito, agendando o desfazimento do anterior para o próximo passo
+static void ssd1306_fx_set(ssd1306_fx_t *fx, ssd1306_fx_kind_t kind, uint32_t period_us) {
+    if (fx->kind != SSD1306_FX_NONE) {
+        fx->undo |= 1u << fx->kind;
+    }
+    fx->kind = kind;
+    fx->period_us = period_us;
+    fx->next_us = 0;
+    fx->phase = true; // BLINK/INVERT começam na fase normal, reafirmando o estado do painel
+}
+
+// Pisca o painel: metade do período ligado, metade desligado
+void ssd1306_fx_blink(ssd1306_fx_t *fx, uint32_t period_ms) {
+    ssd1306_fx_set(fx, SSD1306_FX_BLINK, period_ms * 500);
+}
+
+// Alterna vídeo normal e inverso: metade do período em cada
+void ssd1306_fx_invert(ssd1306_fx_t *fx, uint32_t period_ms) {
+    ssd1306_fx_set(fx, SSD1306_FX_INVERT, period_ms * 500);
+}
+
+// Rampa de contraste de from até to em duration_ms; com bounce, segue em vai-e-vem
+void ssd1306_fx_fade(ssd1306_fx_t *fx, uint8_t from, uint8_t to, uint32_t duration_ms, bool bounce) {
+    int span = to > from ? to - from : from - to;
+    int steps = span < 32 ? (span ? span : 1) : 32; // Até 32 passos por rampa
+    ssd1306_fx_set(fx, SSD1306_FX_FADE, duration_ms * 1000 / steps);
+    fx->from = from;
+    fx->to = to;
+    fx->value = from;
+    fx->delta = (span + steps - 1) / steps * (to >= from ? 1 : -1);
+    fx->bounce = bounce;
+}
+
+// Desloca a linha inicial a cada passo; o conteúdo da GDDRAM circula pela tela sem ser reenviado
+void ssd1306_fx_pan(ssd1306_fx_t *fx, int rows_per_step, uint32_t period_ms) {
+    ssd1306_fx_set(fx, SSD1306_FX_PAN, period_ms * 1000);
+    fx->delta = rows_per_step;
+    fx->value = 0;
+}
+
+// Rolagem horizontal feita inteiramente pelo painel. Enquanto ativa, a escrita na GDDRAM não é
+// garantida: nenhum quadro deve ser enviado até ssd1306_fx_stop ou a troca de efeito
+void ssd1306_fx_scroll(ssd1306_fx_t *fx, bool left, uint8_t start_page, uint8_t end_page, uint8_t interval) {
+    ssd1306_fx_set(fx, SSD1306_FX_SCROLL, 0);
+    fx->left = left;
+    fx->from = start_page;
+    fx->to = end_page;
+    fx->interval = interval & 0x07;
+}
+
+// Encerra o efeito atual; o painel volta ao normal no próximo ssd1306_fx_process
+void ssd1306_fx_stop(ssd1306_fx_t *fx) {
+    ssd1306_fx_set(fx, SSD1306_FX_NONE, 0);
+}
+
+ssd1306_fx_kind_t ssd1306_fx_active(const ssd1306_fx_t *fx) {
+    return fx->kind;
+}
+
+// Desfaz no painel o estado deixado pelos efeitos anteriores
+static void ssd1306_fx_undo(ssd1306_fx_t *fx) {
+    if (fx->undo & (1u << SSD1306_FX_BLINK)) {
+        ssd1306_send_command(fx->ssd, ssd1306_set_display | 0x01);
+    }
+    if (fx->undo & (1u << SSD1306_FX_INVERT)) {
+        ssd1306_send_command(fx->ssd, ssd1306_set_normal_display);
+    }
+    if (fx->undo & (1u << SSD1306_FX_FADE)) {
+        uint8_t commands[] = {ssd1306_set_contrast, ssd1306_fx_default_contrast};
+        ssd1306_send_command_list(fx->ssd, commands, count_of(commands));
+    }
+    if (fx->undo & (1u << SSD1306_FX_PAN)) {
+        ssd1306_send_command(fx->ssd, ssd1306_set_display_start_line);
+    }
+    if (fx->undo & (1u << SSD1306_FX_SCROLL)) {
+        ssd1306_send_command(fx->ssd, ssd1306_set_scroll | 0x00);
+        ssd1306_shadow_invalidate(fx->ssd); // A rolagem alterou a GDDRAM: o próximo quadro é enviado inteiro
+    }
+    fx->undo = 0;
+}
+
+// Executa o passo do efeito atual, se vencido.
+// Retorna o instante do próximo passo em microssegundos (0: nada mais a fazer)
+uint64_t ssd1306_fx_process(ssd1306_fx_t *fx, uint64_t now) {
+    if (!fx->undo && (fx->kind == SSD1306_FX_NONE || fx->next_us == UINT64_MAX)) {
+        return 0;
+    }
+    if (ssd1306_dma_busy(fx->ssd)) {
+        return now + ssd1306_fx_retry_us;
+    }
+    ssd1306_fx_undo(fx);
+    if (now < fx->next_us) {
+        return fx->next_us;
+    }
+
+    switch (fx->kind) {
+    case SSD1306_FX_BLINK:
+        ssd1306_send_command(fx->ssd, ssd1306_set_display | (fx->phase ? 0x01 : 0x00));
+        break;
+    case SSD1306_FX_INVERT:
+        ssd1306_send_command(fx->ssd, fx->phase ? ssd1306_set_normal_display : ssd1306_set_inverse_display);
+        break;
+    case SSD1306_FX_FADE: {
+        uint8_t commands[] = {ssd1306_set_contrast, fx->value};
+        ssd1306_send_command_list(fx->ssd, commands, count_of(commands));
+        if (fx->value == fx->to) {
+            if (!fx->bounce) {
+                fx->next_us = UINT64_MAX; // Rampa concluída; o contraste final permanece até a troca de efeito
+                return 0;
+            }
+            fx->to = fx->from;
+            fx->from = fx->value;
+            fx->delta = -fx->delta;
+        }
+        int value = fx->value + fx->delta;
+        // Limita ao extremo para não ultrapassá-lo com passos arredondados
+        if ((fx->delta > 0 && value > fx->to) || (fx->delta < 0 && value < fx->to)) {
+            value = fx->to;
+        }
+        fx->value = value;
+        break;
+    }
+    case SSD1306_FX_PAN:
+        ssd1306_send_command(fx->ssd, ssd1306_set_display_start_line | fx->value);
+        fx->value = (fx->value + fx->delta) & (ssd1306_height - 1);
+        break;
+    case SSD1306_FX_SCROLL: {
+        // Configuração só é aceita com a rolagem desativada
+        uint8_t commands[] = {
+            ssd1306_set_scroll | 0x00,
+            ssd1306_set_horizontal_scroll | (fx->left ? 0x01 : 0x00), 0x00,
+            fx->from, fx->interval, fx->to, 0x00, 0xFF,
+            ssd1306_set_scroll | 0x01
+        };
+        ssd1306_send_command_list(fx->ssd, commands, count_of(commands));
+        fx->next_us = UINT64_MAX; // O painel segue sozinho
+        return 0;
+    }
+    default:
+        return 0;
+    }
+
+    fx->phase = !fx->phase;
+    fx->next_us = now + fx->period_us;
+    return fx->next_us;
+}
@@ -0,0 +1,49 @@
+#include "pico/stdlib.h"
+#include "ssd1306_i2c.h"
+
+#ifndef ssd1306_fx_inc_h
+#define ssd1306_fx_inc_h
+
+#define ssd1306_fx_default_contrast 0xFF // Contraste programado por ssd1306_init
+#define ssd1306_fx_retry_us 1000 // Nova tentativa enquanto o i2c está ocupado com um quadro
+
+// Efeitos executados pelo próprio painel: depois de enviado o conteúdo, cada passo custa
+// apenas alguns bytes de comando, sem reenviar quadros. Ao trocar de efeito ou parar, o estado
+// alterado no painel (liga/desliga, inversão, contraste, linha inicial, rolagem) volta ao normal
+typedef enum {
+    SSD1306_FX_NONE,
+    SSD1306_FX_BLINK,  // Liga/desliga o painel
+    SSD1306_FX_INVERT, // Alterna vídeo normal/inverso
+    SSD1306_FX_FADE,   // Rampa de contraste (opcionalmente em vai-e-vem)
+    SSD1306_FX_PAN,    // Rolagem vertical circular pela linha inicial
+    SSD1306_FX_SCROLL  // Rolagem horizontal contínua do painel (sem passos)
+} ssd1306_fx_kind_t;
+
+// Estado dos efeitos de um display. Os comandos só são enviados por ssd1306_fx_process, com o
+// i2c livre, para nunca intercalar com um quadro em transmissão via DMA
+typedef struct {
+    ssd1306_t *ssd;
+    ssd1306_fx_kind_t kind;
+    uint8_t undo;            // Efeitos anteriores (bit 1 << tipo) cujo estado no painel ainda precisa ser desfeito
+    uint32_t period_us;      // Intervalo entre passos
+    uint64_t next_us;        // Próximo passo (0: imediato)
+    bool phase;              // BLINK/INVERT: fase atual
+    int delta;               // FADE: passo de contraste; PAN: linhas por passo
+    uint8_t value;           // FADE: contraste atual; PAN: linha inicial atual
+    uint8_t from, to;        // FADE: extremos da rampa; SCROLL: páginas inicial e final
+    bool bounce;             // FADE: inverte a rampa nos extremos em vez de parar
+    bool left;               // SCROLL: sentido
+    uint8_t interval;        // SCROLL: intervalo entre passos, em quadros do painel (0 a 7)
+} ssd1306_fx_t;
+
+extern void ssd1306_fx_init(ssd1306_fx_t *fx, ssd1306_t *ssd);
+extern void ssd1306_fx_blink(ssd1306_fx_t *fx, uint32_t period_ms);
+extern void ssd1306_fx_invert(ssd1306_fx_t *fx, uint32_t period_ms);
+extern void ssd1306_fx_fade(ssd1306_fx_t *fx, uint8_t from, uint8_t to, uint32_t duration_ms, bool bounce);
+extern void ssd1306_fx_pan(ssd1306_fx_t *fx, int rows_per_step, uint32_t period_ms);
+extern void ssd1306_fx_scroll(ssd1306_fx_t *fx, bool left, uint8_t start_page, uint8_t end_page, uint8_t interval);
+extern void ssd1306_fx_stop(ssd1306_fx_t *fx);
+extern ssd1306_fx_kind_t ssd1306_fx_active(const ssd1306_fx_t *fx);
+extern uint64_t ssd1306_fx_process(ssd1306_fx_t *fx, uint64_t now);
+
+#endif
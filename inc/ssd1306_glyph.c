@@ -0,0 +1,69 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ssd1306_i2c.h"
+#include "ssd1306_glyph.h"
+
+// Desenha um glifo do atlas com o canto superior esquerdo em (x, y), recortando nas bordas.
+// Com y múltiplo de 8 as colunas são copiadas por memcpy; senão cada byte é deslocado e
+// mesclado nas duas páginas que cobre, preservando os pixels fora do glifo
+void ssd1306_blit_glyph(uint8_t *ssd, int x, int y, const ssd1306_font_t *font, char character) {
+    uint8_t code = (uint8_t)character;
+    int width = font->width;
+
+    // Recorte horizontal
+    int first_column = x < 0 ? -x : 0;
+    int last_column = x + width > ssd1306_width ? ssd1306_width - x : width;
+    if (first_column >= last_column) {
+        return;
+    }
+    int columns = last_column - first_column;
+
+    uint8_t *dest = ssd + x + first_column;
+    const uint8_t *glyph = NULL;
+    if (code >= font->first && code <= font->last) {
+        glyph = font->data + (code - font->first) * font->pages * width + first_column;
+    }
+
+    int shift = y & 7;
+    int top_page = y >> 3; // Deslocamento aritmético: páginas acima do display ficam negativas
+
+    for (int page = 0; page < font->pages; page++) {
+        int row = top_page + page;
+        const uint8_t *src = glyph ? glyph + page * width : NULL;
+
+        if (shift == 0) {
+            if (row < 0 || row >= ssd1306_n_pages) {
+                continue;
+            }
+            if (src) {
+                memcpy(dest + row * ssd1306_width, src, columns);
+            } else {
+                memset(dest + row * ssd1306_width, 0, columns);
+            }
+            continue;
+        }
+
+        uint8_t low_mask = (uint8_t)(0xFF << shift);    // Bits cobertos na página de cima
+        uint8_t high_mask = (uint8_t)(0xFF >> (8 - shift)); // Bits cobertos na página de baixo
+        for (int column = 0; column < columns; column++) {
+            uint8_t bits = src ? src[column] : 0;
+            if (row >= 0 && row < ssd1306_n_pages) {
+                uint8_t *d = dest + row * ssd1306_width + column;
+                *d = (*d & ~low_mask) | (uint8_t)(bits << shift);
+            }
+            if (row + 1 >= 0 && row + 1 < ssd1306_n_pages) {
+                uint8_t *d = dest + (row + 1) * ssd1306_width + column;
+                *d = (*d & ~high_mask) | (bits >> (8 - shift));
+            }
+        }
+    }
+}
+
+// Desenha uma string com o atlas indicado; retorna a coluna seguinte ao último glifo
+int ssd1306_blit_string(uint8_t *ssd, int x, int y, const ssd1306_font_t *font, const char *string) {
+    while (*string && x < ssd1306_width) {
+        ssd1306_blit_glyph(ssd, x, y, font, *string++);
+        x += font->width;
+    }
+    return x;
+}
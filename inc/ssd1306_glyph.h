@@ -0,0 +1,26 @@
+#include "pico/stdlib.h"
+
+#ifndef ssd1306_glyph_inc_h
+#define ssd1306_glyph_inc_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Atlas de glifos de largura fixa, gerado na compilação (tools/gen_glyph_atlas.py).
+// Cada glifo ocupa pages * width bytes, gravados página a página como no buffer do display
+typedef struct {
+    uint8_t width;        // Colunas por glifo, incluindo o espaçamento
+    uint8_t pages;        // Altura em páginas de 8 pixels
+    uint8_t first, last;  // Faixa ASCII contínua do atlas; fora dela o glifo é vazio
+    const uint8_t *data;
+} ssd1306_font_t;
+
+extern void ssd1306_blit_glyph(uint8_t *ssd, int x, int y, const ssd1306_font_t *font, char character);
+extern int ssd1306_blit_string(uint8_t *ssd, int x, int y, const ssd1306_font_t *font, const char *string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,89 +5,535 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "ssd1306_font.h"
-#include "ssd1306_i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_draw.h"
+#include "i2c_bus.h"
+#include "perf.h"
+
+// Displays associados: a interrupção de DMA e a recuperação de um barramento percorrem esta lista
+static ssd1306_t *ssd1306_panels[ssd1306_max_panels];
+static int ssd1306_panel_count = 0;
+static bool ssd1306_dma_irq_installed = false;
 
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area) {
     area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
 }
 
-// Processo de escrita do i2c espera um byte de controle, seguido por dados
-void ssd1306_send_command(uint8_t command) {
+// Toda escrita bloqueante passa por aqui: tempo limitado, novas tentativas e recuperação do barramento
+static int ssd1306_write(ssd1306_t *ssd, const uint8_t *src, size_t length) {
+    PERF_ADD(i2c_transactions, 1);
+    PERF_ADD(i2c_bytes, length);
+    return i2c_bus_write(ssd->bus, ssd->address, src, length);
+}
+
+// Escritas bloqueantes não podem intercalar com um quadro via DMA de nenhum display do mesmo barramento
+static void ssd1306_bus_wait(ssd1306_t *ssd) {
+    for (int i = 0; i < ssd1306_panel_count; i++) {
+        if (ssd1306_panels[i]->bus == ssd->bus) {
+            ssd1306_dma_wait(ssd1306_panels[i]);
+        }
+    }
+}
+
+// Processo de escrita do i2c espera um byte de controle, seguido por dados. Retorna false se a
+// escrita falhou (mesmo depois das novas tentativas)
+bool ssd1306_send_command(ssd1306_t *ssd, uint8_t command) {
+    ssd1306_bus_wait(ssd);
+
     uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
+    return ssd1306_write(ssd, buffer, 2) == 2;
 }
 
-// Envia uma lista de comandos ao hardware
-void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
+// Envia uma sequência de comandos em lotes, cada um numa única transação: o byte de
+// controle 0x00 (Co = 0, D/C# = 0) indica que todos os bytes seguintes são comandos. Para no
+// primeiro lote que falhar e retorna false
+bool ssd1306_send_command_list(ssd1306_t *ssd, const uint8_t *commands, int number) {
+    ssd1306_bus_wait(ssd);
+
+    uint8_t buffer[ssd1306_command_batch_max + 1];
+    buffer[0] = 0x00;
+
+    while (number > 0) {
+        int chunk = number < ssd1306_command_batch_max ? number : ssd1306_command_batch_max;
+        memcpy(buffer + 1, commands, chunk);
+        if (ssd1306_write(ssd, buffer, chunk + 1) != chunk + 1) {
+            return false;
+        }
+        commands += chunk;
+        number -= chunk;
     }
+    return true;
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
-void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
+// Copia buffer de referência no buffer de envio, que já começa com o byte de controle. Retorna
+// false se a escrita falhou
+bool ssd1306_send_buffer(ssd1306_t *ssd, const uint8_t *buffer, int buffer_length) {
+    ssd1306_bus_wait(ssd);
+    PERF_BEGIN(PERF_SEND_BUFFER);
 
-    temp_buffer[0] = 0x40;
-    memcpy(temp_buffer + 1, ssd, buffer_length);
+    memcpy(ssd->tx_buffer + 1, buffer, buffer_length);
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+    bool sent = ssd1306_write(ssd, ssd->tx_buffer, buffer_length + 1) == buffer_length + 1;
+    PERF_END(PERF_SEND_BUFFER);
+    return sent;
+}
 
-    free(temp_buffer);
+// Reenvia a tela inteira a partir da cópia sombra (o último conteúdo pedido ao display).
+// Retorna false se o envio falhou
+static bool ssd1306_restore_shadow(ssd1306_t *ssd) {
+    uint8_t commands[] = {
+        ssd1306_set_column_address, 0, ssd1306_width - 1,
+        ssd1306_set_page_address, 0, ssd->pages - 1
+    };
+    if (!ssd1306_send_command_list(ssd, commands, count_of(commands)) ||
+        !ssd1306_send_buffer(ssd, ssd->shadow, ssd->pages * ssd1306_width)) {
+        return false;
+    }
+    PERF_ADD(oled_frames, 1);
+    return true;
+}
+
+// Após a recuperação do barramento: os displays podem ter perdido a configuração, então são
+// reinicializados e recebem de volta o conteúdo que deveriam estar exibindo
+static void ssd1306_bus_recovered(void *context) {
+    for (int i = 0; i < ssd1306_panel_count; i++) {
+        ssd1306_t *ssd = ssd1306_panels[i];
+        if (ssd->bus != context) {
+            continue;
+        }
+        bool restore = ssd->shadow_valid;
+        ssd1306_init(ssd);
+        if (restore) {
+            ssd->shadow_valid = ssd1306_restore_shadow(ssd);
+        }
+    }
+}
+
+// Prepara a instância de um display de 128 x height (64 ou 32) pixels no endereço dado e escolhe a
+// maior velocidade do barramento que ele aceita (testada com o comando NOP; com vários displays
+// no mesmo barramento, a velocidade só diminui). Retorna a velocidade em Hz, ou 0 se o display
+// não respondeu. A configuração do painel é enviada depois, por ssd1306_init
+uint ssd1306_attach(ssd1306_t *ssd, i2c_bus_t *bus, uint8_t address, uint8_t height, bool external_vcc) {
+    static const uint8_t probe[] = {0x80, ssd1306_nop};
+
+    if (ssd1306_panel_count == ssd1306_max_panels) {
+        panic("ssd1306: mais de %d displays", ssd1306_max_panels);
+    }
+    ssd1306_panels[ssd1306_panel_count++] = ssd;
+
+    ssd->bus = bus;
+    ssd->address = address;
+    ssd->height = height;
+    ssd->pages = height / ssd1306_page_height;
+    ssd->external_vcc = external_vcc;
+    ssd->shadow_valid = false;
+    ssd->tx_buffer[0] = 0x40;
+    ssd->dma_channel = -1;
+    ssd->dma_active = -1;
+    ssd->dma_pending = -1;
+    ssd->dma_fault = false;
+    ssd->dma_callback = NULL;
+
+    uint baudrate = i2c_bus_probe(bus, address, probe, sizeof(probe));
+    i2c_bus_set_recover_callback(bus, ssd1306_bus_recovered, bus);
+    return baudrate;
 }
 
 // Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
-void ssd1306_init() {
+void ssd1306_init(ssd1306_t *ssd) {
     uint8_t commands[] = {
         ssd1306_set_display, ssd1306_set_memory_mode, 0x00,
-        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01, 
-        ssd1306_set_mux_ratio, ssd1306_height - 1,
+        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, ssd->height - 1,
         ssd1306_set_common_output_direction | 0x08, ssd1306_set_display_offset,
-        0x00, ssd1306_set_common_pin_configuration,
-    
-#if ((ssd1306_width == 128) && (ssd1306_height == 32))
-    0x02,
-#elif ((ssd1306_width == 128) && (ssd1306_height == 64))
-    0x12,
-#else
-    0x02,
-#endif
+        0x00, ssd1306_set_common_pin_configuration, ssd->height == 64 ? 0x12 : 0x02,
         ssd1306_set_display_clock_divide_ratio, 0x80, ssd1306_set_precharge,
-        0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
+        ssd->external_vcc ? 0x22 : 0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
         0xFF, ssd1306_set_entire_on, ssd1306_set_normal_display,
-        ssd1306_set_charge_pump, 0x14, ssd1306_set_scroll | 0x00,
+        ssd1306_set_charge_pump, ssd->external_vcc ? 0x10 : 0x14, ssd1306_set_scroll | 0x00,
         ssd1306_set_display | 0x01,
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
+
+    // Após a inicialização o conteúdo da GDDRAM é desconhecido
+    ssd->shadow_valid = false;
+}
+
+// Descarta a cópia sombra quando a GDDRAM foi alterada por fora (ex.: rolagem do painel)
+void ssd1306_shadow_invalidate(ssd1306_t *ssd) {
+    ssd->shadow_valid = false;
 }
 
 // Cria a lista de comandos para configurar o scrolling
-void ssd1306_scroll(bool set) {
+void ssd1306_scroll(ssd1306_t *ssd, bool set) {
     uint8_t commands[] = {
-        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, 0x03,
+        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, ssd->pages - 1,
         0x00, 0xFF, ssd1306_set_scroll | (set ? 0x01 : 0)
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
 }
 
-// Atualiza uma parte do display com uma área de renderização
-void render_on_display(uint8_t *ssd, struct render_area *area) {
+// Atualiza uma parte do display com uma área de renderização. Se alguma escrita falhou ou o
+// barramento foi recuperado no meio do envio, o conteúdo da área é incerto: a cópia sombra é
+// descartada, o próximo envio por diferença leva a tela inteira e o retorno é false
+bool render_on_display(ssd1306_t *ssd, const uint8_t *buffer, struct render_area *area) {
+    PERF_BEGIN(PERF_RENDER_ON_DISPLAY);
     uint8_t commands[] = {
         ssd1306_set_column_address, area->start_column, area->end_column,
         ssd1306_set_page_address, area->start_page, area->end_page
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
-    ssd1306_send_buffer(ssd, area->buffer_length);
+    uint32_t recoveries = ssd->bus->stats.recoveries;
+    bool sent = ssd1306_send_command_list(ssd, commands, count_of(commands)) &&
+                ssd1306_send_buffer(ssd, buffer, area->buffer_length);
+    if (!sent || ssd->bus->stats.recoveries != recoveries) {
+        ssd1306_shadow_invalidate(ssd);
+        PERF_END(PERF_RENDER_ON_DISPLAY);
+        return false;
+    }
+
+    // Mantém a cópia sombra coerente com o que foi enviado à área
+    int i = 0;
+    for (int page = area->start_page; page <= area->end_page; page++) {
+        for (int column = area->start_column; column <= area->end_column; column++) {
+            ssd->shadow[page * ssd1306_width + column] = buffer[i++];
+        }
+    }
+    if (area->start_column == 0 && area->end_column == ssd1306_width - 1 &&
+        area->start_page == 0 && area->end_page == ssd->pages - 1) {
+        ssd->shadow_valid = true;
+    }
+    PERF_ADD(oled_frames, 1);
+    PERF_END(PERF_RENDER_ON_DISPLAY);
+    return true;
+}
+
+// Envia ao display apenas o trecho alterado de cada página, comparando com a cópia sombra.
+// Retorna o número de bytes de dados enviados (0 quando o quadro é idêntico ao exibido)
+static int ssd1306_flush_changes(ssd1306_t *ssd, const uint8_t *buffer) {
+    if (!ssd->shadow_valid) {
+        struct render_area full = {
+            start_column : 0,
+            end_column : ssd1306_width - 1,
+            start_page : 0,
+            end_page : ssd->pages - 1
+        };
+        calculate_render_area_buffer_length(&full);
+        render_on_display(ssd, buffer, &full);
+        return full.buffer_length;
+    }
+
+    int sent = 0;
+    for (int page = 0; page < ssd->pages; page++) {
+        const uint8_t *row = buffer + page * ssd1306_width;
+        const uint8_t *shadow_row = ssd->shadow + page * ssd1306_width;
+
+        int first = 0;
+        while (first < ssd1306_width && row[first] == shadow_row[first]) {
+            first++;
+        }
+        if (first == ssd1306_width) {
+            continue; // Página sem alterações
+        }
+        int last = ssd1306_width - 1;
+        while (row[last] == shadow_row[last]) {
+            last--;
+        }
+
+        // Dentro de uma página as colunas são contíguas, então o trecho é enviado sem cópia
+        struct render_area span = {
+            start_column : first,
+            end_column : last,
+            start_page : page,
+            end_page : page
+        };
+        calculate_render_area_buffer_length(&span);
+        render_on_display(ssd, row + first, &span);
+        sent += span.buffer_length;
+        if (!ssd->shadow_valid) {
+            break; // Falha ou barramento recuperado: os trechos seguintes não valem mais
+        }
+    }
+
+    return sent;
+}
+
+// Envio por diferença que sobrevive a uma recuperação do barramento no meio do quadro: a cópia
+// sombra é descartada e o envio recomeça do topo, com a tela inteira. Retorna os bytes de dados
+// enviados, somando as tentativas
+int render_changes_on_display(ssd1306_t *ssd, const uint8_t *buffer) {
+    int sent = 0;
+    for (int attempt = 0; attempt < i2c_bus_attempts; attempt++) {
+        uint32_t recoveries = ssd->bus->stats.recoveries;
+        sent += ssd1306_flush_changes(ssd, buffer);
+        if (ssd->bus->stats.recoveries == recoveries) {
+            break;
+        }
+        ssd1306_shadow_invalidate(ssd);
+    }
+    return sent;
+}
+
+// Inicia a transmissão de um quadro já preparado (chamada com o canal livre e, se o endereço
+// de destino mudar, com o controlador ocioso)
+static void ssd1306_dma_start(ssd1306_t *ssd, int frame) {
+    i2c_hw_t *hw = i2c_get_hw(ssd->bus->i2c);
+    if ((hw->tar & I2C_IC_TAR_IC_TAR_BITS) != ssd->address) {
+        // Outro display (ou uma escrita bloqueante) usou o controlador por último
+        hw->enable = 0;
+        hw->tar = ssd->address;
+        hw->enable = 1;
+    }
+    ssd->dma_active = frame;
+    ssd->dma_started_us = time_us_32();
+    dma_channel_transfer_from_buffer_now(ssd->dma_channel, ssd->dma_frames[frame], ssd->dma_lengths[frame]);
+}
+
+// Fim de um quadro: encadeia o quadro pendente, se houver, e avisa o usuário
+static void ssd1306_dma_frame_done(ssd1306_t *ssd) {
+    dma_channel_acknowledge_irq0(ssd->dma_channel);
+
+    i2c_hw_t *hw = i2c_get_hw(ssd->bus->i2c);
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        // Quadro abortado (NAK): a FIFO fica descartando bytes até a leitura de IC_CLR_TX_ABRT.
+        // O quadro pendente era uma diferença sobre o abortado e também é descartado
+        (void)hw->clr_tx_abrt;
+        ssd->dma_fault = true;
+        ssd->dma_pending = -1;
+    } else {
+        PERF_ADD(oled_frames, 1);
+    }
+
+    if (ssd->dma_pending >= 0) {
+        int next = ssd->dma_pending;
+        ssd->dma_pending = -1;
+        ssd1306_dma_start(ssd, next);
+    } else {
+        ssd->dma_active = -1;
+    }
+
+    if (ssd->dma_callback) {
+        ssd->dma_callback(ssd);
+    }
+}
+
+// Interrupção compartilhada: atende os canais de todos os displays
+static void ssd1306_dma_irq_handler(void) {
+    for (int i = 0; i < ssd1306_panel_count; i++) {
+        ssd1306_t *ssd = ssd1306_panels[i];
+        if (ssd->dma_channel >= 0 && dma_channel_get_irq0_status(ssd->dma_channel)) {
+            ssd1306_dma_frame_done(ssd);
+        }
+    }
+}
+
+// Configura o canal de DMA que alimenta o i2c do display com os quadros. Displays em
+// controladores diferentes transmitem em paralelo; no mesmo controlador, um de cada vez
+void ssd1306_dma_init(ssd1306_t *ssd) {
+    i2c_inst_t *i2c = ssd->bus->i2c;
+    ssd->dma_channel = dma_claim_unused_channel(true);
+
+    dma_channel_config config = dma_channel_get_default_config(ssd->dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(i2c, true));
+    dma_channel_configure(ssd->dma_channel, &config, &i2c_get_hw(i2c)->data_cmd, NULL, 0, false);
+
+    dma_channel_set_irq0_enabled(ssd->dma_channel, true);
+    if (!ssd1306_dma_irq_installed) {
+        ssd1306_dma_irq_installed = true;
+        irq_add_shared_handler(DMA_IRQ_0, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+}
+
+// Define a função chamada (em contexto de interrupção) ao fim de cada quadro enviado via DMA
+void ssd1306_dma_set_callback(ssd1306_t *ssd, void (*callback)(ssd1306_t *ssd)) {
+    ssd->dma_callback = callback;
+}
+
+// Trata as falhas do envio via DMA fora da interrupção: quadro abortado (contado no barramento e
+// reenviado a partir da cópia sombra) ou quadro que não termina (barramento travado: o canal é
+// abortado e o barramento recuperado, o que reinicializa o display e reenvia a tela)
+static void ssd1306_dma_check(ssd1306_t *ssd) {
+    if (ssd->dma_fault) {
+        ssd->dma_fault = false;
+        i2c_bus_report_error(ssd->bus, PICO_ERROR_GENERIC);
+        if (ssd->dma_active < 0) {
+            ssd1306_restore_shadow(ssd);
+        }
+        return;
+    }
+
+    if (ssd->dma_active >= 0 &&
+        time_us_32() - ssd->dma_started_us > i2c_bus_timeout_us(ssd->bus->baudrate, ssd1306_dma_frame_words)) {
+        uint32_t status = save_and_disable_interrupts();
+        dma_channel_set_irq0_enabled(ssd->dma_channel, false);
+        dma_channel_abort(ssd->dma_channel);
+        dma_channel_acknowledge_irq0(ssd->dma_channel);
+        dma_channel_set_irq0_enabled(ssd->dma_channel, true);
+        ssd->dma_active = -1;
+        ssd->dma_pending = -1;
+        restore_interrupts(status);
+
+        i2c_bus_report_error(ssd->bus, PICO_ERROR_TIMEOUT);
+    }
+}
+
+// Indica se ainda há quadro em transmissão ou bytes na FIFO do i2c. Também trata as falhas do
+// último quadro, de modo que quem espera o fim do envio nunca fica preso num barramento travado
+bool ssd1306_dma_busy(ssd1306_t *ssd) {
+    if (ssd->dma_channel < 0) {
+        return false;
+    }
+    ssd1306_dma_check(ssd);
+    return ssd->dma_active >= 0 || (i2c_get_hw(ssd->bus->i2c)->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+// Aguarda o fim de todos os quadros enviados via DMA
+void ssd1306_dma_wait(ssd1306_t *ssd) {
+    while (ssd1306_dma_busy(ssd)) {
+        tight_loop_contents();
+    }
+}
+
+// Indica se o controlador está com outro display: transmitindo, ou ainda esvaziando a FIFO
+// com outro endereço de destino (trocar o endereço exige o controlador ocioso)
+static bool ssd1306_bus_taken(ssd1306_t *ssd) {
+    for (int i = 0; i < ssd1306_panel_count; i++) {
+        ssd1306_t *other = ssd1306_panels[i];
+        if (other != ssd && other->bus == ssd->bus && other->dma_active >= 0) {
+            return true;
+        }
+    }
+    i2c_hw_t *hw = i2c_get_hw(ssd->bus->i2c);
+    return (hw->tar & I2C_IC_TAR_IC_TAR_BITS) != ssd->address && (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+// Prepara em segundo plano o retângulo alterado do quadro e o envia via DMA, sem bloquear.
+// O conteúdo de buffer é copiado, podendo ser redesenhado logo após o retorno.
+// Retorna false se os dois quadros estiverem ocupados ou se outro display estiver usando o
+// mesmo controlador (o quadro é descartado e deve ser reenviado). Antes de ssd1306_dma_init o
+// envio é bloqueante, só com os trechos alterados de cada página
+bool render_on_display_async(ssd1306_t *ssd, const uint8_t *buffer) {
+    if (ssd->dma_channel < 0) {
+        render_changes_on_display(ssd, buffer);
+        return true;
+    }
+    ssd1306_dma_check(ssd);
+    if (ssd->dma_active < 0 && ssd1306_bus_taken(ssd)) {
+        return false;
+    }
+    int frame = 0;
+    while (frame == ssd->dma_active || frame == ssd->dma_pending) {
+        if (++frame == 2) {
+            return false;
+        }
+    }
+    PERF_BEGIN(PERF_RENDER_ASYNC);
+
+    // Retângulo que envolve todas as alterações em relação à cópia sombra
+    int start_page = 0, end_page = ssd->pages - 1;
+    int start_column = 0, end_column = ssd1306_width - 1;
+    if (ssd->shadow_valid) {
+        start_page = ssd->pages;
+        end_page = -1;
+        start_column = ssd1306_width;
+        end_column = -1;
+        for (int page = 0; page < ssd->pages; page++) {
+            const uint8_t *row = buffer + page * ssd1306_width;
+            const uint8_t *shadow_row = ssd->shadow + page * ssd1306_width;
+            for (int column = 0; column < ssd1306_width; column++) {
+                if (row[column] != shadow_row[column]) {
+                    if (column < start_column) start_column = column;
+                    if (column > end_column) end_column = column;
+                    if (page < start_page) start_page = page;
+                    end_page = page;
+                }
+            }
+        }
+        if (end_page < 0) {
+            PERF_END(PERF_RENDER_ASYNC);
+            return true; // Quadro idêntico ao exibido: nada a enviar
+        }
+    }
+
+    uint16_t *words = ssd->dma_frames[frame];
+    const uint8_t commands[] = {
+        ssd1306_set_column_address, start_column, end_column,
+        ssd1306_set_page_address, start_page, end_page
+    };
+    uint n = 0;
+    words[n++] = 0x00; // Janela de endereçamento numa única transação de comandos
+    for (uint i = 0; i < count_of(commands); i++) {
+        words[n++] = commands[i];
+    }
+    words[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    words[n++] = 0x40;
+    for (int page = start_page; page <= end_page; page++) {
+        for (int column = start_column; column <= end_column; column++) {
+            uint8_t byte = buffer[page * ssd1306_width + column];
+            ssd->shadow[page * ssd1306_width + column] = byte;
+            words[n++] = byte;
+        }
+    }
+    words[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    ssd->dma_lengths[frame] = n;
+    ssd->shadow_valid = true;
+
+    uint32_t status = save_and_disable_interrupts();
+    if (ssd->dma_active < 0) {
+        ssd1306_dma_start(ssd, frame);
+    } else {
+        ssd->dma_pending = frame;
+    }
+    restore_interrupts(status);
+
+    PERF_ADD(i2c_transactions, 2);
+    PERF_ADD(i2c_bytes, n);
+    PERF_END(PERF_RENDER_ASYNC);
+    return true;
+}
+
+// Envia os quadros de vários displays (todos com DMA configurado, no máximo ssd1306_max_panels)
+// e aguarda o fim de todos. Displays em controladores diferentes transmitem ao mesmo tempo; os
+// que dividem um controlador entram assim que ele fica livre. Cada display recebe apenas o
+// retângulo alterado
+void ssd1306_flush_group(ssd1306_t *const panels[], const uint8_t *const buffers[], int count) {
+    if (count < 0 || count > ssd1306_max_panels) {
+        panic("ssd1306: grupo de %d displays", count);
+    }
+    uint32_t submitted = 0;
+    uint32_t all = (1u << count) - 1;
+    while (submitted != all) {
+        for (int i = 0; i < count; i++) {
+            if (!(submitted & (1u << i)) && render_on_display_async(panels[i], buffers[i])) {
+                submitted |= 1u << i;
+            }
+        }
+        if (submitted != all) {
+            tight_loop_contents(); // Algum controlador ainda está com outro display
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        ssd1306_dma_wait(panels[i]);
+    }
 }
 
 // Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
 void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
-    assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
+    // Recorta em vez de afirmar: com NDEBUG o assert some e a escrita sairia do buffer
+    if (x < 0 || x >= ssd1306_width || y < 0 || y >= ssd1306_height) {
+        return;
+    }
 
     const int bytes_per_row = ssd1306_width;
 
@@ -106,6 +552,17 @@ void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
 
 // Algoritmo de Bresenham básico
 void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
+    // Linhas horizontais e verticais viram trechos com máscara, sem passo por pixel
+    ssd1306_draw_mode_t mode = set ? SSD1306_DRAW_SET : SSD1306_DRAW_CLEAR;
+    if (y_0 == y_1) {
+        ssd1306_hline(ssd, x_0 < x_1 ? x_0 : x_1, y_0, abs(x_1 - x_0) + 1, mode);
+        return;
+    }
+    if (x_0 == x_1) {
+        ssd1306_vline(ssd, x_0, y_0 < y_1 ? y_0 : y_1, abs(y_1 - y_0) + 1, mode);
+        return;
+    }
+
     int dx = abs(x_1 - x_0); // Deslocamentos
     int dy = -abs(y_1 - y_0);
     int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
@@ -133,7 +590,7 @@ void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool se
 }
 
 // Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
-inline int ssd1306_get_font(uint8_t character)
+static inline int ssd1306_get_font(uint8_t character)
 {
   if (character >= 'A' && character <= 'Z') {
     return character - 'A' + 1;
@@ -174,72 +631,14 @@ void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
     }
 }
 
-// Comando de configuração com base na estrutura ssd1306_t
-void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-	ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false );
-}
-
-// Função de configuração do display para o caso do bitmap
-void ssd1306_config(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_display | 0x00);
-    ssd1306_command(ssd, ssd1306_set_memory_mode);
-    ssd1306_command(ssd, 0x01);
-    ssd1306_command(ssd, ssd1306_set_display_start_line | 0x00);
-    ssd1306_command(ssd, ssd1306_set_segment_remap | 0x01);
-    ssd1306_command(ssd, ssd1306_set_mux_ratio);
-    ssd1306_command(ssd, ssd1306_height - 1);
-    ssd1306_command(ssd, ssd1306_set_common_output_direction | 0x08);
-    ssd1306_command(ssd, ssd1306_set_display_offset);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd1306_set_common_pin_configuration);
-    ssd1306_command(ssd, 0x12);
-    ssd1306_command(ssd, ssd1306_set_display_clock_divide_ratio);
-    ssd1306_command(ssd, 0x80);
-    ssd1306_command(ssd, ssd1306_set_precharge);
-    ssd1306_command(ssd, 0xF1);
-    ssd1306_command(ssd, ssd1306_set_vcomh_deselect_level);
-    ssd1306_command(ssd, 0x30);
-    ssd1306_command(ssd, ssd1306_set_contrast);
-    ssd1306_command(ssd, 0xFF);
-    ssd1306_command(ssd, ssd1306_set_entire_on);
-    ssd1306_command(ssd, ssd1306_set_normal_display);
-    ssd1306_command(ssd, ssd1306_set_charge_pump);
-    ssd1306_command(ssd, 0x14);
-    ssd1306_command(ssd, ssd1306_set_display | 0x01);
-}
-
-// Inicializa o display para o caso de exibição de bitmap
-void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
-    ssd->width = width;
-    ssd->height = height;
-    ssd->pages = height / 8U;
-    ssd->address = address;
-    ssd->i2c_port = i2c;
-    ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    ssd->ram_buffer[0] = 0x40;
-    ssd->port_buffer[0] = 0x80;
-}
-
-// Envia os dados ao display
-void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_column_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, ssd1306_set_page_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(
-    ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false );
-}
-
-// Desenha o bitmap (a ser fornecido em display_oled.c) no display
+// Envia ao display um bitmap de tela inteira, no mesmo formato do buffer (páginas de 8 linhas)
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
-        ssd->ram_buffer[i + 1] = bitmap[i];
-
-        ssd1306_send_data(ssd);
-    }
-}
\ No newline at end of file
+    struct render_area full = {
+        start_column : 0,
+        end_column : ssd1306_width - 1,
+        start_page : 0,
+        end_page : ssd->pages - 1
+    };
+    calculate_render_area_buffer_length(&full);
+    render_on_display(ssd, bitmap, &full);
+}
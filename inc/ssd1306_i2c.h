@@ -1,16 +1,18 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "i2c_bus.h"
 
 #ifndef ssd1306_inc_h
 #define ssd1306_inc_h
 
-#define ssd1306_height 64 // Define a altura do display (32 pixels)
+#define ssd1306_height 64 // Altura máxima dos displays (64 ou 32 pixels, ver ssd1306_attach)
 #define ssd1306_width 128 // Define a largura do display (128 pixels)
 
-#define ssd1306_i2c_address _u(0x3C) // Define o endereço do i2c do display
+#define ssd1306_i2c_address _u(0x3C) // Endereço i2c padrão do display (o alternativo é 0x3D)
 
-#define ssd1306_i2c_clock 400 // Define o tempo do clock (pode ser aumentado)
+#define ssd1306_command_batch_max 32 // Máximo de comandos agrupados numa única transação i2c
+#define ssd1306_max_panels 4 // Displays que podem ser associados ao mesmo tempo
 
 // Comandos de configuração (endereços)
 #define ssd1306_set_memory_mode _u(0x20)
@@ -39,6 +41,7 @@
 #define ssd1306_set_precharge _u(0xD9)
 #define ssd1306_set_common_pin_configuration _u(0xDA)
 #define ssd1306_set_vcomh_deselect_level _u(0xDB)
+#define ssd1306_nop _u(0xE3)
 
 #define ssd1306_page_height _u(8)
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
@@ -56,13 +59,34 @@ struct render_area {
     int buffer_length;
 };
 
-typedef struct {
-  uint8_t width, height, pages, address;
-  i2c_inst_t * i2c_port;
-  bool external_vcc;
-  uint8_t *ram_buffer;
-  size_t bufsize;
-  uint8_t port_buffer[2];
+// Quadros para envio via DMA: cada palavra de 16 bits é escrita em IC_DATA_CMD,
+// com o byte no bit 0..7 e o pedido de STOP no bit 9 ao fim de cada transação.
+// São dois quadros: enquanto um está no barramento, o outro pode ser preparado.
+#define ssd1306_dma_header_words (1 + 6)
+#define ssd1306_dma_frame_words (ssd1306_dma_header_words + 1 + ssd1306_buffer_length)
+
+// Um display: barramento e endereço, cópia sombra da GDDRAM e os quadros do envio via DMA.
+// Todas as operações recebem a instância; cada uma ocupa cerca de 6 KiB e não deve mudar de
+// endereço após ssd1306_attach (use uma variável estática ou global)
+typedef struct ssd1306 {
+    i2c_bus_t *bus;
+    uint8_t address;
+    uint8_t height;
+    uint8_t pages;
+    bool external_vcc;
+
+    uint8_t shadow[ssd1306_buffer_length]; // Conteúdo atualmente presente na GDDRAM
+    bool shadow_valid;
+    uint8_t tx_buffer[ssd1306_buffer_length + 1]; // Envio bloqueante, já com o byte de controle de dados (0x40)
+
+    uint16_t dma_frames[2][ssd1306_dma_frame_words];
+    uint dma_lengths[2];
+    int dma_channel;              // -1: envio via DMA não configurado
+    volatile int dma_active;      // Quadro em transmissão (-1: nenhum)
+    volatile int dma_pending;     // Quadro pronto aguardando o barramento (-1: nenhum)
+    volatile uint32_t dma_started_us; // Início do quadro ativo, para detectar barramento travado
+    volatile bool dma_fault;      // O controlador abortou um quadro (NAK)
+    void (*dma_callback)(struct ssd1306 *ssd);
 } ssd1306_t;
 
 #endif
\ No newline at end of file
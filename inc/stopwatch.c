@@ -0,0 +1,56 @@
+#include "pico/stdlib.h"
+#include "stopwatch.h"
+
+// Zera a contagem, deixando o cronômetro parado
+void stopwatch_reset(stopwatch_t *sw, uint64_t now) {
+    sw->start_us = now;
+    sw->paused_us = 0;
+    sw->pause_at = now;
+    sw->running = false;
+}
+
+// Inicia ou retoma a contagem; o intervalo parado é somado ao total pausado
+void stopwatch_start(stopwatch_t *sw, uint64_t now) {
+    if (sw->running) {
+        return;
+    }
+    sw->paused_us += now - sw->pause_at;
+    sw->running = true;
+}
+
+// Pausa a contagem, registrando o instante da pausa
+void stopwatch_pause(stopwatch_t *sw, uint64_t now) {
+    if (!sw->running) {
+        return;
+    }
+    sw->pause_at = now;
+    sw->running = false;
+}
+
+// Tempo decorrido em microssegundos no instante now (independe de quando é consultado)
+uint64_t stopwatch_elapsed_us(const stopwatch_t *sw, uint64_t now) {
+    uint64_t end = sw->running ? now : sw->pause_at;
+    return end - sw->start_us - sw->paused_us;
+}
+
+// Decompõe o tempo decorrido em horas, minutos, segundos e milissegundos
+stopwatch_time_t stopwatch_split(uint64_t elapsed_us) {
+    uint64_t ms = (elapsed_us / 1000) % ((uint64_t)stopwatch_wrap_hours * 3600 * 1000);
+    uint32_t s = (uint32_t)(ms / 1000);
+
+    stopwatch_time_t t = {
+        .hour = s / 3600,
+        .minute = (s / 60) % 60,
+        .second = s % 60,
+        .millisecond = ms % 1000
+    };
+    return t;
+}
+
+// Tempo até a próxima virada de um período da contagem (um período inteiro quando parado)
+uint64_t stopwatch_us_to_next(const stopwatch_t *sw, uint64_t now, uint64_t period_us) {
+    if (!sw->running) {
+        return period_us;
+    }
+    return period_us - stopwatch_elapsed_us(sw, now) % period_us;
+}
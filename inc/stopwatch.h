@@ -0,0 +1,29 @@
+#include "pico/stdlib.h"
+
+#ifndef stopwatch_inc_h
+#define stopwatch_inc_h
+
+#define stopwatch_wrap_hours 32 // Após 32 horas a contagem exibida volta a 00:00:00
+
+// Cronômetro derivado de um relógio monotônico (time_us_64): o tempo decorrido é sempre
+// calculado a partir do instante de início e do total pausado, nunca acumulado por tiques
+typedef struct {
+    uint64_t start_us;  // Instante em que a contagem começou
+    uint64_t paused_us; // Duração total das pausas desde o início
+    uint64_t pause_at;  // Instante da pausa atual (válido quando parado)
+    bool running;
+} stopwatch_t;
+
+// Tempo decorrido já decomposto para exibição
+typedef struct {
+    int hour, minute, second, millisecond;
+} stopwatch_time_t;
+
+extern void stopwatch_reset(stopwatch_t *sw, uint64_t now);
+extern void stopwatch_start(stopwatch_t *sw, uint64_t now);
+extern void stopwatch_pause(stopwatch_t *sw, uint64_t now);
+extern uint64_t stopwatch_elapsed_us(const stopwatch_t *sw, uint64_t now);
+extern stopwatch_time_t stopwatch_split(uint64_t elapsed_us);
+extern uint64_t stopwatch_us_to_next(const stopwatch_t *sw, uint64_t now, uint64_t period_us);
+
+#endif
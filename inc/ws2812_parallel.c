@@ -0,0 +1,120 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "ws2812_parallel.h"
+#include "ws2818b.pio.h"
+
+// Endereço do programa paralelo em cada PIO (-1 enquanto não carregado)
+static int ws2812_parallel_offset[2] = {-1, -1};
+
+// Carrega o programa (uma vez por PIO) e reserva uma máquina de estados
+static bool ws2812_parallel_claim(ws2812_parallel_t *out, PIO pio) {
+    int index = pio == pio0 ? 0 : 1;
+    if (ws2812_parallel_offset[index] < 0) {
+        if (!pio_can_add_program(pio, &ws2818b_parallel_program))
+            return false;
+        ws2812_parallel_offset[index] = pio_add_program(pio, &ws2818b_parallel_program);
+    }
+    int sm = pio_claim_unused_sm(pio, false);
+    if (sm < 0)
+        return false;
+    out->pio = pio;
+    out->sm = sm;
+    return true;
+}
+
+bool ws2812_parallel_init(ws2812_parallel_t *out, uint pin_base, uint strips, const uint16_t *lengths, uint32_t *words) {
+    if (strips == 0 || strips > ws2812_parallel_max_strips)
+        return false;
+    if (!ws2812_parallel_claim(out, pio0) && !ws2812_parallel_claim(out, pio1))
+        return false;
+
+    out->pin_base = pin_base;
+    out->strips = strips;
+    out->max_length = 0;
+    for (uint s = 0; s < ws2812_parallel_max_strips; s++) {
+        out->lengths[s] = s < strips ? lengths[s] : 0;
+        if (out->lengths[s] > out->max_length)
+            out->max_length = out->lengths[s];
+    }
+    out->words = words;
+    out->latch_until = 0;
+    out->frames = 0;
+    out->transpose_max_us = 0;
+    memset(words, 0, ws2812_parallel_buffer_words(out->max_length) * sizeof(uint32_t));
+
+    ws2818b_parallel_program_init(out->pio, out->sm, ws2812_parallel_offset[out->pio == pio0 ? 0 : 1],
+                                  pin_base, strips, ws2812_parallel_freq);
+
+    // Uma palavra (4 tempos de bit) por requisição da FIFO
+    out->dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(out->dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(out->pio, out->sm, true));
+    dma_channel_configure(out->dma_channel, &config, &out->pio->txf[out->sm], words,
+                          ws2812_parallel_buffer_words(out->max_length), false);
+    return true;
+}
+
+bool ws2812_parallel_busy(const ws2812_parallel_t *out) {
+    return dma_channel_is_busy(out->dma_channel) || time_us_64() < out->latch_until;
+}
+
+// Transpõe uma matriz de 8x8 bits: o byte s de x (linha s) vira a coluna s do resultado, ou seja,
+// o byte b do resultado tem no bit s o bit b do byte s da entrada
+static inline uint64_t ws2812_parallel_transpose8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+// Monta o buffer de saída: para cada LED e cada bit de G, R e B (mais significativo primeiro),
+// um byte cujo bit s é o valor desse bit na fita s. Fitas mais curtas recebem zeros depois do
+// fim, que ninguém lê
+void ws2812_parallel_transpose(uint8_t *dest, const uint32_t *const pixels[], const uint16_t *lengths, uint strips, uint max_length) {
+    for (uint i = 0; i < max_length; i++) {
+        for (int c = 0; c < 3; c++) {
+            uint64_t rows = 0;
+            for (uint s = 0; s < strips; s++) {
+                if (i < lengths[s])
+                    rows |= (uint64_t)((pixels[s][i] >> (24 - 8 * c)) & 0xFF) << (8 * s);
+            }
+            uint64_t columns = ws2812_parallel_transpose8(rows);
+            for (int b = 7; b >= 0; b--)
+                *dest++ = (columns >> (8 * b)) & 0xFF;
+        }
+    }
+}
+
+// Transpõe o quadro (pixels[s] com lengths[s] cores GRB alinhadas à esquerda) e inicia o envio
+// sem bloquear; retorna false se o quadro anterior ainda está em andamento
+bool ws2812_parallel_show(ws2812_parallel_t *out, const uint32_t *const pixels[]) {
+    if (ws2812_parallel_busy(out))
+        return false;
+
+    uint32_t start = time_us_32();
+    ws2812_parallel_transpose((uint8_t *)out->words, pixels, out->lengths, out->strips, out->max_length);
+    uint32_t elapsed = time_us_32() - start;
+    if (elapsed > out->transpose_max_us)
+        out->transpose_max_us = elapsed;
+
+    // O PIO transmite em ritmo fixo, então o fim do quadro e do reset é conhecido desde o início
+    out->latch_until = time_us_64() + ws2812_frame_us(1, out->max_length, true);
+    out->frames++;
+    dma_channel_transfer_from_buffer_now(out->dma_channel, out->words, ws2812_parallel_buffer_words(out->max_length));
+    return true;
+}
+
+uint32_t ws2812_frame_us(uint strips, uint length, bool parallel) {
+    uint32_t bits = 24 * length * (parallel ? 1 : strips);
+    return bits * ws2812_parallel_bit_ns / 1000 + ws2812_parallel_reset_us;
+}
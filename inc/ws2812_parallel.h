@@ -0,0 +1,48 @@
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#ifndef ws2812_parallel_inc_h
+#define ws2812_parallel_inc_h
+
+#define ws2812_parallel_max_strips 8
+#define ws2812_parallel_freq 800000   // Frequência dos bits (Hz)
+#define ws2812_parallel_bit_ns 1250
+#define ws2812_parallel_reset_us 100  // Nível baixo para as fitas travarem o quadro
+
+// Palavras do buffer transposto para fitas de até max_length LEDs (24 tempos de bit por LED,
+// um byte por tempo de bit, 4 bytes por palavra da FIFO)
+#define ws2812_parallel_buffer_words(max_length) ((max_length) * 6)
+
+// Até 8 fitas em pinos consecutivos, alimentadas por uma única máquina de estados via DMA.
+// Para mais fitas, crie várias instâncias: cada uma ocupa uma máquina de estados em pio0 ou pio1
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint dma_channel;
+    uint pin_base;
+    uint strips;
+    uint16_t lengths[ws2812_parallel_max_strips]; // LEDs de cada fita
+    uint16_t max_length;
+    uint32_t *words;          // Buffer transposto, ws2812_parallel_buffer_words(max_length) palavras
+    uint64_t latch_until;     // Instante (us) em que o quadro anterior estará travado nas fitas
+    uint32_t frames;          // Quadros enviados
+    uint32_t transpose_max_us; // Maior tempo de CPU gasto na transposição de um quadro
+} ws2812_parallel_t;
+
+extern bool ws2812_parallel_init(ws2812_parallel_t *out, uint pin_base, uint strips, const uint16_t *lengths, uint32_t *words);
+extern bool ws2812_parallel_busy(const ws2812_parallel_t *out);
+extern bool ws2812_parallel_show(ws2812_parallel_t *out, const uint32_t *const pixels[]);
+extern void ws2812_parallel_transpose(uint8_t *dest, const uint32_t *const pixels[], const uint16_t *lengths, uint strips, uint max_length);
+
+// Modelo do tempo de quadro (us) de `strips` fitas com `length` LEDs cada. Em série, numa única
+// saída, cresce com strips * length; em paralelo, só com o comprimento da maior fita:
+//
+//   fitas x LEDs   série            paralelo
+//   1 x 25         850 us (1176 Hz)    850 us (1176 Hz)
+//   8 x 25        6100 us  (163 Hz)    850 us (1176 Hz)
+//   8 x 60       14500 us   (68 Hz)   1900 us  (526 Hz)
+//   8 x 300      72100 us   (13 Hz)   9100 us  (109 Hz)
+//   16 x 300    144100 us    (6 Hz)   9100 us  (109 Hz, duas instâncias)
+extern uint32_t ws2812_frame_us(uint strips, uint length, bool parallel);
+
+#endif
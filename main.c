@@ -5,12 +5,37 @@
 #include "hardware/clocks.h"
 #include "hardware/i2c.h"
 #include "hardware/pwm.h" // Adicionado para controle PWM dos buzzers
+#include "hardware/dma.h"
+#include "hardware/flash.h"
 #include "ws2818b.pio.h"
+#if CHRONO_DUAL_CORE
+#include "pico/multicore.h"
+#endif
 #include "inc/ssd1306.h"
+#include "inc/ssd1306_draw.h"
+#include "inc/ssd1306_fx.h"
+#include "inc/ssd1306_anim.h"
+#include "inc/events.h"
+#include "inc/stopwatch.h"
+#include "inc/buzzer.h"
+#include "inc/input.h"
+#include "inc/perf.h"
+#include "inc/led_comp.h"
+#include "inc/laps.h"
+#include "inc/lap_log.h"
+#include "inc/host_link.h"
+#include "led_tables.h"
+#include "glyph_atlas.h"
+#include "splash_anim.h"
 
 // Definições de constantes para LEDs WS2812
 #define LED_COUNT 25
 #define LED_PIN 7
+#define LED_BIT_TIME_NS 1250 // Duração de um bit a 800 kHz
+#define LED_RESET_US 100 // Tempo em nível baixo para os LEDs travarem o quadro
+#define LED_BRIGHTNESS 25 // Brilho global dos LEDs (0 a 255), aplicado pelo compositor
+#define LED_REFRESH_HZ 400 // Atualização da matriz; um quadro leva 25 * 24 * 1,25 us + reset = 850 us
+#define LED_FADE_MS 150 // Transição dos bits do relógio binário ao mudarem
 
 // Definições de pinos I2C para OLED e botões
 const uint I2C_SDA = 14;
@@ -20,20 +45,29 @@ const uint BUTTON_B = 6; // Pino do botão B (assumido como GP6)
 const uint BUZZER1_PIN = 21; // Pino do buzzer 1 (assumido GP21)
 const uint BUZZER2_PIN = 10; // Pino do buzzer 2 (assumido GP10)
 
-// Estrutura para pixel RGB (formato GRB usado pelos WS2812)
-struct pixel_t {
-    uint8_t G, R, B;
-};
-typedef struct pixel_t pixel_t;
-typedef pixel_t npLED_t;
+// Pixel empacotado no formato GRB usado pelos WS2812: G nos bits 31..24, R em 23..16 e B em 15..8,
+// alinhado à esquerda para o PIO deslocar os 24 bits mais significativos de cada palavra
+typedef uint32_t npLED_t;
 
-// Buffer global para os 25 LEDs
+// Buffer lógico dos 25 LEDs (antes do gama e do brilho), composto na saída por inc/led_comp
 npLED_t leds[LED_COUNT];
 
 // Variáveis globais para controle do PIO
 PIO np_pio;
 uint sm;
 
+// Cópia do quadro em transmissão, lida pelo DMA enquanto leds[] pode ser alterado
+static npLED_t np_tx_buffer[LED_COUNT];
+static int np_dma_channel;
+static uint64_t np_latch_until = 0; // Instante (us) em que o quadro anterior estará travado nos LEDs
+static bool np_tx_valid = false; // np_tx_buffer reflete o que os LEDs exibem
+
+// Quadros efetivamente transmitidos e quadros descartados por serem iguais ao último enviado
+// (com o brilho baixo, o pontilhamento de um nível com fração repete o mesmo degrau em boa parte
+// dos quadros: cerca de um terço deles com o relógio contando)
+uint32_t np_frames_sent = 0;
+uint32_t np_frames_skipped = 0;
+
 /**
  * Define a cor RGB de um LED específico no buffer
  * @param index: Índice do LED (0 a 24)
@@ -42,9 +76,7 @@ uint sm;
  * @param b: Azul (0-255)
  */
 void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b) {
-    leds[index].R = r;
-    leds[index].G = g;
-    leds[index].B = b;
+    leds[index] = ((uint32_t)g << 24) | ((uint32_t)r << 16) | ((uint32_t)b << 8);
 }
 
 /**
@@ -68,116 +100,925 @@ void npInit(uint pin) {
         sm = pio_claim_unused_sm(np_pio, true);
     }
     ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+
+    // Canal de DMA que alimenta a FIFO do PIO com um pixel por palavra
+    np_dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(np_dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(np_pio, sm, true));
+    dma_channel_configure(np_dma_channel, &config, &np_pio->txf[sm], np_tx_buffer, LED_COUNT, false);
+
     npClear();
 }
 
 /**
- * Escreve os dados do buffer nos LEDs físicos
+ * Indica se ainda há um quadro sendo transmitido ou aguardando o tempo de reset dos LEDs
+ * @return: true enquanto um novo quadro não pode ser iniciado
+ */
+bool npBusy() {
+    return dma_channel_is_busy(np_dma_channel) || time_us_64() < np_latch_until;
+}
+
+/**
+ * Saída do compositor: inicia o envio de um quadro aos LEDs físicos via DMA, sem bloquear.
+ * Um quadro igual ao último enviado não é retransmitido
+ * @param frame: Pixels já corrigidos (gama, brilho e pontilhamento)
+ * @param count: Número de pixels (LED_COUNT)
+ * @return: false se o quadro anterior ainda está em andamento (nada é enviado)
+ */
+bool npWriteAsync(const npLED_t *frame, uint count) {
+    if (np_tx_valid && memcmp(np_tx_buffer, frame, sizeof(np_tx_buffer)) == 0) {
+        np_frames_skipped++;
+        return true;
+    }
+    if (npBusy()) {
+        return false;
+    }
+    PERF_BEGIN(PERF_NP_WRITE);
+    memcpy(np_tx_buffer, frame, sizeof(np_tx_buffer));
+    np_tx_valid = true;
+    np_frames_sent++;
+    PERF_ADD(pio_words, LED_COUNT);
+
+    // O PIO transmite em ritmo fixo, então o fim do quadro e do reset é conhecido desde o início
+    np_latch_until = time_us_64() + (LED_COUNT * 24 * LED_BIT_TIME_NS) / 1000 + LED_RESET_US;
+    dma_channel_transfer_from_buffer_now(np_dma_channel, np_tx_buffer, LED_COUNT);
+    PERF_END(PERF_NP_WRITE);
+    return true;
+}
+
+/**
+ * Compõe o quadro do relógio binário: segundos em verde, minutos em azul e horas em vermelho.
+ * As máscaras de cada valor vêm de tabelas geradas na compilação (tools/gen_led_tables.py),
+ * que já aplicam o layout serpentina da matriz
+ * @param hour: Horas (0 a 31)
+ * @param minute: Minutos (0 a 59)
+ * @param second: Segundos (0 a 59)
  */
-void npWrite() {
+void binaryToLed(int hour, int minute, int second) {
+    uint32_t green = led_second_masks[second];
+    uint32_t blue = led_minute_masks[minute];
+    uint32_t red = led_hour_masks[hour];
     for (uint i = 0; i < LED_COUNT; ++i) {
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
+        uint32_t lit = ((green >> i) & 1) << 24 | ((red >> i) & 1) << 16 | ((blue >> i) & 1) << 8;
+        leds[i] = lit * 0xFF; // Intensidade plena; o brilho global fica a cargo do compositor
     }
-    sleep_us(100);
 }
 
+// Sequenciadores de tons dos dois buzzers, independentes entre si
+static buzzer_t buzzer1, buzzer2;
+
 /**
- * Mapeia coordenadas 2D para índice linear na matriz de LEDs
- * @param x: Coluna (0 a 4)
- * @param y: Linha (0 a 4)
- * @return: Índice linear (0 a 24)
+ * Emite um som no buzzer 1 (1000 Hz), sem bloquear
+ * @param duration_ms: Duração do som em milissegundos
  */
-int getIndex(int x, int y) {
-    if (y % 2 == 0) {
-        return 24 - (y * 5 + x);
-    } else {
-        return 24 - (y * 5 + (4 - x));
+void buzzer1_beep(uint32_t duration_ms) {
+    buzzer_play(&buzzer1, 1000, 50, duration_ms); // Duty cycle 50%
+}
+
+/**
+ * Emite um som no buzzer 2 (500 Hz), sem bloquear
+ * @param duration_ms: Duração do som em milissegundos
+ */
+void buzzer2_beep(uint32_t duration_ms) {
+    buzzer_play(&buzzer2, 500, 50, duration_ms); // Duty cycle 50%
+}
+
+// Estado do cronômetro, compartilhado pelos tratadores de eventos
+static stopwatch_t stopwatch; // Contagem derivada de time_us_64(), sem deriva
+static bool is_reset_prompt = false; // Estado para exibir mensagem de reset
+static bool is_hires = false; // Modo de centésimos: "MM:SS.cc" atualizado a 100 Hz
+static uint64_t state_changed_at = 0; // Instante da última partida, pausa ou reset
+
+// Voltas da sessão em RAM e seu log na flash, gravado só com o cronômetro parado
+static laps_t laps;
+static lap_log_t lap_log;
+
+// Buffer para o OLED, o display, seus efeitos e seu barramento
+static uint8_t ssd[ssd1306_buffer_length];
+static ssd1306_t oled;
+static ssd1306_fx_t oled_fx;
+static i2c_bus_t oled_bus;
+
+// Período do tique em cada modo: o tique cai sempre na virada do último dígito exibido
+#define TICK_PERIOD_US 1000000
+#define HIRES_TICK_PERIOD_US 10000
+
+// Próximo tique agendado e o instante para o qual foi agendado
+static alarm_id_t tick_alarm = 0;
+static uint64_t tick_deadline = 0;
+
+/**
+ * Reagenda o tique para a próxima virada do dígito menos significativo exibido (segundos ou
+ * centésimos), ou um período inteiro quando parado
+ * @param now: Instante atual em microssegundos
+ */
+void schedule_tick(uint64_t now) {
+    uint64_t delay = stopwatch_us_to_next(&stopwatch, now, is_hires ? HIRES_TICK_PERIOD_US : TICK_PERIOD_US);
+    events_cancel(tick_alarm);
+    tick_deadline = now + delay;
+    tick_alarm = events_post_in_us(EVENT_TICK, delay);
+}
+
+// Assinatura do host (protocolo binário na USB CDC, inc/chrono_proto.h): mudanças de estado
+// são enviadas assim que acontecem e, com período definido, também registros periódicos
+#define HOST_MIN_PERIOD_US 1000 // Até 1 kHz
+static bool host_subscribed = false;
+static uint32_t host_period_us = 0;
+static uint64_t host_next_us = 0;
+static alarm_id_t host_alarm = 0;
+
+/**
+ * Envia ao host um registro de estado de tamanho fixo, sem bloquear
+ * @param seq: Sequência do comando respondido (0 nos registros espontâneos)
+ * @param cause: Comando ou botão que mudou o estado, ou CHRONO_CAUSE_PERIODIC
+ * @param now: Instante do registro
+ */
+void host_send_state(uint8_t seq, uint8_t cause, uint64_t now) {
+    chrono_proto_state_t state = {
+        .time_us = (uint32_t)now,
+        .elapsed_ms = (uint32_t)(stopwatch_elapsed_us(&stopwatch, now) / 1000),
+        .laps = (uint16_t)laps.count,
+        .flags = (stopwatch.running ? CHRONO_STATE_RUNNING : 0) | (is_reset_prompt ? CHRONO_STATE_RESET_PROMPT : 0) |
+                 (is_hires ? CHRONO_STATE_HIRES : 0),
+        .cause = cause
+    };
+    uint8_t frame[chrono_proto_state_frame];
+    host_link_send(frame, chrono_proto_encode_state(frame, seq, &state));
+}
+
+/**
+ * Avisa o host assinante de uma mudança de estado
+ * @param cause: CHRONO_CMD_* correspondente à mudança
+ * @param now: Instante da mudança
+ */
+void host_notify(uint8_t cause, uint64_t now) {
+    if (host_subscribed) {
+        host_send_state(0, cause, now);
+    }
+}
+
+/**
+ * Inicia ou retoma a contagem, cancelando um pedido de reset. Contar a partir do zero abre uma
+ * nova sessão de voltas
+ * @param now: Instante de referência exato da contagem
+ */
+void chrono_start(uint64_t now) {
+    if (!stopwatch.running && !is_reset_prompt && stopwatch_elapsed_us(&stopwatch, now) == 0) {
+        laps_reset(&laps);
+    }
+    is_reset_prompt = false;
+    stopwatch_start(&stopwatch, now);
+    state_changed_at = now;
+    schedule_tick(now);
+    events_post(EVENT_RENDER);
+    host_notify(CHRONO_CMD_START, now);
+}
+
+/**
+ * Pausa a contagem (sem efeito se já parada)
+ * @param now: Instante da pausa
+ */
+void chrono_pause(uint64_t now) {
+    stopwatch_pause(&stopwatch, now);
+    state_changed_at = now;
+    schedule_tick(now);
+    events_post(EVENT_STORAGE); // Parado, as voltas pendentes podem ir para a flash
+    events_post(EVENT_RENDER);
+    host_notify(CHRONO_CMD_PAUSE, now);
+}
+
+/**
+ * Zera o cronômetro e as voltas. Os LEDs são apagados no próximo quadro
+ * @param now: Instante do reset
+ */
+void chrono_reset(uint64_t now) {
+    stopwatch_reset(&stopwatch, now);
+    state_changed_at = now;
+    laps_reset(&laps);
+    is_reset_prompt = false;
+    schedule_tick(now);
+    events_post(EVENT_STORAGE);
+    events_post(EVENT_RENDER);
+    host_notify(CHRONO_CMD_RESET, now);
+}
+
+/**
+ * Marca uma volta, se o cronômetro está contando
+ * @param now: Instante da marcação
+ * @return: true se a volta foi marcada
+ */
+bool chrono_lap(uint64_t now) {
+    if (!stopwatch.running) {
+        return false;
+    }
+    laps_record(&laps, (uint32_t)(stopwatch_elapsed_us(&stopwatch, now) / 1000));
+    events_post(EVENT_RENDER);
+    host_notify(CHRONO_CMD_LAP, now);
+    return true;
+}
+
+/**
+ * Botão A: inicia/pausa o cronômetro ou cancela o reset e continua
+ * @param now: Instante da borda do botão, usado como referência exata da contagem
+ */
+void on_button_a(uint64_t now) {
+    if (is_reset_prompt || !stopwatch.running) { // Botão A inicia, ou cancela o reset e continua
+        chrono_start(now);
+    } else { // Botão A pausa
+        chrono_pause(now);
     }
+    buzzer1_beep(100); // Som de 1000 Hz por 100 ms
 }
 
 /**
- * Exibe segundos em binário nos LEDs com cor verde
- * @param num: Segundos (0 a 59)
+ * Botão B: pausa e pede confirmação do reset, ou confirma o reset
+ * @param now: Instante da borda do botão
  */
-void secToLed(int num) {
-    int positions[] = {0, 9, 10, 19, 20, 1};
-    for (int i = 0; i < 6; i++) {
-        if (num & (1 << i)) {
-            npSetLED(positions[i], 0, 25, 0);
+void on_button_b(uint64_t now) {
+    if (is_reset_prompt) { // Botão B confirma reset
+        chrono_reset(now);
+    } else { // Botão B inicia prompt de reset
+        is_reset_prompt = true;
+        chrono_pause(now);
+    }
+    buzzer2_beep(100); // Som de 500 Hz por 100 ms
+}
+
+/**
+ * Toque duplo no botão B: alterna entre "HH:MM:SS" e o modo de centésimos "MM:SS.cc"
+ * @param now: Instante da borda do botão
+ */
+void on_button_b_double(uint64_t now) {
+    is_hires = !is_hires;
+    schedule_tick(now);
+    buzzer2_beep(50);
+    events_post(EVENT_RENDER);
+}
+
+/**
+ * Toque longo no botão B: marca uma volta com o tempo do instante em que o botão foi pressionado
+ * @param now: Instante da borda de pressionar
+ */
+void on_button_b_long(uint64_t now) {
+    if (chrono_lap(now)) {
+        buzzer2_beep(30);
+    }
+}
+
+/**
+ * Instante de referência de um gesto: o da borda, mas nunca antes da última mudança de estado,
+ * que pode ter vindo do outro botão ou do host entre a borda e o processamento (o toque simples
+ * só sai depois da janela de toque duplo; um comando do host pode ser atendido antes da borda)
+ * @param time_us: Instante da borda
+ * @return: Instante a usar como referência da contagem
+ */
+uint64_t gesture_time(uint64_t time_us) {
+    return time_us > state_changed_at ? time_us : state_changed_at;
+}
+
+// Índices dos botões no subsistema de entrada e próximo processamento agendado
+static int button_a, button_b;
+static alarm_id_t input_alarm = 0;
+
+/**
+ * Gestos reconhecidos: A age ao pressionar (início/pausa sem atraso); B age no toque simples,
+ * alterna o modo de centésimos no toque duplo e marca uma volta no toque longo
+ * @param event: Gesto, botão e instante da borda
+ */
+void on_gesture(const input_event_t *event) {
+    if (event->button == button_a && event->gesture == INPUT_PRESS) {
+        on_button_a(gesture_time(event->time_us));
+    } else if (event->button == button_b && event->gesture == INPUT_CLICK) {
+        on_button_b(gesture_time(event->time_us)); // Pausa no instante do toque, não ao fim da janela
+    } else if (event->button == button_b && event->gesture == INPUT_DOUBLE) {
+        on_button_b_double(event->time_us);
+    } else if (event->button == button_b && event->gesture == INPUT_LONG) {
+        on_button_b_long(gesture_time(event->time_us - input_long_press_us)); // O gesto sai ao fim do tempo de toque longo
+    }
+}
+
+/**
+ * Processa as bordas capturadas e agenda o próximo processamento (debounce, toque longo/duplo)
+ */
+void on_input() {
+    uint64_t deadline = input_process(time_us_64(), on_gesture);
+    events_cancel(input_alarm);
+    input_alarm = 0;
+    if (deadline) {
+        uint64_t now = time_us_64();
+        input_alarm = events_post_in_us(EVENT_INPUT, deadline > now ? deadline - now : 0);
+    }
+}
+
+// Chamada na interrupção de borda dos botões
+void on_input_edge() {
+    events_post(EVENT_INPUT);
+}
+
+/**
+ * Recusa um comando desconhecido ou malformado
+ * @param frame: Quadro recebido
+ */
+void host_send_nak(const chrono_proto_frame_t *frame) {
+    uint8_t nak[chrono_proto_frame_size(1)];
+    host_link_send(nak, chrono_proto_encode(nak, CHRONO_MSG_NAK, frame->seq, &frame->type, 1));
+}
+
+/**
+ * Comando do host: aplica a ação e responde com o estado resultante, na mesma sequência
+ * @param frame: Quadro recebido (CRC já conferido)
+ */
+void on_host_command(const chrono_proto_frame_t *frame) {
+    if (!chrono_proto_command_valid(frame)) {
+        host_send_nak(frame); // Tipo desconhecido ou carga de tamanho errado: nada é aplicado
+        return;
+    }
+    uint64_t now = time_us_64();
+    switch (frame->type) {
+    case CHRONO_CMD_START:
+        if (is_reset_prompt || !stopwatch.running) {
+            chrono_start(now);
         }
+        break;
+    case CHRONO_CMD_PAUSE:
+        if (stopwatch.running) {
+            chrono_pause(now);
+        }
+        break;
+    case CHRONO_CMD_RESET:
+        chrono_reset(now);
+        break;
+    case CHRONO_CMD_LAP:
+        chrono_lap(now);
+        break;
+    case CHRONO_CMD_QUERY:
+        break;
+    case CHRONO_CMD_SUBSCRIBE: {
+        uint32_t period = frame->payload[0] | frame->payload[1] << 8 | frame->payload[2] << 16 | (uint32_t)frame->payload[3] << 24;
+        host_subscribed = true;
+        host_period_us = period && period < HOST_MIN_PERIOD_US ? HOST_MIN_PERIOD_US : period;
+        host_next_us = now;
+        events_post(EVENT_HOST); // Primeiro registro periódico já na próxima iteração
+        break;
+    }
     }
+    host_send_state(frame->seq, frame->type, now);
 }
 
 /**
- * Exibe minutos em binário nos LEDs com cor azul
- * @param num: Minutos (0 a 59)
+ * Trata os comandos que chegaram pela USB e envia o registro periódico da assinatura, quando vencido
  */
-void minToLed(int num) {
-    int positions[] = {2, 7, 12, 17, 22, 3};
-    for (int i = 0; i < 6; i++) {
-        if (num & (1 << i)) {
-            npSetLED(positions[i], 0, 0, 25);
+void on_host() {
+    host_link_process(on_host_command);
+
+    uint64_t now = time_us_64();
+    if (host_subscribed && host_period_us && now >= host_next_us) {
+        host_send_state(0, CHRONO_CAUSE_PERIODIC, now);
+        host_next_us += host_period_us;
+        if (host_next_us <= now) { // Atrasado: segue do instante atual, sem rajadas de recuperação
+            host_next_us = now + host_period_us;
         }
+        events_cancel(host_alarm);
+        host_alarm = events_post_in_us(EVENT_HOST, host_next_us - now);
     }
 }
 
+// Chamada na interrupção da USB quando chegam bytes do host
+void on_host_rx() {
+    events_post(EVENT_HOST);
+}
+
 /**
- * Exibe horas em binário nos LEDs com cor vermelha
- * @param num: Horas (0 a 31)
+ * Tique: redesenha quando o segundo (ou centésimo) exibido muda. Parado, a tela é estática (o
+ * painel pisca sozinho) e o tique não se reagenda. O tempo é sempre derivado do relógio
+ * monotônico; um tique atrasado apenas pula centésimos, contados na telemetria
  */
-void hourToLed(int num) {
-    int positions[] = {4, 5, 14, 15, 24};
-    for (int i = 0; i < 5; i++) {
-        if (num & (1 << i)) {
-            npSetLED(positions[i], 25, 0, 0);
+void on_tick() {
+    if (!stopwatch.running) {
+        return;
+    }
+    uint64_t now = time_us_64();
+#if CHRONO_PERF
+    if (is_hires) {
+        uint32_t late = now > tick_deadline ? (uint32_t)(now - tick_deadline) : 0;
+        PERF_MAX(hires_late_max_us, late);
+        PERF_ADD(hires_missed, late / HIRES_TICK_PERIOD_US);
+    }
+#endif
+    schedule_tick(now);
+    events_post(EVENT_RENDER);
+}
+
+// Estado exibido: um retrato imutável do cronômetro, a partir do qual o quadro é composto
+typedef struct {
+    uint64_t elapsed_us;
+    bool running;
+    bool reset_prompt;
+    bool hires;
+    uint32_t lap_number; // Última volta marcada (0: nenhuma)
+    uint32_t lap_ms;     // Duração da última volta
+} display_state_t;
+
+// Linha do texto no OLED: centralizado na vertical e alinhado a página (cópia direta dos glifos)
+#define TEXT_Y 24
+#define LABEL_Y 48 // Linha da mensagem de estado, abaixo do tempo
+
+// Efeitos do painel nos estados parados: a tela é enviada uma vez e depois só recebe comandos
+#define FX_BLINK_PERIOD_MS 1000 // Pausado: pisca a tela
+#define FX_INVERT_PERIOD_MS 1000 // Confirmação de reset: alterna vídeo inverso
+#define FX_FADE_MS 1500 // Aguardando início: "respiração" do contraste
+#define FX_FADE_MIN_CONTRAST 0x10
+
+// Texto desenhado hoje na faixa do tempo. Os dois formatos têm 8 caracteres de font_16 e só os
+// glifos que mudaram são redesenhados, de modo que o envio por diferença leva apenas as colunas
+// dos dígitos alterados: a 100 Hz costuma ser só o par de centésimos (64 bytes, ~1,5 ms a
+// 400 kHz) e, no pior caso, a faixa inteira (256 bytes, ~6 ms), dentro dos 10 ms de cada quadro
+static char shown_time[9];
+
+/**
+ * Redesenha na faixa do tempo apenas os glifos que diferem do texto já exibido
+ * @param text: Texto com 8 caracteres; os que não cabem na faixa (ex.: 100 horas ou mais) são ignorados
+ */
+void draw_time_text(const char *text) {
+    for (int i = 0; text[i] && i < (int)sizeof(shown_time); i++) {
+        if (text[i] != shown_time[i]) {
+            ssd1306_blit_glyph(ssd, i * font_16.width, TEXT_Y, &font_16, text[i]);
+            shown_time[i] = text[i];
         }
     }
 }
 
+// Abertura (assets/splash_*.pbm), tocada uma vez ao ligar antes da primeira tela do cronômetro.
+// Cada quadro é aplicado ao buffer ssd e enviado como os demais, pela diferença via DMA
+static ssd1306_anim_player_t splash;
+static bool splash_playing = false;
+static uint64_t splash_next_us = 0; // Instante do próximo quadro da abertura
+
 /**
- * Emite um som no buzzer 1 (1000 Hz)
- * @param duration_ms: Duração do som em milissegundos
+ * Aplica ao buffer o quadro da abertura, se já venceu
+ * @param now: Instante atual (us)
+ * @return: false quando a abertura terminou; buffer e texto exibido ficam zerados para a tela do cronômetro
  */
-void buzzer1_beep(uint32_t duration_ms) {
-    pwm_set_gpio_level(BUZZER1_PIN, 125); // Duty cycle ~50%
-    sleep_ms(duration_ms);
-    pwm_set_gpio_level(BUZZER1_PIN, 0); // Desliga o buzzer
+bool splash_advance(uint64_t now) {
+    if (now < splash_next_us) {
+        return true;
+    }
+    if (!ssd1306_anim_step(&splash, ssd)) {
+        splash_playing = false;
+        memset(ssd, 0, ssd1306_buffer_length);
+        memset(shown_time, 0, sizeof(shown_time));
+        return false;
+    }
+    splash_next_us += ssd1306_anim_frame_us(splash.anim);
+    return true;
 }
 
+// Saídas que recusaram o quadro por ainda estarem ocupadas com o anterior. Os LEDs nunca
+// recusam: o compositor apenas recebe os novos alvos e os envia no seu próprio ritmo
+#define RENDER_OLED_BUSY 0x1
+
 /**
- * Emite um som no buzzer 2 (500 Hz)
- * @param duration_ms: Duração do som em milissegundos
+ * Compõe e envia o quadro do OLED e, quando necessário, atualiza os alvos dos LEDs
+ * @param state: Estado a ser exibido
+ * @return: Máscara RENDER_* das saídas que precisam ser reenviadas (0: quadro completo)
  */
-void buzzer2_beep(uint32_t duration_ms) {
-    pwm_set_gpio_level(BUZZER2_PIN, 125); // Duty cycle ~50%
-    sleep_ms(duration_ms);
-    pwm_set_gpio_level(BUZZER2_PIN, 0); // Desliga o buzzer
+int render_frame(const display_state_t *state) {
+    stopwatch_time_t t = stopwatch_split(state->elapsed_us);
+    int busy = 0;
+
+    // Limpa apenas a faixa da mensagem; a do tempo é sobrescrita glifo a glifo
+    ssd1306_clear_rect(ssd, 0, LABEL_Y, ssd1306_width, 8);
+
+    // Tempo "HH:MM:SS" (ou "MM:SS.cc") com glifos de 16 pixels ocupa a largura toda; mensagens
+    // usam 8 pixels
+    char time_str[36]; // Pior caso de três int com sinal, dois separadores e o terminador
+    if (state->hires) {
+        snprintf(time_str, sizeof(time_str), "%02d:%02d.%02d", t.minute, t.second, t.millisecond / 10);
+        PERF_ADD(hires_frames, 1);
+        if (ssd1306_dma_busy(&oled)) {
+            PERF_ADD(hires_busy, 1);
+        }
+    } else {
+        snprintf(time_str, sizeof(time_str), "%02d:%02d:%02d", t.hour, t.minute, t.second);
+    }
+    draw_time_text(time_str);
+
+    // Parado, a tela não muda mais: o efeito do painel dá o destaque sem reenviar quadros
+    ssd1306_fx_kind_t effect = SSD1306_FX_NONE;
+    if (state->reset_prompt) { // Estado de espera por confirmação de reset
+        ssd1306_blit_string(ssd, 0, LABEL_Y, &font_8, "Press B to reset");
+        effect = SSD1306_FX_INVERT; // LEDs permanecem como estavam até confirmação
+    } else if (!state->running && (state->elapsed_us != 0 || state->lap_number == 0)) { // Estado pausado ou zerado
+        ssd1306_blit_string(ssd, 0, LABEL_Y, &font_8, state->elapsed_us == 0 ? "Press A to start" : "Paused");
+        effect = state->elapsed_us == 0 ? SSD1306_FX_FADE : SSD1306_FX_BLINK;
+    } else if (state->lap_number) { // Última volta (contando, ou recuperada da flash ao ligar)
+        char lap_str[32]; // "Lap " + 10 dígitos + " " + 6 dígitos + ":ss.cc" + terminador = 28
+        uint32_t cs = state->lap_ms / 10;
+        snprintf(lap_str, sizeof(lap_str), "Lap %lu %lu:%02lu.%02lu", (unsigned long)state->lap_number, (unsigned long)(cs / 6000),
+                (unsigned long)(cs / 100 % 60), (unsigned long)(cs % 100));
+        ssd1306_blit_string(ssd, 0, LABEL_Y, &font_8, lap_str);
+        if (!state->running) {
+            effect = SSD1306_FX_FADE;
+        }
+    } else if (state->hires && t.hour > 0) { // As horas saem do formato de centésimos
+        char hour_str[16];
+        snprintf(hour_str, sizeof(hour_str), "+%dh", t.hour);
+        ssd1306_blit_string(ssd, 0, LABEL_Y, &font_8, hour_str);
+    }
+
+    if (effect != ssd1306_fx_active(&oled_fx)) {
+        switch (effect) {
+        case SSD1306_FX_INVERT:
+            ssd1306_fx_invert(&oled_fx, FX_INVERT_PERIOD_MS);
+            break;
+        case SSD1306_FX_BLINK:
+            ssd1306_fx_blink(&oled_fx, FX_BLINK_PERIOD_MS);
+            break;
+        case SSD1306_FX_FADE:
+            ssd1306_fx_fade(&oled_fx, ssd1306_fx_default_contrast, FX_FADE_MIN_CONTRAST, FX_FADE_MS, true);
+            break;
+        default:
+            ssd1306_fx_stop(&oled_fx);
+            break;
+        }
+    }
+
+    // Atualiza os LEDs WS2812 com valores binários, com transição suave; zerado, apaga todos
+    if (state->running || (state->elapsed_us == 0 && !state->reset_prompt)) {
+        binaryToLed(t.hour, t.minute, t.second);
+        led_comp_submit(leds, LED_FADE_MS);
+    }
+
+    if (!render_on_display_async(&oled, ssd)) { // Envia ao OLED apenas o que mudou, em segundo plano
+        busy |= RENDER_OLED_BUSY;
+    }
+    return busy;
+}
+
+/**
+ * Retrato do estado atual do cronômetro
+ * @return: Estado a ser exibido
+ */
+display_state_t display_state_now() {
+    display_state_t state = {
+        .elapsed_us = stopwatch_elapsed_us(&stopwatch, time_us_64()),
+        .running = stopwatch.running,
+        .reset_prompt = is_reset_prompt,
+        .hires = is_hires,
+        .lap_number = laps.count,
+        .lap_ms = laps_lap_ms(&laps, laps.count)
+    };
+    return state;
+}
+
+#if CHRONO_DUAL_CORE
+// Modo de dois núcleos: o núcleo 0 publica retratos do estado por um seqlock e avisa o núcleo 1
+// pela FIFO entre núcleos; o núcleo 1 compõe e envia os quadros no seu próprio ritmo, sempre a
+// partir do retrato mais recente (retratos intermediários são descartados, nunca enfileirados)
+static display_state_t published_state;
+static volatile uint32_t published_seq = 0; // Ímpar enquanto o retrato está sendo escrito
+
+/**
+ * Publica o retrato atual para o núcleo de renderização (núcleo 0)
+ */
+void publish_display_state() {
+    display_state_t state = display_state_now();
+
+    published_seq++;
+    __dmb();
+    published_state = state;
+    __dmb();
+    published_seq++;
+
+    // Aviso sem bloqueio: com a FIFO cheia o núcleo 1 já tem avisos pendentes
+    if (multicore_fifo_wready()) {
+        multicore_fifo_push_blocking(published_seq);
+    }
+}
+
+/**
+ * Lê o retrato mais recente de forma consistente (núcleo 1)
+ * @return: Retrato publicado
+ */
+display_state_t read_display_state() {
+    display_state_t state;
+    uint32_t seq;
+    do {
+        seq = published_seq;
+        __dmb();
+        state = published_state;
+        __dmb();
+    } while ((seq & 1) || seq != published_seq);
+    return state;
+}
+
+// Pedido de estacionamento do núcleo 1 durante operações na flash, pela mesma FIFO dos avisos.
+// O multicore_lockout do SDK tomaria a interrupção da FIFO e consumiria os avisos; este valor é
+// ímpar e nunca se confunde com uma sequência publicada (sempre par)
+#define CORE1_PARK_REQUEST 0xF1A5F1A5u
+static volatile bool core1_parked = false;
+static volatile bool core1_release = false;
+
+/**
+ * Núcleo 1 aguarda, executando da RAM e sem interrupções, até a flash voltar a ser legível
+ */
+static void __not_in_flash_func(core1_park)(void) {
+    uint32_t status = save_and_disable_interrupts();
+    core1_parked = true;
+    while (!core1_release) {
+        tight_loop_contents();
+    }
+    core1_parked = false;
+    restore_interrupts(status);
+}
+
+/**
+ * Estaciona o núcleo 1 antes de apagar ou gravar a flash (núcleo 0)
+ */
+void core1_lockout_begin() {
+    core1_release = false;
+    multicore_fifo_push_blocking(CORE1_PARK_REQUEST);
+    while (!core1_parked) {
+        tight_loop_contents();
+    }
+}
+
+/**
+ * Libera o núcleo 1 após a operação na flash (núcleo 0)
+ */
+void core1_lockout_end() {
+    core1_release = true;
+    while (core1_parked) {
+        tight_loop_contents();
+    }
+}
+
+// OLED sem quadro em envio, publicado pelo núcleo 1 (dono do painel) para o núcleo 0, que nunca
+// consulta o driver: ssd1306_dma_busy pode abortar o DMA e recuperar o barramento
+#define OLED_CHECK_US 20000 // Com um quadro em envio, o núcleo 1 confere falhas e o fim a este intervalo
+static volatile bool oled_idle = true;
+
+/**
+ * Fim de um quadro via DMA, na interrupção do núcleo 1
+ * @param panel: Display que terminou o quadro
+ */
+void on_oled_frame_done(ssd1306_t *panel) {
+    oled_idle = panel->dma_active < 0;
+}
+
+/**
+ * Confere falhas do envio e publica se o OLED está livre (núcleo 1). A interrupção de fim de
+ * quadro corre neste mesmo núcleo, então desligá-la aqui basta para a leitura ser coerente
+ */
+static void oled_publish_idle() {
+    ssd1306_dma_busy(&oled);
+    uint32_t status = save_and_disable_interrupts();
+    oled_idle = oled.dma_active < 0;
+    restore_interrupts(status);
+}
+
+/**
+ * Indica ao núcleo 0 se o OLED tem um quadro em envio (a flash espera por ele)
+ * @return: true com um quadro em envio
+ */
+bool oled_busy() {
+    return !oled_idle;
+}
+
+/**
+ * Laço do núcleo 1: aguarda avisos, descarta os acumulados e desenha o retrato mais recente.
+ * Os passos dos efeitos do painel também correm aqui, pois este núcleo é o dono do i2c. O DMA é
+ * configurado aqui para que a interrupção de fim de quadro fique neste núcleo: a troca entre os
+ * quadros ativo e pendente em render_on_display_async só é protegida contra ela no próprio núcleo
+ */
+void render_core_entry() {
+    ssd1306_dma_init(&oled);
+    ssd1306_dma_set_callback(&oled, on_oled_frame_done);
+
+    // Abertura: este núcleo já é o dono do i2c. Avisos que chegarem enquanto isso ficam na FIFO e
+    // viram o primeiro quadro do cronômetro
+    while (splash_advance(time_us_64())) {
+        oled_idle = false;
+        while (!render_on_display_async(&oled, ssd)) {
+            ssd1306_dma_wait(&oled);
+        }
+        oled_publish_idle();
+        sleep_until(from_us_since_boot(splash_next_us));
+    }
+
+    uint64_t effect_deadline = 0;
+    while (true) {
+        uint32_t seq = 0;
+        bool doorbell = true;
+        uint64_t deadline = effect_deadline;
+        if (!oled_idle) {
+            uint64_t check = time_us_64() + OLED_CHECK_US;
+            deadline = deadline && deadline < check ? deadline : check;
+        }
+        if (deadline) {
+            uint64_t now = time_us_64();
+            doorbell = multicore_fifo_pop_timeout_us(deadline > now ? deadline - now : 0, &seq);
+        } else {
+            seq = multicore_fifo_pop_blocking();
+        }
+
+        // Avisos acumulados viram um único quadro; pedidos de estacionamento são atendidos na hora
+        bool render = doorbell && seq != CORE1_PARK_REQUEST;
+        if (doorbell && !render) {
+            core1_park();
+        }
+        while (doorbell && multicore_fifo_rvalid()) {
+            if (multicore_fifo_pop_blocking() == CORE1_PARK_REQUEST) {
+                core1_park();
+            } else {
+                render = true;
+            }
+        }
+
+        if (render) {
+            oled_idle = false; // Antes de enviar: o núcleo 0 não pode ver o OLED livre durante o quadro
+            display_state_t state = read_display_state();
+            int busy;
+            while ((busy = render_frame(&state)) != 0) {
+                // Ocupado com o quadro anterior: espera aqui sem afetar o núcleo 0 e redesenha o mais recente
+                if (busy & RENDER_OLED_BUSY) {
+                    ssd1306_dma_wait(&oled);
+                }
+                state = read_display_state();
+            }
+        }
+        effect_deadline = ssd1306_fx_process(&oled_fx, time_us_64());
+        oled_publish_idle();
+    }
+}
+
+void on_render() {
+    publish_display_state();
+}
+#else
+// O envio ao OLED foi recusado (quadros ocupados) e deve ser refeito ao fim do envio atual
+static volatile bool render_retry = false;
+
+void on_oled_frame_done(ssd1306_t *ssd) {
+    if (render_retry) {
+        render_retry = false;
+        events_post(EVENT_RENDER);
+    }
+}
+
+// Próximo passo agendado dos efeitos do painel
+static alarm_id_t effect_alarm = 0;
+
+/**
+ * Executa o passo vencido do efeito do painel e agenda o próximo
+ */
+void on_effect() {
+    uint64_t now = time_us_64();
+    uint64_t deadline = ssd1306_fx_process(&oled_fx, now);
+    events_cancel(effect_alarm);
+    effect_alarm = 0;
+    if (deadline) {
+        effect_alarm = events_post_in_us(EVENT_EFFECT, deadline > now ? deadline - now : 0);
+    }
+}
+
+/**
+ * Indica se o OLED tem um quadro em envio (a flash espera por ele)
+ * @return: true com um quadro em envio
+ */
+bool oled_busy() {
+    return ssd1306_dma_busy(&oled);
+}
+
+/**
+ * Marca o quadro do OLED para ser reenviado ao fim do envio atual
+ */
+void render_retry_after_flush() {
+    render_retry = true;
+    if (!ssd1306_dma_busy(&oled)) { // O envio em andamento terminou antes da marcação
+        render_retry = false;
+        events_post(EVENT_RENDER);
+    }
+}
+
+/**
+ * Passo da abertura: o próximo quadro é agendado pelo seu próprio alarme; pedidos de quadro
+ * antecipados (tique, botões) só reenviam o que ainda não saiu
+ */
+void render_splash() {
+    uint64_t now = time_us_64();
+    uint64_t due = splash_next_us;
+    if (!splash_advance(now)) {
+        events_post(EVENT_RENDER); // Primeira tela do cronômetro
+        return;
+    }
+    if (splash_next_us != due) {
+        events_post_in_us(EVENT_RENDER, splash_next_us > now ? splash_next_us - now : 0);
+    }
+    if (!render_on_display_async(&oled, ssd)) {
+        render_retry_after_flush();
+    }
+}
+
+/**
+ * Redesenha o OLED e atualiza os alvos dos LEDs, reagendando o OLED se ainda estava ocupado
+ */
+void on_render() {
+    if (splash_playing) {
+        render_splash();
+        return;
+    }
+
+    display_state_t state = display_state_now();
+    int busy = render_frame(&state);
+
+    if (busy & RENDER_OLED_BUSY) {
+        render_retry_after_flush();
+    }
+    events_post(EVENT_EFFECT); // O quadro pode ter trocado o efeito do painel
+}
+#endif
+
+// Log de voltas nos últimos setores da flash, longe do programa
+#define LAP_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - lap_log_sectors * lap_log_sector_size)
+#define STORAGE_RETRY_US 20000 // Nova tentativa enquanto o OLED termina um envio
+#define STORAGE_INPUT_GUARD_US 1500000 // Botões parados há pelo menos este tempo antes de mexer na flash
+
+// Enquanto a flash é apagada (~45 ms por setor) ou gravada (~1 ms por página) nada pode executar
+// dela: as interrupções ficam desligadas e, com dois núcleos, o núcleo 1 fica estacionado na RAM
+static void lap_flash_erase(uint32_t offset) {
+#if CHRONO_DUAL_CORE
+    core1_lockout_begin();
+#endif
+    uint32_t status = save_and_disable_interrupts();
+    flash_range_erase(LAP_LOG_OFFSET + offset, lap_log_sector_size);
+    restore_interrupts(status);
+#if CHRONO_DUAL_CORE
+    core1_lockout_end();
+#endif
+}
+
+static void lap_flash_program(uint32_t offset, const uint8_t *page) {
+#if CHRONO_DUAL_CORE
+    core1_lockout_begin();
+#endif
+    uint32_t status = save_and_disable_interrupts();
+    flash_range_program(LAP_LOG_OFFSET + offset, page, lap_log_page_size);
+    restore_interrupts(status);
+#if CHRONO_DUAL_CORE
+    core1_lockout_end();
+#endif
+}
+
+static alarm_id_t storage_alarm = 0;
+
+/**
+ * Leva as voltas pendentes à flash, uma operação por evento. Só roda com o cronômetro parado e o
+ * OLED livre, para nunca atrasar tiques nem quadros; contando, o trabalho espera a próxima pausa.
+ * Com as interrupções desligadas durante um apagamento, uma borda de início seria registrada até
+ * ~45 ms depois: cada passo exige os botões parados há STORAGE_INPUT_GUARD_US e nenhuma borda na
+ * fila, conferidos de novo antes do passo seguinte
+ */
+void on_storage() {
+    events_cancel(storage_alarm);
+    storage_alarm = 0;
+    if (stopwatch.running || !lap_log_dirty(&laps)) {
+        return;
+    }
+    uint64_t now = time_us_64();
+    uint64_t quiet_at = input_last_edge_us() + STORAGE_INPUT_GUARD_US;
+    if (input_pending() || oled_busy()) {
+        storage_alarm = events_post_in_us(EVENT_STORAGE, STORAGE_RETRY_US);
+        return;
+    }
+    if (now < quiet_at) {
+        storage_alarm = events_post_in_us(EVENT_STORAGE, quiet_at - now);
+        return;
+    }
+    if (lap_log_step(&lap_log, &laps)) {
+        events_post(EVENT_STORAGE); // Entradas e quadros pendentes são despachados antes do próximo passo
+    }
 }
 
 /**
  * Função principal: Cronômetro com início/pausa via botão A, reset via botão B com LEDs apagados e sons nos buzzers
  */
 int main() {
-    int second = 0, minute = 0, hour = 0; // Contadores de tempo
-    uint64_t last_time = 0; // Último tempo registrado em milissegundos
-    uint64_t last_toggle_time = 0; // Último tempo de alternância do texto no OLED
-    bool is_running = false; // Estado do cronômetro: false = parado, true = rodando
-    bool display_toggle = false; // Controla a alternância do texto no OLED
-    bool is_reset_prompt = false; // Estado para exibir mensagem de reset
-
     stdio_init_all(); // Inicializa comunicação serial via USB
 
     // Inicializa I2C para o OLED
-    i2c_init(i2c1, ssd1306_i2c_clock * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
+    i2c_bus_init(&oled_bus, i2c1, I2C_SDA, I2C_SCL);
 
-    // Inicializa o display OLED SSD1306
-    ssd1306_init();
+    // Inicializa o display OLED SSD1306 na maior velocidade que ele aceitar (até 1 MHz). Sem
+    // resposta, o cronômetro segue funcionando com LEDs e buzzers, a 100 kHz
+    if (!ssd1306_attach(&oled, &oled_bus, ssd1306_i2c_address, ssd1306_height, false)) {
+        printf("OLED nao respondeu no i2c\n");
+    }
+    ssd1306_init(&oled);
+    ssd1306_fx_init(&oled_fx, &oled);
 
     // Define a área de renderização do OLED (128x64 pixels, 8 páginas)
     struct render_area frame_area = {
@@ -188,120 +1029,59 @@ int main() {
     };
     calculate_render_area_buffer_length(&frame_area);
 
-    // Buffer para o OLED
-    uint8_t ssd[ssd1306_buffer_length];
     memset(ssd, 0, ssd1306_buffer_length);
+    render_on_display(&oled, ssd, &frame_area); // Limpa o display e sincroniza a cópia sombra do driver
+#if !CHRONO_DUAL_CORE
+    ssd1306_dma_init(&oled); // A partir daqui os quadros seguem via DMA, sem bloquear
+    ssd1306_dma_set_callback(&oled, on_oled_frame_done);
+#endif // Com dois núcleos, o DMA e sua interrupção são configurados pelo núcleo 1 (render_core_entry)
+
+    // Recupera as voltas da última sessão gravada na flash
+    lap_log_mount(&lap_log, (const uint8_t *)(XIP_BASE + LAP_LOG_OFFSET), lap_flash_erase, lap_flash_program, &laps);
 
     npInit(LED_PIN); // Inicializa os LEDs WS2812
+    led_comp_init(LED_COUNT, LED_REFRESH_HZ, npWriteAsync); // Gama, brilho e pontilhamento a 400 Hz, por temporizador
+    led_comp_set_brightness(LED_BRIGHTNESS);
 
-    // Configura o botão A (GP5) como entrada com pull-up
-    gpio_init(BUTTON_A);
-    gpio_set_dir(BUTTON_A, GPIO_IN);
-    gpio_pull_up(BUTTON_A);
-
-    // Configura o botão B (GP6) como entrada com pull-up
-    gpio_init(BUTTON_B);
-    gpio_set_dir(BUTTON_B, GPIO_IN);
-    gpio_pull_up(BUTTON_B);
-
-    // Configura PWM para buzzer 1 (1000 Hz)
-    gpio_set_function(BUZZER1_PIN, GPIO_FUNC_PWM);
-    uint slice_num1 = pwm_gpio_to_slice_num(BUZZER1_PIN);
-    pwm_set_wrap(slice_num1, 2499); // Frequência base ajustada
-    pwm_set_clkdiv(slice_num1, 50.0f); // Divide para ~1000 Hz (125MHz / (2500 * 50) = 1000 Hz)
-    pwm_set_enabled(slice_num1, true);
-
-    // Configura PWM para buzzer 2 (500 Hz)
-    gpio_set_function(BUZZER2_PIN, GPIO_FUNC_PWM);
-    uint slice_num2 = pwm_gpio_to_slice_num(BUZZER2_PIN);
-    pwm_set_wrap(slice_num2, 4999); // Frequência base ajustada
-    pwm_set_clkdiv(slice_num2, 50.0f); // Divide para ~500 Hz (125MHz / (5000 * 50) = 500 Hz)
-    pwm_set_enabled(slice_num2, true);
+    // Comandos do host pelo protocolo binário na mesma USB CDC da stdio
+    host_link_init(on_host_rx);
 
-    while (true) {
-        // Verifica os botões
-        if (!gpio_get(BUTTON_A) && !is_reset_prompt) { // Botão A inicia/pausa
-            is_running = !is_running;
-            buzzer1_beep(100); // Som de 1000 Hz por 100 ms
-            sleep_ms(200); // Debounce
-        } else if (!gpio_get(BUTTON_B) && !is_reset_prompt) { // Botão B inicia prompt de reset
-            is_reset_prompt = true;
-            is_running = false;
-            buzzer2_beep(100); // Som de 500 Hz por 100 ms
-            sleep_ms(200); // Debounce
-        } else if (is_reset_prompt) { // Estado de espera por confirmação de reset
-            if (!gpio_get(BUTTON_B)) { // Botão B confirma reset
-                second = 0;
-                minute = 0;
-                hour = 0;
-                npClear(); // Apaga todos os LEDs
-                npWrite(); // Atualiza os LEDs para refletir o estado apagado
-                buzzer2_beep(100); // Som de 500 Hz por 100 ms
-                is_reset_prompt = false;
-                sleep_ms(200); // Debounce
-            } else if (!gpio_get(BUTTON_A)) { // Botão A cancela reset e continua
-                is_reset_prompt = false;
-                is_running = true;
-                buzzer1_beep(100); // Som de 1000 Hz por 100 ms
-                sleep_ms(200); // Debounce
-            }
-        }
+    // Configura os botões A (GP5) e B (GP6) com pull-up e captura de bordas por interrupção
+    input_init(on_input_edge);
+    button_a = input_add_button(BUTTON_A);
+    button_b = input_add_button(BUTTON_B);
 
-        uint64_t current_time = time_us_64() / 1000; // Tempo atual em milissegundos
+    // Configura PWM dos buzzers; divisor e wrap são reprogramados a cada nota
+    buzzer_init(&buzzer1, BUZZER1_PIN);
+    buzzer_init(&buzzer2, BUZZER2_PIN);
 
-        if (!is_running && !is_reset_prompt) { // Estado pausado normal
-            if (current_time - last_toggle_time >= 1000) { // Alterna texto a cada 1s
-                display_toggle = !display_toggle;
-                last_toggle_time = current_time;
-            }
-            memset(ssd, 0, ssd1306_buffer_length); // Limpa o buffer do OLED
-            if (display_toggle) {
-                char time_str[9];
-                sprintf(time_str, "%02d:%02d:%02d", hour, minute, second);
-                ssd1306_draw_string(ssd, 0, 0, time_str);
-            } else {
-                ssd1306_draw_string(ssd, 0, 0, (second == 0 && minute == 0 && hour == 0) ? "Press A to start" : "Paused");
-            }
-            render_on_display(ssd, &frame_area); // Atualiza o OLED
-            // LEDs permanecem como estavam
-        } else if (is_reset_prompt) { // Estado de espera por confirmação de reset
-            memset(ssd, 0, ssd1306_buffer_length);
-            ssd1306_draw_string(ssd, 0, 0, "Press B to reset"); // Mensagem de reset
-            render_on_display(ssd, &frame_area);
-            // LEDs permanecem como estavam até confirmação
-        } else { // Estado rodando
-            if (current_time - last_time >= 1000) { // Passou 1 segundo?
-                last_time = current_time;
-                second++;
-                if (second >= 60) {
-                    second = 0;
-                    minute++;
-                    if (minute >= 60) {
-                        minute = 0;
-                        hour++;
-                        if (hour >= 32) {
-                            second = 0;
-                            minute = 0;
-                            hour = 0;
-                        }
-                    }
-                }
-            }
-            // Formata e exibe o tempo no OLED
-            char time_str[9];
-            sprintf(time_str, "%02d:%02d:%02d", hour, minute, second);
-            memset(ssd, 0, ssd1306_buffer_length);
-            ssd1306_draw_string(ssd, 0, 0, time_str);
-            render_on_display(ssd, &frame_area);
-
-            // Atualiza os LEDs WS2812 com valores binários
-            npClear();
-            secToLed(second);
-            minToLed(minute);
-            hourToLed(hour);
-            npWrite();
-        }
-        sleep_ms(10); // Pequeno delay para evitar sobrecarga da CPU
-    }
+    // Eventos: bordas dos botões por interrupção, tique por alarme de hardware
+    events_set_handler(EVENT_INPUT, on_input);
+    events_set_handler(EVENT_HOST, on_host);
+    events_set_handler(EVENT_TICK, on_tick);
+    events_set_handler(EVENT_RENDER, on_render);
+    events_set_handler(EVENT_STORAGE, on_storage);
+#if !CHRONO_DUAL_CORE
+    events_set_handler(EVENT_EFFECT, on_effect);
+#endif
+#if CHRONO_PERF
+    perf_watch_bus(&oled_bus);
+    perf_watch_laps(&laps, &lap_log);
+    events_set_handler(EVENT_TELEMETRY, perf_report);
+    events_start_tick(perf_report_period_ms, EVENT_TELEMETRY); // Relatório periódico pela USB
+#endif
+    stopwatch_reset(&stopwatch, time_us_64());
+
+    // Abertura a partir de agora; o primeiro quadro cobre a tela inteira
+    ssd1306_anim_start(&splash, &splash_anim, false);
+    splash_playing = true;
+    splash_next_us = time_us_64();
+
+#if CHRONO_DUAL_CORE
+    multicore_launch_core1(render_core_entry); // Núcleo 1 passa a compor e enviar os quadros
+#endif
+
+    events_post(EVENT_RENDER); // Abertura e depois a primeira tela; o tique passa a redesenhar a cada segundo ao iniciar
+    events_run(); // Trata eventos e dorme entre eles; não retorna
     return 0;
-}
\ No newline at end of file
+}
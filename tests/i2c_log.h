@@ -0,0 +1,46 @@
+#include <string.h>
+#include "pico_host.h"
+
+#ifndef i2c_log_inc_h
+#define i2c_log_inc_h
+
+// Dispositivo i2c de teste que registra cada transação de escrita recebida, com o instante
+#define i2c_log_max_transactions 64
+#define i2c_log_max_length 1100
+
+typedef struct {
+    uint8_t data[i2c_log_max_length];
+    size_t length;
+    uint64_t time_us;
+} i2c_log_transaction_t;
+
+typedef struct {
+    host_i2c_device_t device;
+    i2c_log_transaction_t transactions[i2c_log_max_transactions];
+    int count;
+} i2c_log_t;
+
+static bool i2c_log_write(host_i2c_device_t *device, const uint8_t *data, size_t length, uint64_t time_us) {
+    i2c_log_t *log = device->context;
+    if (log->count < i2c_log_max_transactions && length <= i2c_log_max_length) {
+        i2c_log_transaction_t *transaction = &log->transactions[log->count++];
+        memcpy(transaction->data, data, length);
+        transaction->length = length;
+        transaction->time_us = time_us;
+    }
+    return true;
+}
+
+static inline void i2c_log_attach(i2c_log_t *log, i2c_inst_t *i2c, uint8_t address) {
+    memset(log, 0, sizeof(*log));
+    log->device.address = address;
+    log->device.write = i2c_log_write;
+    log->device.context = log;
+    host_i2c_attach(i2c, &log->device);
+}
+
+static inline void i2c_log_clear(i2c_log_t *log) {
+    log->count = 0;
+}
+
+#endif
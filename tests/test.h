@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <string.h>
+
+#ifndef test_inc_h
+#define test_inc_h
+
+// Verificações dos testes de host: cada falha é impressa com arquivo e linha e o teste segue;
+// test_summary dá o código de saída (0 sem falhas) para o ctest
+static int test_checks = 0;
+static int test_failures = 0;
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        test_checks++;                                                                     \
+        if (!(condition)) {                                                                \
+            test_failures++;                                                               \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #condition);        \
+        }                                                                                  \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                         \
+    do {                                                                                   \
+        long long test_actual = (long long)(actual), test_expected = (long long)(expected); \
+        test_checks++;                                                                     \
+        if (test_actual != test_expected) {                                                \
+            test_failures++;                                                               \
+            fprintf(stderr, "%s:%d: %s = %lld, esperado %lld\n", __FILE__, __LINE__,       \
+                    #actual, test_actual, test_expected);                                  \
+        }                                                                                  \
+    } while (0)
+
+#define CHECK_MEM(actual, expected, length)                                                \
+    do {                                                                                   \
+        test_checks++;                                                                     \
+        if (memcmp((actual), (expected), (length)) != 0) {                                 \
+            test_failures++;                                                               \
+            fprintf(stderr, "%s:%d: %s difere de %s\n", __FILE__, __LINE__, #actual,       \
+                    #expected);                                                            \
+        }                                                                                  \
+    } while (0)
+
+static inline int test_summary(const char *name) {
+    printf("%s: %d verificações, %d falhas\n", name, test_checks, test_failures);
+    return test_failures ? 1 : 0;
+}
+
+#endif
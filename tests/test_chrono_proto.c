@@ -0,0 +1,262 @@
+// Protocolo do host (inc/chrono_proto.c) e o enlace pela USB CDC emulada (inc/host_link.c):
+// quadros montados e relidos, recusa por CRC, ressincronização depois de lixo (inclusive um
+// sincronismo falso que engoliria os quadros seguintes) e, em laço pela USB, NAK para comandos
+// malformados e resposta de mesma sequência para os válidos
+#include "pico/stdlib.h"
+#include "pico_host.h"
+#include "chrono_proto.h"
+#include "host_link.h"
+#include "test.h"
+
+#define max_frames 64
+
+static chrono_proto_frame_t frames[max_frames];
+static int frame_count;
+
+static void collect(const chrono_proto_frame_t *frame) {
+    if (frame_count < max_frames) {
+        frames[frame_count] = *frame;
+    }
+    frame_count++;
+}
+
+// Passa os bytes pelo leitor, recolhendo todos os quadros (também os relidos por chrono_proto_next)
+static void feed(chrono_proto_parser_t *parser, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        for (bool found = chrono_proto_parse(parser, data[i]); found; found = chrono_proto_next(parser)) {
+            collect(&parser->frame);
+        }
+    }
+}
+
+static bool same_frame(const chrono_proto_frame_t *frame, uint8_t type, uint8_t seq, const uint8_t *payload,
+                       uint8_t length) {
+    return frame->type == type && frame->seq == seq && frame->length == length &&
+           (length == 0 || memcmp(frame->payload, payload, length) == 0);
+}
+
+// Todos os tamanhos de carga, montados e relidos; o registro de estado nos dois sentidos
+static void test_encode_parse(void) {
+    chrono_proto_parser_t parser;
+    chrono_proto_parser_init(&parser);
+    frame_count = 0;
+    uint8_t payload[chrono_proto_max_payload];
+    uint8_t out[chrono_proto_frame_size(chrono_proto_max_payload)];
+    for (int length = 0; length <= chrono_proto_max_payload; length++) {
+        for (int i = 0; i < length; i++) {
+            payload[i] = (uint8_t)(length * 31 + i * 7);
+        }
+        size_t size = chrono_proto_encode(out, CHRONO_CMD_SUBSCRIBE, (uint8_t)(200 + length), payload, length);
+        CHECK_EQ(size, chrono_proto_frame_size(length));
+        feed(&parser, out, size);
+        CHECK_EQ(frame_count, length + 1);
+        CHECK(same_frame(&frames[length], CHRONO_CMD_SUBSCRIBE, (uint8_t)(200 + length), payload, length));
+    }
+    CHECK_EQ(parser.frames, chrono_proto_max_payload + 1);
+    CHECK_EQ(parser.bad, 0);
+
+    const chrono_proto_state_t state = {0x89ABCDEF, 3723004, 513, CHRONO_STATE_RUNNING | CHRONO_STATE_HIRES,
+                                        CHRONO_CMD_LAP};
+    uint8_t encoded[chrono_proto_state_frame];
+    CHECK_EQ(chrono_proto_encode_state(encoded, 9, &state), chrono_proto_state_frame);
+    frame_count = 0;
+    feed(&parser, encoded, sizeof(encoded));
+    chrono_proto_state_t decoded;
+    CHECK_EQ(frame_count, 1);
+    CHECK(chrono_proto_decode_state(&frames[0], &decoded));
+    CHECK_EQ(frames[0].seq, 9);
+    CHECK_EQ(decoded.time_us, state.time_us);
+    CHECK_EQ(decoded.elapsed_ms, state.elapsed_ms);
+    CHECK_EQ(decoded.laps, state.laps);
+    CHECK_EQ(decoded.flags, state.flags);
+    CHECK_EQ(decoded.cause, state.cause);
+}
+
+// Cada bit de cada byte depois do sincronismo invertido: o quadro corrompido nunca é entregue.
+// O comando seguinte vai quatro vezes, como um host que repete sem resposta: um tamanho corrompido
+// para mais engole parte delas, e a releitura depois da recusa devolve todas
+static void test_crc_rejection(void) {
+    static const uint8_t payload[] = {0x10, 0x27, 0x00, 0x00};
+    uint8_t good[chrono_proto_frame_size(sizeof(payload))];
+    size_t size = chrono_proto_encode(good, CHRONO_CMD_SUBSCRIBE, 42, payload, sizeof(payload));
+    uint8_t next[chrono_proto_frame_size(0)];
+    chrono_proto_encode(next, CHRONO_CMD_QUERY, 43, NULL, 0);
+
+    int delivered_corrupt = 0, missed_next = 0, unnoticed = 0;
+    for (size_t byte = 1; byte < size; byte++) {
+        for (int bit = 0; bit < 8; bit++) {
+            chrono_proto_parser_t parser;
+            chrono_proto_parser_init(&parser);
+            uint8_t corrupt[sizeof(good)];
+            memcpy(corrupt, good, size);
+            corrupt[byte] ^= 1 << bit;
+            frame_count = 0;
+            feed(&parser, corrupt, size);
+            for (int repeat = 0; repeat < 4; repeat++) {
+                feed(&parser, next, sizeof(next));
+            }
+            for (int i = 0; i < frame_count && i < max_frames; i++) {
+                delivered_corrupt += !same_frame(&frames[i], CHRONO_CMD_QUERY, 43, NULL, 0);
+            }
+            missed_next += frame_count != 4;
+            unnoticed += parser.bad == 0;
+        }
+    }
+    CHECK_EQ(delivered_corrupt, 0);
+    CHECK_EQ(missed_next, 0);
+    CHECK_EQ(unnoticed, 0);
+}
+
+// Um sincronismo falso com tamanho 16 no lixo: os três quadros curtos seguintes cabem dentro da
+// carga que ele esperaria, e todos saem depois que o falso é recusado
+static void test_false_sync(void) {
+    chrono_proto_parser_t parser;
+    chrono_proto_parser_init(&parser);
+    uint8_t stream[4 + 3 * chrono_proto_frame_size(0) + 8];
+    size_t length = 0;
+    stream[length++] = chrono_proto_sync;
+    stream[length++] = 0x33;
+    stream[length++] = 0x44;
+    stream[length++] = chrono_proto_max_payload;
+    for (uint8_t seq = 1; seq <= 3; seq++) {
+        length += chrono_proto_encode(stream + length, CHRONO_CMD_QUERY, seq, NULL, 0);
+    }
+    frame_count = 0;
+    feed(&parser, stream, length);
+    CHECK_EQ(frame_count, 0); // Ainda lendo a carga do quadro falso
+    static const uint8_t tail[] = {0x00, 0x01, 0x02};
+    feed(&parser, tail, sizeof(tail)); // Completa os 16 bytes e o CRC: o falso é recusado
+    CHECK_EQ(frame_count, 3);
+    for (int i = 0; i < 3 && i < frame_count; i++) {
+        CHECK(same_frame(&frames[i], CHRONO_CMD_QUERY, i + 1, NULL, 0));
+    }
+    CHECK_EQ(parser.bad, 1);
+}
+
+// Lixo aleatório, rico em sincronismos e tamanhos pequenos, entre quadros válidos: todos os
+// quadros válidos saem, em ordem (lixo que por acaso forme um quadro válido não atrapalha)
+static void test_resync_after_garbage(void) {
+    static uint8_t stream[8192];
+    uint32_t seed = 99;
+    size_t length = 0;
+    int sent = 0;
+    while (length + 64 < sizeof(stream)) {
+        seed = seed * 1103515245u + 12345u;
+        int garbage = (seed >> 16) % 12;
+        for (int i = 0; i < garbage; i++) {
+            seed = seed * 1103515245u + 12345u;
+            uint8_t value = seed >> 24;
+            stream[length++] = value < 64 ? chrono_proto_sync : value < 160 ? value % 20 : value;
+        }
+        uint8_t payload[4] = {(uint8_t)sent, (uint8_t)(sent >> 8), 0x5A, 0xC3};
+        length += chrono_proto_encode(stream + length, CHRONO_CMD_SUBSCRIBE, (uint8_t)sent, payload, 4);
+        sent++;
+    }
+
+    chrono_proto_parser_t parser;
+    chrono_proto_parser_init(&parser);
+    int expected = 0;
+    for (size_t i = 0; i < length; i++) {
+        for (bool found = chrono_proto_parse(&parser, stream[i]); found; found = chrono_proto_next(&parser)) {
+            const chrono_proto_frame_t *frame = &parser.frame;
+            if (frame->type == CHRONO_CMD_SUBSCRIBE && frame->length == 4 && frame->payload[2] == 0x5A &&
+                frame->payload[3] == 0xC3 && (frame->payload[0] | frame->payload[1] << 8) == expected) {
+                expected++;
+            }
+        }
+    }
+    CHECK(sent > 500);
+    CHECK_EQ(expected, sent);
+    CHECK(parser.bad > 0);
+}
+
+// Laço pela USB emulada: o tratador faz o que on_host_command (main.c) faz com a validação,
+// respondendo NAK ao comando malformado e o estado, na mesma sequência, ao válido
+static chrono_proto_parser_t reply_parser;
+static int commands_applied;
+
+static void on_usb_output(const uint8_t *data, size_t length, void *context) {
+    feed(&reply_parser, data, length);
+}
+
+static void on_command(const chrono_proto_frame_t *frame) {
+    if (!chrono_proto_command_valid(frame)) {
+        uint8_t nak[chrono_proto_frame_size(1)];
+        host_link_send(nak, chrono_proto_encode(nak, CHRONO_MSG_NAK, frame->seq, &frame->type, 1));
+        return;
+    }
+    commands_applied++;
+    chrono_proto_state_t state = {time_us_32(), 0, 0, 0, frame->type};
+    uint8_t reply[chrono_proto_state_frame];
+    host_link_send(reply, chrono_proto_encode_state(reply, frame->seq, &state));
+}
+
+static bool rx_pending;
+
+static void on_rx(void) {
+    rx_pending = true;
+}
+
+static void test_loopback_nak(void) {
+    static const uint8_t period[] = {0xE8, 0x03, 0x00, 0x00};
+    static const uint8_t one[] = {0x01};
+    uint8_t stream[256];
+    size_t length = 0;
+    length += chrono_proto_encode(stream + length, CHRONO_CMD_QUERY, 1, NULL, 0);
+    length += chrono_proto_encode(stream + length, CHRONO_CMD_START, 2, one, 1);         // Carga inesperada
+    length += chrono_proto_encode(stream + length, CHRONO_CMD_SUBSCRIBE, 3, period, 2);  // Carga curta
+    length += chrono_proto_encode(stream + length, 0x7F, 4, NULL, 0);                    // Tipo desconhecido
+    length += chrono_proto_encode(stream + length, CHRONO_MSG_STATE, 5, NULL, 0);        // Mensagem da placa
+    size_t corrupt = length;
+    length += chrono_proto_encode(stream + length, CHRONO_CMD_RESET, 6, NULL, 0);
+    stream[corrupt + 2] ^= 0x10;                                                         // CRC não confere: sem resposta
+    stream[length++] = chrono_proto_sync;                                                // Lixo
+    length += chrono_proto_encode(stream + length, CHRONO_CMD_SUBSCRIBE, 7, period, 4);
+    length += chrono_proto_encode(stream + length, CHRONO_CMD_PAUSE, 8, NULL, 0);
+
+    chrono_proto_parser_init(&reply_parser);
+    host_usb_set_output(on_usb_output, NULL);
+    host_link_init(on_rx);
+    frame_count = 0;
+    rx_pending = false;
+    host_usb_receive(stream, length);
+    CHECK(rx_pending);
+    host_link_process(on_command);
+    host_usb_set_output(NULL, NULL);
+
+    static const struct {
+        uint8_t type, seq, cause;
+    } replies[] = {
+        {CHRONO_MSG_STATE, 1, CHRONO_CMD_QUERY}, {CHRONO_MSG_NAK, 2, CHRONO_CMD_START},
+        {CHRONO_MSG_NAK, 3, CHRONO_CMD_SUBSCRIBE}, {CHRONO_MSG_NAK, 4, 0x7F},
+        {CHRONO_MSG_NAK, 5, CHRONO_MSG_STATE}, {CHRONO_MSG_STATE, 7, CHRONO_CMD_SUBSCRIBE},
+        {CHRONO_MSG_STATE, 8, CHRONO_CMD_PAUSE},
+    };
+    CHECK_EQ(frame_count, count_of(replies));
+    for (uint i = 0; i < count_of(replies) && i < (uint)frame_count; i++) {
+        CHECK_EQ(frames[i].type, replies[i].type);
+        CHECK_EQ(frames[i].seq, replies[i].seq);
+        if (replies[i].type == CHRONO_MSG_NAK) {
+            CHECK_EQ(frames[i].length, 1);
+            CHECK_EQ(frames[i].payload[0], replies[i].cause);
+        } else {
+            chrono_proto_state_t state;
+            CHECK(chrono_proto_decode_state(&frames[i], &state));
+            CHECK_EQ(state.cause, replies[i].cause);
+        }
+    }
+    CHECK_EQ(commands_applied, 3);
+    CHECK_EQ(host_link_get_stats()->rx_frames, 7);
+    CHECK(host_link_get_stats()->rx_bad >= 1);
+    CHECK_EQ(host_link_get_stats()->tx_frames, count_of(replies));
+    CHECK_EQ(reply_parser.bad, 0);
+}
+
+int main(void) {
+    test_encode_parse();
+    test_crc_rejection();
+    test_false_sync();
+    test_resync_after_garbage();
+    test_loopback_nak();
+    return test_summary("test_chrono_proto");
+}
@@ -0,0 +1,181 @@
+// Escalonador de eventos (events_post_in_us / events_cancel) no relógio virtual: despacho na
+// ordem dos prazos e no instante exato, prioridade entre eventos simultâneos e cancelamento
+#include "events.h"
+#include "pico_host.h"
+#include "test.h"
+
+#define max_dispatches 32
+
+typedef struct {
+    event_t event;
+    uint64_t time_us;
+} dispatch_t;
+
+static dispatch_t dispatches[max_dispatches];
+static int dispatch_count;
+static uint64_t start_us;
+
+static void record(event_t event) {
+    if (dispatch_count < max_dispatches) {
+        dispatches[dispatch_count].event = event;
+        dispatches[dispatch_count].time_us = time_us_64() - start_us;
+    }
+    dispatch_count++;
+}
+
+static void on_input(void) { record(EVENT_INPUT); }
+static void on_host(void) { record(EVENT_HOST); }
+static void on_tick(void) { record(EVENT_TICK); }
+static void on_render(void) { record(EVENT_RENDER); }
+static void on_effect(void) { record(EVENT_EFFECT); }
+static void on_storage(void) { record(EVENT_STORAGE); }
+static void on_telemetry(void) { record(EVENT_TELEMETRY); }
+
+static void (*scenario)(void);
+
+// Cada cenário agenda seus eventos e entra no laço de despacho, interrompido por host_run
+static void scenario_entry(void) {
+    scenario();
+    events_run();
+}
+
+static void run_scenario(void (*setup)(void), uint64_t duration_us) {
+    dispatch_count = 0;
+    start_us = time_us_64();
+    scenario = setup;
+    CHECK(host_run(scenario_entry, start_us + duration_us));
+}
+
+static void check_dispatch(int index, event_t event, uint64_t time_us) {
+    CHECK(index < dispatch_count);
+    if (index < dispatch_count) {
+        CHECK_EQ(dispatches[index].event, event);
+        CHECK_EQ(dispatches[index].time_us, time_us);
+    }
+}
+
+// Agendados fora de ordem: despachados na ordem dos prazos, cada um no seu instante
+static void schedule_out_of_order(void) {
+    events_post_in_us(EVENT_RENDER, 3000);
+    events_post_in_us(EVENT_TICK, 1000);
+    events_post_in_us(EVENT_STORAGE, 2000);
+}
+
+static void test_deadline_order(void) {
+    run_scenario(schedule_out_of_order, 5000);
+    CHECK_EQ(dispatch_count, 3);
+    check_dispatch(0, EVENT_TICK, 1000);
+    check_dispatch(1, EVENT_STORAGE, 2000);
+    check_dispatch(2, EVENT_RENDER, 3000);
+}
+
+// Mesmo prazo: um único despacho, na ordem de prioridade dos eventos e não na de agendamento
+static void schedule_same_deadline(void) {
+    events_post_in_us(EVENT_TELEMETRY, 1500);
+    events_post_in_us(EVENT_EFFECT, 1500);
+    events_post_in_us(EVENT_INPUT, 1500);
+}
+
+static void test_same_deadline_priority(void) {
+    run_scenario(schedule_same_deadline, 3000);
+    CHECK_EQ(dispatch_count, 3);
+    check_dispatch(0, EVENT_INPUT, 1500);
+    check_dispatch(1, EVENT_EFFECT, 1500);
+    check_dispatch(2, EVENT_TELEMETRY, 1500);
+}
+
+// Cancelado antes do prazo: nunca despachado, e os demais não são afetados
+static void schedule_and_cancel(void) {
+    alarm_id_t render = events_post_in_us(EVENT_RENDER, 2000);
+    CHECK(render > 0);
+    events_post_in_us(EVENT_TICK, 1000);
+    events_post_in_us(EVENT_STORAGE, 3000);
+    events_cancel(render);
+}
+
+static void test_cancel(void) {
+    run_scenario(schedule_and_cancel, 5000);
+    CHECK_EQ(dispatch_count, 2);
+    check_dispatch(0, EVENT_TICK, 1000);
+    check_dispatch(1, EVENT_STORAGE, 3000);
+}
+
+// Cancelamento feito por um tratador, entre o agendamento e o prazo
+static alarm_id_t cancel_target;
+
+static void on_tick_cancel(void) {
+    record(EVENT_TICK);
+    events_cancel(cancel_target);
+}
+
+static void schedule_cancel_from_handler(void) {
+    events_set_handler(EVENT_TICK, on_tick_cancel);
+    cancel_target = events_post_in_us(EVENT_RENDER, 2000);
+    events_post_in_us(EVENT_TICK, 1000);
+}
+
+static void test_cancel_from_handler(void) {
+    run_scenario(schedule_cancel_from_handler, 5000);
+    events_set_handler(EVENT_TICK, on_tick);
+    CHECK_EQ(dispatch_count, 1);
+    check_dispatch(0, EVENT_TICK, 1000);
+}
+
+static void noop(void) {
+}
+
+// Cancelar um alarme que já disparou (ou o 0 de um despacho imediato) não tem efeito
+static alarm_id_t fired;
+
+static void schedule_cancel_after_fire(void) {
+    fired = events_post_in_us(EVENT_TICK, 1000);
+    events_post_in_us(EVENT_RENDER, 2000);
+}
+
+static void test_cancel_after_fire(void) {
+    run_scenario(schedule_cancel_after_fire, 1500);
+    CHECK_EQ(dispatch_count, 1);
+    events_cancel(fired);
+    events_cancel(0);
+
+    // O agendamento restante segue intacto: RENDER vence 500 us depois
+    run_scenario(noop, 1000);
+    CHECK_EQ(dispatch_count, 1);
+    check_dispatch(0, EVENT_RENDER, 500);
+}
+
+// Sem alarmes livres o evento é despachado de imediato, e o retorno 0 não cancela nada
+static void schedule_pool_exhausted(void) {
+    for (int i = 0; i < 16; i++) {
+        CHECK(events_post_in_us(EVENT_STORAGE, 10000 + i) > 0);
+    }
+    CHECK_EQ(events_post_in_us(EVENT_HOST, 5000), 0);
+    events_cancel(0);
+}
+
+static void test_pool_exhausted(void) {
+    run_scenario(schedule_pool_exhausted, 20000);
+    check_dispatch(0, EVENT_HOST, 0);
+    // Os 16 alarmes de STORAGE vencem em instantes distintos: um despacho cada
+    CHECK_EQ(dispatch_count, 1 + 16);
+    check_dispatch(1, EVENT_STORAGE, 10000);
+    check_dispatch(16, EVENT_STORAGE, 10015);
+}
+
+int main(void) {
+    events_set_handler(EVENT_INPUT, on_input);
+    events_set_handler(EVENT_HOST, on_host);
+    events_set_handler(EVENT_TICK, on_tick);
+    events_set_handler(EVENT_RENDER, on_render);
+    events_set_handler(EVENT_EFFECT, on_effect);
+    events_set_handler(EVENT_STORAGE, on_storage);
+    events_set_handler(EVENT_TELEMETRY, on_telemetry);
+
+    test_deadline_order();
+    test_same_deadline_priority();
+    test_cancel();
+    test_cancel_from_handler();
+    test_cancel_after_fire();
+    test_pool_exhausted();
+    return test_summary("test_events");
+}
@@ -0,0 +1,92 @@
+// Barramento i2c (inc/i2c_bus.c) com falhas injetadas no controlador emulado: NAK é repetido na
+// mesma escrita; tempo esgotado recupera o barramento, chama o retorno de recuperação e encerra a
+// escrita com o erro, sem repetir os dados sobre os dispositivos reconfigurados
+#include "i2c_bus.h"
+#include "i2c_log.h"
+#include "pico_host.h"
+#include "test.h"
+
+#define address 0x3C
+
+static i2c_bus_t bus;
+static i2c_log_t device;
+static int recover_calls;
+
+// Como o SSD1306 após a recuperação: reconfigura o dispositivo numa transação própria
+static void on_recover(void *context) {
+    static const uint8_t reconfigure[] = {0x00, 0xAE, 0xAF};
+    recover_calls++;
+    i2c_bus_write(&bus, address, reconfigure, sizeof(reconfigure));
+}
+
+static const uint8_t data[] = {0x40, 1, 2, 3, 4, 5, 6, 7, 8};
+
+static void setup(void) {
+    i2c_log_clear(&device);
+    recover_calls = 0;
+    bus.stats = (i2c_bus_stats_t){0};
+    bus.failures = 0;
+}
+
+// Um NAK: a mesma escrita é repetida e chega uma única vez ao dispositivo
+static void test_nak_retried(void) {
+    setup();
+    host_i2c_fail(i2c1, 1, PICO_ERROR_GENERIC);
+    CHECK_EQ(i2c_bus_write(&bus, address, data, sizeof(data)), sizeof(data));
+    CHECK_EQ(bus.stats.errors, 1);
+    CHECK_EQ(bus.stats.retries, 1);
+    CHECK_EQ(bus.stats.recoveries, 0);
+    CHECK_EQ(device.count, 1);
+    CHECK_MEM(device.transactions[0].data, data, sizeof(data));
+}
+
+// NAK em todas as tentativas: desiste com o erro após i2c_bus_attempts
+static void test_nak_exhausted(void) {
+    setup();
+    host_i2c_fail(i2c1, i2c_bus_attempts, PICO_ERROR_GENERIC);
+    CHECK_EQ(i2c_bus_write(&bus, address, data, sizeof(data)), PICO_ERROR_GENERIC);
+    CHECK_EQ(bus.stats.errors, i2c_bus_attempts);
+    CHECK_EQ(bus.stats.retries, i2c_bus_attempts - 1);
+    CHECK_EQ(device.count, 0);
+}
+
+// Barramento travado: recuperação, reconfiguração pelo retorno e o erro devolvido a quem chamou,
+// sem que os dados sejam reenviados depois da reconfiguração
+static void test_timeout_not_retried(void) {
+    setup();
+    host_i2c_fail(i2c1, 1, PICO_ERROR_TIMEOUT);
+    CHECK_EQ(i2c_bus_write(&bus, address, data, sizeof(data)), PICO_ERROR_TIMEOUT);
+    CHECK_EQ(bus.stats.timeouts, 1);
+    CHECK_EQ(bus.stats.recoveries, 1);
+    CHECK_EQ(bus.stats.retries, 0);
+    CHECK_EQ(recover_calls, 1);
+    CHECK_EQ(device.count, 1);
+    CHECK_EQ(device.transactions[0].length, 3); // Só a reconfiguração
+
+    // O barramento voltou: a escrita refeita por quem chamou passa
+    CHECK_EQ(i2c_bus_write(&bus, address, data, sizeof(data)), sizeof(data));
+    CHECK_EQ(device.count, 2);
+}
+
+// Falha também dentro do retorno de recuperação: não há recuperação aninhada nem laço
+static void test_timeout_during_recover(void) {
+    setup();
+    host_i2c_fail(i2c1, 2, PICO_ERROR_TIMEOUT);
+    CHECK_EQ(i2c_bus_write(&bus, address, data, sizeof(data)), PICO_ERROR_TIMEOUT);
+    CHECK_EQ(bus.stats.recoveries, 2);
+    CHECK_EQ(recover_calls, 1);
+    CHECK_EQ(device.count, 0);
+    CHECK_EQ(i2c_bus_write(&bus, address, data, sizeof(data)), sizeof(data));
+}
+
+int main(void) {
+    i2c_log_attach(&device, i2c1, address);
+    i2c_bus_init(&bus, i2c1, 14, 15);
+    i2c_bus_set_recover_callback(&bus, on_recover, NULL);
+
+    test_nak_retried();
+    test_nak_exhausted();
+    test_timeout_not_retried();
+    test_timeout_during_recover();
+    return test_summary("test_i2c_bus");
+}
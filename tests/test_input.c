@@ -0,0 +1,214 @@
+// Reconhecimento de gestos (inc/input.c) a partir de traços de bordas reproduzidos no pino:
+// repiques, toque simples contra duplo e o limiar do toque longo. O processamento segue o do
+// firmware (on_input em main.c): borda na interrupção -> EVENT_INPUT -> input_process, reagendado
+// pelo prazo que ele retorna
+#include "input.h"
+#include "events.h"
+#include "pico_host.h"
+#include "test.h"
+
+#define button_gpio 6
+#define ms 1000ull
+#define max_gestures 32
+
+typedef struct {
+    input_gesture_t gesture;
+    uint64_t time_us; // Instante levado pelo gesto, relativo ao início do traço
+    uint64_t emitted_us; // Instante em que o gesto foi emitido
+} gesture_t;
+
+static gesture_t gestures[max_gestures];
+static int gesture_count;
+static uint64_t origin;
+static alarm_id_t input_alarm;
+
+static void on_gesture(const input_event_t *event) {
+    if (gesture_count < max_gestures) {
+        gestures[gesture_count].gesture = event->gesture;
+        gestures[gesture_count].time_us = event->time_us - origin;
+        gestures[gesture_count].emitted_us = time_us_64() - origin;
+    }
+    gesture_count++;
+}
+
+static void on_input(void) {
+    uint64_t deadline = input_process(time_us_64(), on_gesture);
+    events_cancel(input_alarm);
+    input_alarm = 0;
+    if (deadline) {
+        uint64_t now = time_us_64();
+        input_alarm = events_post_in_us(EVENT_INPUT, deadline > now ? deadline - now : 0);
+    }
+}
+
+static void on_input_edge(void) {
+    events_post(EVENT_INPUT);
+}
+
+// Reproduz um traço de bordas (instantes relativos em us; nível true = pressionado, pino no
+// terra) e processa até 1 s depois da última
+static void replay(const uint64_t *times, const bool *pressed, int count) {
+    gesture_count = 0;
+    origin = time_us_64() + 10 * ms;
+    for (int i = 0; i < count; i++) {
+        host_gpio_drive_at(origin + times[i], button_gpio, !pressed[i]);
+    }
+    host_run(events_run, origin + times[count - 1] + 1000 * ms);
+    host_gpio_float(button_gpio);
+}
+
+static void check_gesture(int index, input_gesture_t gesture, uint64_t time_us) {
+    CHECK(index < gesture_count);
+    if (index < gesture_count) {
+        CHECK_EQ(gestures[index].gesture, gesture);
+        CHECK_EQ(gestures[index].time_us, time_us);
+    }
+}
+
+// Toque simples limpo: o CLICK sai só depois da janela de toque duplo, mas com o instante do
+// pressionamento
+static void test_click(void) {
+    const uint64_t times[] = {0, 120 * ms};
+    const bool pressed[] = {true, false};
+    replay(times, pressed, 2);
+    CHECK_EQ(gesture_count, 3);
+    check_gesture(0, INPUT_PRESS, 0);
+    check_gesture(1, INPUT_RELEASE, 120 * ms);
+    check_gesture(2, INPUT_CLICK, 0);
+    CHECK(gestures[2].emitted_us > 120 * ms + input_double_press_us);
+    CHECK(gestures[2].emitted_us <= 120 * ms + input_double_press_us + 1 * ms);
+}
+
+// Repiques ao pressionar e ao soltar: um único PRESS e um único RELEASE, nos instantes das
+// primeiras bordas, e as demais contadas como repiques
+static void test_bounce(void) {
+    const uint64_t times[] = {0, 300, 900, 2500, 2600,
+                              150 * ms, 150 * ms + 400, 150 * ms + 700, 150 * ms + 3000, 150 * ms + 3100};
+    const bool pressed[] = {true, false, true, false, true, false, true, false, true, false};
+    uint32_t bounces = input_get_stats()->bounces;
+    replay(times, pressed, 10);
+    CHECK_EQ(input_get_stats()->bounces - bounces, 8);
+    CHECK_EQ(gesture_count, 3);
+    check_gesture(0, INPUT_PRESS, 0);
+    check_gesture(1, INPUT_RELEASE, 150 * ms);
+    check_gesture(2, INPUT_CLICK, 0);
+}
+
+// Um pulso curto de ruído dentro da janela de debounce não vira gesto: o nível real, conferido
+// ao fim da janela, é o que vale
+static void test_glitch(void) {
+    const uint64_t times[] = {0, 3 * ms, 200 * ms};
+    const bool pressed[] = {true, false, false};
+    replay(times, pressed, 3);
+    CHECK_EQ(gesture_count, 3);
+    check_gesture(0, INPUT_PRESS, 0);
+    check_gesture(1, INPUT_RELEASE, input_debounce_us);
+    check_gesture(2, INPUT_CLICK, 0);
+}
+
+// Segundo pressionamento dentro da janela: DOUBLE no instante dele, sem nenhum CLICK
+static void test_double(void) {
+    const uint64_t times[] = {0, 80 * ms, 80 * ms + input_double_press_us, 400 * ms + input_double_press_us};
+    const bool pressed[] = {true, false, true, false};
+    replay(times, pressed, 4);
+    CHECK_EQ(gesture_count, 5);
+    check_gesture(0, INPUT_PRESS, 0);
+    check_gesture(1, INPUT_RELEASE, 80 * ms);
+    check_gesture(2, INPUT_PRESS, 80 * ms + input_double_press_us);
+    check_gesture(3, INPUT_DOUBLE, 80 * ms + input_double_press_us);
+    check_gesture(4, INPUT_RELEASE, 400 * ms + input_double_press_us);
+}
+
+// Um microssegundo além da janela: dois toques simples, cada um com o seu pressionamento. O
+// segundo pressionamento chega junto com o fim da janela e não pode passar à frente do CLICK
+// do primeiro
+static void test_two_clicks(void) {
+    const uint64_t second = 80 * ms + input_double_press_us + 1;
+    const uint64_t times[] = {0, 80 * ms, second, second + 80 * ms};
+    const bool pressed[] = {true, false, true, false};
+    replay(times, pressed, 4);
+    CHECK_EQ(gesture_count, 6);
+    check_gesture(0, INPUT_PRESS, 0);
+    check_gesture(1, INPUT_RELEASE, 80 * ms);
+    check_gesture(2, INPUT_CLICK, 0);
+    check_gesture(3, INPUT_PRESS, second);
+    check_gesture(4, INPUT_RELEASE, second + 80 * ms);
+    check_gesture(5, INPUT_CLICK, second);
+}
+
+// Limiar do toque longo: 1 us antes ainda é toque simples; no limiar sai LONG, no instante exato,
+// e soltar depois não gera CLICK
+static void test_long_threshold(void) {
+    const uint64_t short_times[] = {0, input_long_press_us - 1};
+    const bool pressed[] = {true, false};
+    replay(short_times, pressed, 2);
+    CHECK_EQ(gesture_count, 3);
+    check_gesture(2, INPUT_CLICK, 0);
+
+    const uint64_t long_times[] = {0, input_long_press_us + 50 * ms};
+    replay(long_times, pressed, 2);
+    CHECK_EQ(gesture_count, 3);
+    check_gesture(0, INPUT_PRESS, 0);
+    check_gesture(1, INPUT_LONG, input_long_press_us);
+    CHECK_EQ(gestures[1].emitted_us, input_long_press_us);
+    check_gesture(2, INPUT_RELEASE, input_long_press_us + 50 * ms);
+}
+
+// Bordas na fila até o processamento; depois, o instante da última (repique ou não) fica
+// disponível para quem espera os botões parados (a gravação na flash, em main.c)
+static void test_edge_queries(void) {
+    const uint64_t times[] = {0, 2 * ms, 90 * ms, 150 * ms};
+    const bool pressed[] = {true, false, true, false};
+    origin = time_us_64() + 10 * ms;
+    gesture_count = 0;
+    for (int i = 0; i < 4; i++) {
+        host_gpio_drive_at(origin + times[i], button_gpio, !pressed[i]);
+    }
+    CHECK(!input_pending());
+    host_advance_to(origin + 1 * ms); // A interrupção registra a borda, sem despachar os eventos
+    CHECK(input_pending());
+    host_run(events_run, origin + 1000 * ms);
+    host_gpio_float(button_gpio);
+    CHECK(!input_pending());
+    CHECK_EQ(input_last_edge_us(), origin + 150 * ms);
+}
+
+// Borda capturada entre a leitura do relógio e o processamento (now anterior a ela): nenhum
+// toque longo nem CLICK antes da hora, e a latência não dá a volta
+static void test_edge_after_now(void) {
+    origin = time_us_64() + 10 * ms;
+    gesture_count = 0;
+    host_gpio_drive_at(origin, button_gpio, false);
+    host_advance_to(origin + 1 * ms);
+    CHECK_EQ(input_process(origin - 1 * ms, on_gesture), origin + input_long_press_us);
+    CHECK_EQ(gesture_count, 1);
+    check_gesture(0, INPUT_PRESS, 0);
+    CHECK(input_get_stats()->max_latency_us < input_long_press_us);
+
+    host_gpio_drive_at(origin + 100 * ms, button_gpio, true);
+    host_advance_to(origin + 101 * ms);
+    CHECK_EQ(input_process(origin + 99 * ms, on_gesture), origin + 100 * ms + input_double_press_us + 1);
+    CHECK_EQ(gesture_count, 2);
+    check_gesture(1, INPUT_RELEASE, 100 * ms);
+
+    host_run(events_run, origin + 1000 * ms);
+    host_gpio_float(button_gpio);
+    CHECK_EQ(gesture_count, 3);
+    check_gesture(2, INPUT_CLICK, 0);
+}
+
+int main(void) {
+    events_set_handler(EVENT_INPUT, on_input);
+    input_init(on_input_edge);
+    CHECK_EQ(input_add_button(button_gpio), 0);
+
+    test_click();
+    test_bounce();
+    test_glitch();
+    test_double();
+    test_two_clicks();
+    test_long_threshold();
+    test_edge_queries();
+    test_edge_after_now();
+    return test_summary("test_input");
+}
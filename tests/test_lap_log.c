@@ -0,0 +1,194 @@
+// Log de voltas na flash (inc/lap_log.c) sobre uma flash em RAM: a energia é cortada em cada
+// apagamento e em cada gravação de uma carga de trabalho com várias sessões e voltas do rodízio
+// de setores, deixando a operação pela metade; a montagem seguinte deve recuperar ao menos tudo o
+// que já estava confirmado e nada inventado. Também confere a amplificação de escrita e o
+// nivelamento de desgaste contados pelo log
+#include <setjmp.h>
+#include "pico/stdlib.h"
+#include "lap_log.h"
+#include "test.h"
+
+#define region_size (lap_log_sectors * lap_log_sector_size)
+#define workload_pauses 300
+#define session_pauses 37 // Uma nova sessão a cada tantas pausas
+
+static uint8_t flash[region_size];
+static int flash_ops;        // Apagamentos e gravações desde a última montagem da carga
+static int cut_at = -1;      // Operação em que a energia é cortada (-1: nunca)
+static jmp_buf power_cut;
+
+// Corte durante o apagamento: só a primeira metade do setor chega a ser apagada
+static void flash_erase(uint32_t offset) {
+    bool cut = flash_ops++ == cut_at;
+    memset(flash + offset, 0xFF, cut ? lap_log_sector_size / 2 : lap_log_sector_size);
+    if (cut) {
+        longjmp(power_cut, 1);
+    }
+}
+
+// Como na flash real, gravar só leva bits de 1 a 0. Corte durante a gravação: só um prefixo da
+// página, de tamanho variável, é gravado
+static void flash_program(uint32_t offset, const uint8_t *page) {
+    bool cut = flash_ops == cut_at;
+    uint length = cut ? (uint)(flash_ops * 53) % lap_log_page_size : lap_log_page_size;
+    flash_ops++;
+    for (uint i = 0; i < length; i++) {
+        flash[offset + i] &= page[i];
+    }
+    if (cut) {
+        longjmp(power_cut, 1);
+    }
+}
+
+// Tempo parcial da volta n da sessão s: único por sessão, para saber de qual sessão veio o que
+// foi recuperado
+static uint32_t split_ms(uint32_t session, uint32_t n) {
+    return session * 100000 + n * 7;
+}
+
+// Estado da carga no momento do corte
+static lap_log_t flash_log;
+static laps_t laps;
+static uint32_t session;
+static uint32_t previous_count; // Voltas da sessão anterior, toda gravada antes do reset
+
+// Pausas com de 1 a 5 voltas novas, cada uma levada inteira à flash, e um reset a cada
+// session_pauses pausas
+static void workload(void) {
+    memset(flash, 0xFF, sizeof(flash));
+    flash_ops = 0;
+    lap_log_mount(&flash_log, flash, flash_erase, flash_program, &laps);
+    session = 1;
+    previous_count = 0;
+    for (int pause = 0; pause < workload_pauses; pause++) {
+        if (pause % session_pauses == session_pauses - 1) {
+            previous_count = laps.count;
+            session++;
+            laps_reset(&laps);
+        }
+        for (int i = 0; i <= pause * 7 % 5; i++) {
+            laps_record(&laps, split_ms(session, laps.count + 1));
+        }
+        while (lap_log_step(&flash_log, &laps)) {
+        }
+    }
+}
+
+// O anel montado tem as voltas da sessão s até a última, todas já gravadas
+static bool recovered_session(const laps_t *recovered, uint32_t s) {
+    if (recovered->persisted != recovered->count || recovered->new_session) {
+        return false;
+    }
+    uint32_t first = recovered->count > laps_capacity ? recovered->count - laps_capacity + 1 : 1;
+    for (uint32_t n = first; n <= recovered->count; n++) {
+        const lap_t *lap = laps_find(recovered, n);
+        if (!lap || lap->split_ms != split_ms(s, n)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Depois do corte: a montagem traz a sessão atual com ao menos as voltas confirmadas (e no máximo
+// as marcadas), ou, com o reset ainda não registrado, a sessão anterior inteira. O log segue
+// gravando depois da página interrompida
+static bool recovers_after_cut(void) {
+    lap_log_t mounted;
+    laps_t recovered;
+    cut_at = -1;
+    lap_log_mount(&mounted, flash, flash_erase, flash_program, &recovered);
+
+    uint32_t s;
+    if (recovered.count >= laps.persisted && recovered.count <= laps.count &&
+        recovered_session(&recovered, session)) {
+        s = session;
+    } else if (laps.new_session && recovered.count == previous_count &&
+               recovered_session(&recovered, session - 1)) {
+        s = session - 1;
+    } else {
+        fprintf(stderr, "corte na operação %d: %u voltas recuperadas (sessão %u: %u marcadas, %u gravadas)\n",
+                flash_ops - 1, recovered.count, session, laps.count, laps.persisted);
+        return false;
+    }
+
+    uint32_t count = recovered.count;
+    for (int i = 0; i < 3; i++) {
+        laps_record(&recovered, split_ms(s, recovered.count + 1));
+    }
+    while (lap_log_step(&mounted, &recovered)) {
+    }
+    lap_log_mount(&mounted, flash, flash_erase, flash_program, &recovered);
+    return recovered.count == count + 3 && recovered_session(&recovered, s);
+}
+
+// Corte em cada uma das operações da carga, refeita do zero a cada vez
+static void test_power_cut_everywhere(void) {
+    cut_at = -1;
+    workload();
+    int total = flash_ops;
+    CHECK(flash_log.stats.erases > lap_log_sectors * 2); // O rodízio deu mais de duas voltas
+    CHECK(session > 5);
+
+    int cuts = 0, recovered = 0;
+    for (int op = 0; op < total; op++) {
+        cut_at = op;
+        if (setjmp(power_cut) == 0) {
+            workload();
+            continue; // Não deveria chegar ao fim
+        }
+        cuts++;
+        recovered += recovers_after_cut();
+    }
+    CHECK_EQ(cuts, total);
+    CHECK_EQ(recovered, total);
+}
+
+// Amplificação de escrita: cada pausa grava uma página inteira, e cada 15 páginas custam mais um
+// cabeçalho e um apagamento. Com uma volta por pausa são 256 * 16 / 15 / 4 ≈ 68 bytes gravados
+// por byte de volta; com o anel inteiro (32 voltas) por pausa, ≈ 2,1
+static void check_amplification(uint laps_per_pause, uint batches) {
+    memset(flash, 0xFF, sizeof(flash));
+    cut_at = -1;
+    lap_log_mount(&flash_log, flash, flash_erase, flash_program, &laps);
+    for (uint b = 0; b < batches; b++) {
+        for (uint i = 0; i < laps_per_pause; i++) {
+            laps_record(&laps, split_ms(1, laps.count + 1));
+        }
+        while (lap_log_step(&flash_log, &laps)) {
+        }
+    }
+    uint sectors_used = (batches + lap_log_pages_per_sector - 2) / (lap_log_pages_per_sector - 1);
+    CHECK_EQ(flash_log.stats.batches, batches);
+    CHECK_EQ(flash_log.stats.headers, sectors_used);
+    CHECK_EQ(flash_log.stats.erases, sectors_used);
+    CHECK_EQ(flash_log.stats.payload_bytes, batches * laps_per_pause * sizeof(uint32_t));
+    CHECK_EQ(laps.dropped, 0);
+
+    double amplification = (double)(flash_log.stats.batches + flash_log.stats.headers) * lap_log_page_size / flash_log.stats.payload_bytes;
+    double expected = (double)lap_log_page_size * lap_log_pages_per_sector / (lap_log_pages_per_sector - 1) /
+                      (laps_per_pause * sizeof(uint32_t));
+    printf("%u volta(s) por pausa: amplificação de escrita %.2f\n", laps_per_pause, amplification);
+    CHECK(amplification >= expected * 0.95 && amplification <= expected * 1.05);
+
+    // Nivelamento: os apagamentos de cada setor diferem no máximo em um
+    uint32_t low = UINT32_MAX, high = 0;
+    for (uint sector = 0; sector < lap_log_sectors; sector++) {
+        const lap_log_sector_t *header = (const lap_log_sector_t *)(flash + sector * lap_log_sector_size);
+        uint32_t count = header->magic == lap_log_sector_magic ? header->erase_count : 0;
+        low = count < low ? count : low;
+        high = count > high ? count : high;
+    }
+    CHECK(high - low <= 1);
+    CHECK_EQ(flash_log.stats.max_erase_count, high);
+}
+
+static void test_write_amplification(void) {
+    check_amplification(1, 150);
+    check_amplification(laps_capacity, 150);
+}
+
+int main(void) {
+    test_power_cut_everywhere();
+    test_write_amplification();
+    return test_summary("test_lap_log");
+}
@@ -0,0 +1,157 @@
+// Compositor dos LEDs (inc/led_comp.c) no relógio virtual: atualiza a 400 Hz enquanto há
+// transição ou algum canal com fração a pontilhar; com todos os canais num degrau exato entrega
+// um último quadro e para o temporizador até a próxima mudança de alvo ou de brilho
+#include "pico/stdlib.h"
+#include "pico_host.h"
+#include "led_comp.h"
+#include "led_tables.h"
+#include "test.h"
+
+#define pixel_count 25
+#define refresh_hz 400
+#define ms 1000ull
+
+static uint32_t last_frame[pixel_count];
+static uint32_t frames;
+static uint32_t frame_changes;
+static uint32_t channel_sums[pixel_count][3]; // Soma da saída de cada canal (G, R, B) nos quadros entregues
+static int busy_frames; // Próximos quadros recusados, como com a saída ocupada
+
+static bool output(const uint32_t *frame, uint count) {
+    if (busy_frames > 0) {
+        busy_frames--;
+        return false;
+    }
+    frames++;
+    if (memcmp(last_frame, frame, sizeof(last_frame)) != 0) {
+        frame_changes++;
+    }
+    memcpy(last_frame, frame, sizeof(last_frame));
+    for (uint i = 0; i < pixel_count; i++) {
+        for (int c = 0; c < 3; c++) {
+            channel_sums[i][c] += (frame[i] >> (24 - 8 * c)) & 0xFF;
+        }
+    }
+    return true;
+}
+
+// Quadros entregues ao longo de duration_us a partir de agora
+static uint32_t frames_during(uint64_t duration_us) {
+    uint32_t before = frames;
+    host_advance_us(duration_us);
+    return frames - before;
+}
+
+// Intensidade de um canal depois do gama e do brilho, em ponto fixo 8.8
+static uint32_t linear_channel(uint8_t value, uint scale) {
+    return led_gamma[value] * scale >> 8;
+}
+
+// Pontilhamento em repouso: o temporizador segue a 400 Hz e, a cada 256 quadros, a saída do canal
+// c do pixel soma exatamente a intensidade (a média é o valor com a fração)
+static void check_dithered(uint pixel, int c, uint32_t linear) {
+    uint32_t before = channel_sums[pixel][c];
+    CHECK_EQ(frames_during(256 * 1000000ull / refresh_hz), 256);
+    CHECK_EQ(channel_sums[pixel][c] - before, linear);
+}
+
+// Ao iniciar: um quadro apagado e o temporizador parado
+static void test_idle_after_init(void) {
+    CHECK_EQ(frames_during(10 * ms), 1);
+    CHECK_EQ(last_frame[0], 0);
+    CHECK_EQ(led_comp_get_stats()->idle_stops, 1);
+    CHECK_EQ(frames_during(5000 * ms), 0);
+}
+
+// Transição de 100 ms: 40 quadros a 400 Hz e o quadro de repouso; depois, nada
+static void test_fade_then_idle(void) {
+    uint32_t stops = led_comp_get_stats()->idle_stops;
+    led_comp_set_pixel(3, 0xFF000000, 100);
+    uint32_t fade = frames_during(200 * ms);
+    CHECK(fade >= 40 && fade <= 43);
+    CHECK_EQ(led_comp_get_stats()->idle_stops, stops + 1);
+    CHECK_EQ(linear_channel(255, 256) & 0xFF, 0); // Degrau exato
+    CHECK_EQ(last_frame[3], 0xFFu << 24);
+    CHECK_EQ(last_frame[0], 0);
+    CHECK_EQ(frames_during(10000 * ms), 0);
+}
+
+// Alvo igual ao atual não religa o compositor; um alvo novo exato sem transição dá um único quadro
+static void test_instant_change(void) {
+    led_comp_set_pixel(3, 0xFF000000, 100);
+    CHECK_EQ(frames_during(100 * ms), 0);
+    led_comp_set_pixel(7, 0x00FF0000, 0);
+    CHECK_EQ(frames_during(100 * ms), 1);
+    CHECK_EQ(last_frame[7], 0xFFu << 16);
+}
+
+// Valor com fração depois do gama: o canal segue pontilhado em repouso, sem parar o temporizador;
+// de volta a um degrau exato, um último quadro e o temporizador para
+static void test_fraction_keeps_dithering(void) {
+    uint32_t stops = led_comp_get_stats()->idle_stops;
+    led_comp_set_pixel(7, 0x00800000, 0);
+    uint32_t linear = linear_channel(0x80, 256);
+    CHECK(linear & 0xFF);
+    check_dithered(7, 1, linear);
+    check_dithered(7, 1, linear);
+    CHECK_EQ(led_comp_get_stats()->idle_stops, stops);
+
+    led_comp_set_pixel(7, 0x00FF0000, 0);
+    CHECK_EQ(frames_during(100 * ms), 1);
+    CHECK_EQ(led_comp_get_stats()->idle_stops, stops + 1);
+    CHECK_EQ(last_frame[7], 0xFFu << 16);
+}
+
+// Brilho com fração: todos os canais acesos ficam pontilhados, cada um com a média exata; com o
+// brilho cheio os degraus voltam a ser exatos e o temporizador para
+static void test_brightness_fraction(void) {
+    led_comp_set_brightness(25);
+    check_dithered(3, 0, linear_channel(255, 25));
+    check_dithered(7, 1, linear_channel(255, 25));
+    led_comp_set_brightness(25);
+    check_dithered(3, 0, linear_channel(255, 25));
+
+    led_comp_set_brightness(255);
+    CHECK_EQ(frames_during(100 * ms), 1);
+    CHECK_EQ(last_frame[3], 0xFFu << 24);
+    CHECK_EQ(frames_during(1000 * ms), 0);
+}
+
+// Durante a transição o pontilhamento continua ativo: com o brilho baixo, a mudança de um canal
+// passa por quadros alternados entre degraus vizinhos, e o canal segue pontilhado no alvo
+static void test_dither_while_fading(void) {
+    led_comp_set_brightness(25);
+    uint32_t changes = frame_changes;
+    led_comp_set_pixel(12, 0x0000FF00, 500);
+    CHECK_EQ(frames_during(600 * ms), 240);
+    CHECK(frame_changes - changes > 25); // Mais mudanças do que os 25 degraus do canal
+    check_dithered(12, 2, linear_channel(255, 25));
+
+    led_comp_set_brightness(255);
+    CHECK_EQ(frames_during(100 * ms), 1);
+    CHECK_EQ(last_frame[12], 0xFFu << 8);
+    CHECK_EQ(frames_during(1000 * ms), 0);
+}
+
+// Saída ocupada no quadro de repouso: o temporizador segue até entregá-lo
+static void test_settle_waits_for_output(void) {
+    led_comp_set_pixel(20, 0x00FF0000, 0);
+    busy_frames = 3;
+    CHECK_EQ(frames_during(100 * ms), 1);
+    CHECK_EQ(busy_frames, 0);
+    CHECK_EQ(last_frame[20], 0xFFu << 16);
+    CHECK_EQ(frames_during(1000 * ms), 0);
+}
+
+int main(void) {
+    led_comp_init(pixel_count, refresh_hz, output);
+
+    test_idle_after_init();
+    test_fade_then_idle();
+    test_instant_change();
+    test_fraction_keeps_dithering();
+    test_brightness_fraction();
+    test_dither_while_fading();
+    test_settle_waits_for_output();
+    return test_summary("test_led_comp");
+}
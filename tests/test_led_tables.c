@@ -0,0 +1,65 @@
+// Tabelas geradas para a matriz de LEDs (tools/gen_led_tables.py): cada máscara deve acender
+// exatamente os LEDs que o código original acendia bit a bit (secToLed, minToLed e hourToLed,
+// com os índices da fita fixos), e a curva de gama deve ser monotônica de 0 a 255 * 256
+#include "pico/stdlib.h"
+#include "led_tables.h"
+#include "test.h"
+
+// Índices da fita de cada bit, do menos significativo ao mais significativo, como no original
+static const int second_positions[] = {0, 9, 10, 19, 20, 1};
+static const int minute_positions[] = {2, 7, 12, 17, 22, 3};
+static const int hour_positions[] = {4, 5, 14, 15, 24};
+
+static uint32_t reference_mask(int value, const int *positions, int bits) {
+    uint32_t mask = 0;
+    for (int i = 0; i < bits; i++) {
+        if (value & (1 << i)) {
+            mask |= 1u << positions[i];
+        }
+    }
+    return mask;
+}
+
+static void check_masks(const uint32_t *masks, int count, const int *positions, int bits) {
+    int mismatches = 0;
+    for (int value = 0; value < count; value++) {
+        if (masks[value] != reference_mask(value, positions, bits)) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void test_masks(void) {
+    CHECK_EQ(count_of(led_second_masks), 64);
+    CHECK_EQ(count_of(led_minute_masks), 64);
+    CHECK_EQ(count_of(led_hour_masks), 32);
+    check_masks(led_second_masks, 64, second_positions, 6);
+    check_masks(led_minute_masks, 64, minute_positions, 6);
+    check_masks(led_hour_masks, 32, hour_positions, 5);
+
+    // Os três campos ocupam LEDs distintos da matriz 5x5
+    uint32_t seconds = led_second_masks[63], minutes = led_minute_masks[63], hours = led_hour_masks[31];
+    CHECK_EQ(seconds & minutes, 0);
+    CHECK_EQ(seconds & hours, 0);
+    CHECK_EQ(minutes & hours, 0);
+    CHECK_EQ((seconds | minutes | hours) >> 25, 0);
+}
+
+static void test_gamma(void) {
+    CHECK_EQ(led_gamma[0], 0);
+    CHECK_EQ(led_gamma[255], 255 * 256);
+    int decreasing = 0;
+    for (int i = 1; i < 256; i++) {
+        if (led_gamma[i] < led_gamma[i - 1]) {
+            decreasing++;
+        }
+    }
+    CHECK_EQ(decreasing, 0);
+}
+
+int main(void) {
+    test_masks();
+    test_gamma();
+    return test_summary("test_led_tables");
+}
@@ -0,0 +1,256 @@
+// Envio por diferença ao OLED (render_changes_on_display): sequência exata de bytes no i2c para
+// páginas alteradas e inalteradas, contra um dispositivo que registra as transações. A recuperação
+// do barramento no meio de um quadro e a escrita que falha em todas as tentativas são conferidas
+// contra o modelo do painel (host_ssd1306.h)
+#include "ssd1306.h"
+#include "i2c_log.h"
+#include "host_ssd1306.h"
+#include "test.h"
+
+static i2c_bus_t bus;
+static ssd1306_t oled;
+static i2c_log_t oled_log;
+static uint8_t frame[ssd1306_buffer_length];
+
+// Confere que a transação index é a janela de endereçamento seguida dos dados da área
+static void check_window(int index, uint8_t first_column, uint8_t last_column, uint8_t page,
+                         const uint8_t *data, size_t length) {
+    const uint8_t window[] = {0x00, ssd1306_set_column_address, first_column, last_column,
+                              ssd1306_set_page_address, page, page};
+    CHECK(index + 1 < oled_log.count);
+    if (index + 1 >= oled_log.count) {
+        return;
+    }
+    const i2c_log_transaction_t *commands = &oled_log.transactions[index];
+    const i2c_log_transaction_t *pixels = &oled_log.transactions[index + 1];
+    CHECK_EQ(commands->length, sizeof(window));
+    CHECK_MEM(commands->data, window, sizeof(window));
+    CHECK_EQ(pixels->length, length + 1);
+    CHECK_EQ(pixels->data[0], 0x40);
+    CHECK_MEM(pixels->data + 1, data, length);
+}
+
+// A sequência de inicialização vai numa única transação, atrás do byte de controle 0x00; no
+// barramento emulado ela ocupa menos tempo que os mesmos comandos enviados um a um (0x80 + comando)
+static void test_init_batched(void) {
+    i2c_log_clear(&oled_log);
+    uint64_t start = time_us_64();
+    ssd1306_init(&oled);
+    uint64_t batched_us = time_us_64() - start;
+    CHECK_EQ(oled_log.count, 1);
+    CHECK_EQ(oled_log.transactions[0].length, 26 + 1);
+    CHECK_EQ(oled_log.transactions[0].data[0], 0x00);
+    CHECK_EQ(oled_log.transactions[0].data[26], ssd1306_set_display | 0x01);
+
+    uint8_t commands[26];
+    memcpy(commands, oled_log.transactions[0].data + 1, sizeof(commands));
+    i2c_log_clear(&oled_log);
+    start = time_us_64();
+    for (int i = 0; i < 26; i++) {
+        ssd1306_send_command(&oled, commands[i]);
+    }
+    uint64_t single_us = time_us_64() - start;
+    CHECK_EQ(oled_log.count, 26);
+    CHECK(batched_us < single_us);
+    printf("inicialização no barramento emulado: %llu us em lote, %llu us comando a comando\n",
+           (unsigned long long)batched_us, (unsigned long long)single_us);
+}
+
+// Sem cópia sombra válida o quadro vai inteiro, numa janela de tela cheia
+static void test_full_frame_without_shadow(void) {
+    for (int i = 0; i < ssd1306_buffer_length; i++) {
+        frame[i] = (uint8_t)(i * 7);
+    }
+    i2c_log_clear(&oled_log);
+    CHECK_EQ(render_changes_on_display(&oled, frame), ssd1306_buffer_length);
+
+    const uint8_t window[] = {0x00, ssd1306_set_column_address, 0, ssd1306_width - 1,
+                              ssd1306_set_page_address, 0, ssd1306_n_pages - 1};
+    CHECK_EQ(oled_log.count, 2);
+    CHECK_EQ(oled_log.transactions[0].length, sizeof(window));
+    CHECK_MEM(oled_log.transactions[0].data, window, sizeof(window));
+    CHECK_EQ(oled_log.transactions[1].length, ssd1306_buffer_length + 1);
+    CHECK_EQ(oled_log.transactions[1].data[0], 0x40);
+    CHECK_MEM(oled_log.transactions[1].data + 1, frame, ssd1306_buffer_length);
+    CHECK(oled.shadow_valid);
+}
+
+// Quadro idêntico ao exibido: nenhum byte no barramento
+static void test_unchanged_frame(void) {
+    i2c_log_clear(&oled_log);
+    CHECK_EQ(render_changes_on_display(&oled, frame), 0);
+    CHECK_EQ(oled_log.count, 0);
+}
+
+// Só as páginas alteradas, cada uma do primeiro ao último byte diferente (inclusive os iguais
+// no meio do trecho); as demais páginas não aparecem
+static void test_changed_pages(void) {
+    frame[2 * ssd1306_width + 10] ^= 0xFF;
+    frame[5 * ssd1306_width + 20] ^= 0x01;
+    frame[5 * ssd1306_width + 30] ^= 0x80;
+    frame[7 * ssd1306_width + 127] ^= 0x10;
+
+    i2c_log_clear(&oled_log);
+    CHECK_EQ(render_changes_on_display(&oled, frame), 1 + 11 + 1);
+    CHECK_EQ(oled_log.count, 6);
+    check_window(0, 10, 10, 2, frame + 2 * ssd1306_width + 10, 1);
+    check_window(2, 20, 30, 5, frame + 5 * ssd1306_width + 20, 11);
+    check_window(4, 127, 127, 7, frame + 7 * ssd1306_width + 127, 1);
+    CHECK_MEM(oled.shadow, frame, ssd1306_buffer_length);
+
+    // Reenviar o mesmo quadro não gera tráfego
+    i2c_log_clear(&oled_log);
+    CHECK_EQ(render_changes_on_display(&oled, frame), 0);
+    CHECK_EQ(oled_log.count, 0);
+}
+
+// Uma área explícita (render_on_display) atualiza só a parte correspondente da cópia sombra,
+// e a diferença seguinte parte dela
+static void test_area_updates_shadow(void) {
+    uint8_t span[4] = {1, 2, 3, 4};
+    struct render_area area = {start_column : 60, end_column : 63, start_page : 3, end_page : 3};
+    calculate_render_area_buffer_length(&area);
+
+    i2c_log_clear(&oled_log);
+    render_on_display(&oled, span, &area);
+    check_window(0, 60, 63, 3, span, 4);
+
+    // O quadro ainda tem o conteúdo antigo nessa área: a diferença o reenvia
+    i2c_log_clear(&oled_log);
+    CHECK_EQ(render_changes_on_display(&oled, frame), 4);
+    check_window(0, 60, 63, 3, frame + 3 * ssd1306_width + 60, 4);
+}
+
+// Cópia sombra descartada: o quadro seguinte volta a ser completo
+static void test_invalidate(void) {
+    ssd1306_shadow_invalidate(&oled);
+    i2c_log_clear(&oled_log);
+    CHECK_EQ(render_changes_on_display(&oled, frame), ssd1306_buffer_length);
+    CHECK_EQ(oled_log.count, 2);
+}
+
+// Sem canal de DMA configurado, o envio "assíncrono" cai no envio bloqueante por diferença
+static void test_async_without_dma(void) {
+    frame[4 * ssd1306_width + 64] ^= 0x42;
+    i2c_log_clear(&oled_log);
+    CHECK(render_on_display_async(&oled, frame));
+    CHECK_EQ(oled_log.count, 2);
+    check_window(0, 64, 64, 4, frame + 4 * ssd1306_width + 64, 1);
+}
+
+// Segundo display, num barramento próprio, com o conteúdo da GDDRAM modelado
+static i2c_bus_t model_bus;
+static ssd1306_t model_oled;
+static host_ssd1306_t panel;
+static bool (*panel_write)(host_i2c_device_t *, const uint8_t *, size_t, uint64_t);
+static int fail_after = -1; // Transações que ainda passam, menos uma, antes da falha
+static uint fail_count;      // Tentativas que falham a partir dali
+static int fail_error;
+
+static bool panel_write_then_fail(host_i2c_device_t *device, const uint8_t *data, size_t length, uint64_t time_us) {
+    if (fail_after >= 0 && fail_after-- == 0) {
+        host_i2c_fail(i2c0, fail_count, fail_error); // Falha a transação seguinte
+    }
+    return panel_write(device, data, length, time_us);
+}
+
+// Deixa passar count transações e faz falhar as failures tentativas seguintes com error
+static void fail_after_transactions(int count, uint failures, int error) {
+    fail_count = failures;
+    fail_error = error;
+    if (count == 0) {
+        host_i2c_fail(i2c0, failures, error);
+    } else {
+        fail_after = count - 1;
+    }
+}
+
+// Barramento travado no meio de um envio por diferença, em cada transação possível: a
+// recuperação reinicializa o painel e reenvia a cópia sombra, e o quadro é refeito do topo. Ao
+// fim, a GDDRAM tem exatamente o quadro pedido
+static void test_recovery_mid_flush(void) {
+    host_ssd1306_attach(&panel, i2c0, ssd1306_i2c_address);
+    panel_write = panel.device.write;
+    panel.device.write = panel_write_then_fail;
+    i2c_bus_init(&model_bus, i2c0, 16, 17);
+    CHECK(ssd1306_attach(&model_oled, &model_bus, ssd1306_i2c_address, ssd1306_height, false) > 0);
+    ssd1306_init(&model_oled);
+
+    static uint8_t image[ssd1306_buffer_length];
+    for (int i = 0; i < ssd1306_buffer_length; i++) {
+        image[i] = (uint8_t)(i * 13);
+    }
+    render_changes_on_display(&model_oled, image);
+    CHECK_MEM(panel.gddram, image, ssd1306_buffer_length);
+
+    // Três páginas alteradas: seis transações (janela e dados de cada trecho)
+    for (int fail = 0; fail < 6; fail++) {
+        image[1 * ssd1306_width + 5] ^= 0x11;
+        image[4 * ssd1306_width + 70] ^= 0x22;
+        image[6 * ssd1306_width + 127] ^= 0x44;
+        uint32_t recoveries = model_bus.stats.recoveries;
+        fail_after_transactions(fail, 1, PICO_ERROR_TIMEOUT); // Barramento travado
+        render_changes_on_display(&model_oled, image);
+        fail_after = -1;
+        CHECK_EQ(model_bus.stats.recoveries, recoveries + 1);
+        CHECK_MEM(panel.gddram, image, ssd1306_buffer_length);
+        CHECK(panel.display_on);
+        CHECK(model_oled.shadow_valid);
+
+        // A cópia sombra voltou a refletir o painel: o próximo quadro só leva a diferença
+        image[2 * ssd1306_width + 40] ^= 0x08;
+        CHECK_EQ(render_changes_on_display(&model_oled, image), 1);
+        CHECK_MEM(panel.gddram, image, ssd1306_buffer_length);
+    }
+}
+
+// NAK em todas as tentativas de uma transação, sem recuperação do barramento: a escrita falha,
+// a cópia sombra é descartada e o envio seguinte leva a tela inteira, que corrige o painel
+static void test_nak_exhaustion(void) {
+    static uint8_t image[ssd1306_buffer_length];
+    memcpy(image, panel.gddram, sizeof(image));
+
+    // Primeiro a janela (transação 0), depois os dados (transação 1) de um trecho alterado
+    for (int fail = 0; fail < 2; fail++) {
+        image[3 * ssd1306_width + 17] ^= 0x5A;
+        uint32_t recoveries = model_bus.stats.recoveries;
+        fail_after_transactions(fail, i2c_bus_attempts, PICO_ERROR_GENERIC);
+        struct render_area span = {start_column : 17, end_column : 17, start_page : 3, end_page : 3};
+        calculate_render_area_buffer_length(&span);
+        CHECK(!render_on_display(&model_oled, image + 3 * ssd1306_width + 17, &span));
+        fail_after = -1;
+        CHECK_EQ(model_bus.stats.recoveries, recoveries);
+        CHECK(!model_oled.shadow_valid);
+        CHECK(memcmp(panel.gddram, image, ssd1306_buffer_length) != 0);
+
+        CHECK_EQ(render_changes_on_display(&model_oled, image), ssd1306_buffer_length);
+        CHECK(model_oled.shadow_valid);
+        CHECK_MEM(panel.gddram, image, ssd1306_buffer_length);
+    }
+
+    // O mesmo pelo envio por diferença
+    image[5 * ssd1306_width + 99] ^= 0x81;
+    fail_after_transactions(1, i2c_bus_attempts, PICO_ERROR_GENERIC);
+    CHECK_EQ(render_changes_on_display(&model_oled, image), 1);
+    fail_after = -1;
+    CHECK(!model_oled.shadow_valid);
+    CHECK_EQ(render_changes_on_display(&model_oled, image), ssd1306_buffer_length);
+    CHECK_MEM(panel.gddram, image, ssd1306_buffer_length);
+}
+
+int main(void) {
+    i2c_log_attach(&oled_log, i2c1, ssd1306_i2c_address);
+    i2c_bus_init(&bus, i2c1, 14, 15);
+    CHECK(ssd1306_attach(&oled, &bus, ssd1306_i2c_address, ssd1306_height, false) > 0);
+
+    test_init_batched();
+    test_full_frame_without_shadow();
+    test_unchanged_frame();
+    test_changed_pages();
+    test_area_updates_shadow();
+    test_invalidate();
+    test_async_without_dma();
+    test_recovery_mid_flush();
+    test_nak_exhaustion();
+    return test_summary("test_ssd1306_diff");
+}
@@ -0,0 +1,164 @@
+// Camada de desenho (inc/ssd1306_draw.c) contra uma referência pixel a pixel: cada operação é
+// repetida num mapa de pixels com o recorte e o modo aplicados um a um, e o resultado,
+// convertido para o layout de páginas do display, deve ser idêntico ao buffer desenhado. As
+// operações partem de conteúdo aleatório, para que bits fora da área não possam ser tocados
+#include "ssd1306_i2c.h"
+#include "ssd1306_draw.h"
+#include "test.h"
+
+static uint8_t buffer[ssd1306_buffer_length];
+static bool pixels[ssd1306_height][ssd1306_width];
+static uint32_t seed = 12345;
+
+static uint32_t random_next(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// Inteiro em [low, high]
+static int random_range(int low, int high) {
+    return low + (int)(random_next() % (uint32_t)(high - low + 1));
+}
+
+static void fill_random(void) {
+    for (int i = 0; i < ssd1306_buffer_length; i++) {
+        buffer[i] = (uint8_t)random_next();
+    }
+    for (int y = 0; y < ssd1306_height; y++) {
+        for (int x = 0; x < ssd1306_width; x++) {
+            pixels[y][x] = buffer[(y / 8) * ssd1306_width + x] & (1 << (y % 8));
+        }
+    }
+}
+
+static void reference_pixel(int x, int y, ssd1306_draw_mode_t mode) {
+    if (x < 0 || x >= ssd1306_width || y < 0 || y >= ssd1306_height) {
+        return;
+    }
+    switch (mode) {
+    case SSD1306_DRAW_SET:
+        pixels[y][x] = true;
+        break;
+    case SSD1306_DRAW_CLEAR:
+        pixels[y][x] = false;
+        break;
+    case SSD1306_DRAW_XOR:
+        pixels[y][x] = !pixels[y][x];
+        break;
+    }
+}
+
+static void reference_fill(int x, int y, int width, int height, ssd1306_draw_mode_t mode) {
+    for (int row = y; row < y + height; row++) {
+        for (int column = x; column < x + width; column++) {
+            reference_pixel(column, row, mode);
+        }
+    }
+}
+
+// Contorno visitando cada pixel da borda uma única vez (no XOR, os cantos não se anulam)
+static void reference_rect(int x, int y, int width, int height, ssd1306_draw_mode_t mode) {
+    for (int row = y; row < y + height; row++) {
+        for (int column = x; column < x + width; column++) {
+            if (row == y || row == y + height - 1 || column == x || column == x + width - 1) {
+                reference_pixel(column, row, mode);
+            }
+        }
+    }
+}
+
+// Compara o buffer com a referência e mostra o primeiro pixel divergente
+static bool matches(const char *operation, int x, int y, int width, int height, ssd1306_draw_mode_t mode) {
+    for (int row = 0; row < ssd1306_height; row++) {
+        for (int column = 0; column < ssd1306_width; column++) {
+            bool lit = buffer[(row / 8) * ssd1306_width + column] & (1 << (row % 8));
+            if (lit != pixels[row][column]) {
+                fprintf(stderr, "%s(%d, %d, %d, %d, modo %d): pixel (%d, %d) = %d, esperado %d\n", operation, x,
+                        y, width, height, mode, column, row, lit, pixels[row][column]);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Todas as combinações de linha inicial e altura dentro de uma página ou cruzando várias: cobre
+// cada máscara parcial de primeira e última página, nos três modos
+static void test_fill_rows(void) {
+    for (int mode = SSD1306_DRAW_SET; mode <= SSD1306_DRAW_XOR; mode++) {
+        for (int y = 0; y < ssd1306_height; y++) {
+            for (int height = 1; y + height <= ssd1306_height; height++) {
+                fill_random();
+                ssd1306_fill_rect(buffer, 5, y, 3, height, mode);
+                reference_fill(5, y, 3, height, mode);
+                CHECK(matches("fill_rect", 5, y, 3, height, mode));
+            }
+        }
+    }
+}
+
+// Retângulos aleatórios, muitos parcialmente ou totalmente fora da tela, com tamanhos nulos ou
+// negativos, por todas as operações da camada
+static void test_random(void) {
+    for (int i = 0; i < 20000; i++) {
+        int x = random_range(-40, ssd1306_width + 8);
+        int y = random_range(-20, ssd1306_height + 4);
+        int width = random_range(-4, ssd1306_width + 40);
+        int height = random_range(-4, ssd1306_height + 20);
+        ssd1306_draw_mode_t mode = (ssd1306_draw_mode_t)random_range(SSD1306_DRAW_SET, SSD1306_DRAW_XOR);
+        fill_random();
+        switch (i % 6) {
+        case 0:
+            ssd1306_fill_rect(buffer, x, y, width, height, mode);
+            reference_fill(x, y, width, height, mode);
+            CHECK(matches("fill_rect", x, y, width, height, mode));
+            break;
+        case 1:
+            ssd1306_draw_rect(buffer, x, y, width, height, mode);
+            reference_rect(x, y, width, height, mode);
+            CHECK(matches("draw_rect", x, y, width, height, mode));
+            break;
+        case 2:
+            ssd1306_hline(buffer, x, y, width, mode);
+            reference_fill(x, y, width, 1, mode);
+            CHECK(matches("hline", x, y, width, 1, mode));
+            break;
+        case 3:
+            ssd1306_vline(buffer, x, y, height, mode);
+            reference_fill(x, y, 1, height, mode);
+            CHECK(matches("vline", x, y, 1, height, mode));
+            break;
+        case 4:
+            ssd1306_clear_rect(buffer, x, y, width, height);
+            reference_fill(x, y, width, height, SSD1306_DRAW_CLEAR);
+            CHECK(matches("clear_rect", x, y, width, height, SSD1306_DRAW_CLEAR));
+            break;
+        case 5:
+            ssd1306_invert_rect(buffer, x, y, width, height);
+            reference_fill(x, y, width, height, SSD1306_DRAW_XOR);
+            CHECK(matches("invert_rect", x, y, width, height, SSD1306_DRAW_XOR));
+            break;
+        }
+    }
+}
+
+// Contornos finos e pequenos, onde as laterais e os cantos se sobrepõem
+static void test_thin_rects(void) {
+    for (int mode = SSD1306_DRAW_SET; mode <= SSD1306_DRAW_XOR; mode++) {
+        for (int width = 1; width <= 4; width++) {
+            for (int height = 1; height <= 10; height++) {
+                fill_random();
+                ssd1306_draw_rect(buffer, 60, 5, width, height, mode);
+                reference_rect(60, 5, width, height, mode);
+                CHECK(matches("draw_rect", 60, 5, width, height, mode));
+            }
+        }
+    }
+}
+
+int main(void) {
+    test_fill_rows();
+    test_random();
+    test_thin_rects();
+    return test_summary("test_ssd1306_draw");
+}
@@ -0,0 +1,121 @@
+// Envio de um grupo de displays via DMA (ssd1306_flush_group) contra modelos do painel
+// (host_ssd1306.h): displays em controladores diferentes (i2c0 e i2c1) transmitem ao mesmo tempo,
+// dois displays no mesmo controlador (i2c1) um depois do outro, e a função só retorna com todos
+// os quadros entregues
+#include "ssd1306.h"
+#include "host_ssd1306.h"
+#include "test.h"
+
+#define group_panels 3
+
+static i2c_bus_t bus0, bus1;
+static ssd1306_t oleds[group_panels];
+static host_ssd1306_t panels[group_panels];
+static uint8_t frames[group_panels][ssd1306_buffer_length];
+
+// Instantes da primeira e da última transação recebidas por cada painel desde o último clear
+static bool (*panel_write)(host_i2c_device_t *, const uint8_t *, size_t, uint64_t);
+static uint64_t first_us[group_panels], last_us[group_panels];
+
+static bool panel_write_timed(host_i2c_device_t *device, const uint8_t *data, size_t length, uint64_t time_us) {
+    int i = (host_ssd1306_t *)device->context - panels;
+    if (!first_us[i]) {
+        first_us[i] = time_us;
+    }
+    last_us[i] = time_us;
+    return panel_write(device, data, length, time_us);
+}
+
+static void clear_times(void) {
+    memset(first_us, 0, sizeof(first_us));
+    memset(last_us, 0, sizeof(last_us));
+}
+
+static void fill(int index, uint8_t seed) {
+    for (int i = 0; i < ssd1306_buffer_length; i++) {
+        frames[index][i] = (uint8_t)(i * seed + index);
+    }
+}
+
+// Envia o grupo dos displays first e second e confere o retorno: nada mais em transmissão, os
+// dois painéis com o quadro pedido e o relógio depois da última entrega (se houve alguma)
+static void flush_pair(int first, int second) {
+    ssd1306_t *const group[] = {&oleds[first], &oleds[second]};
+    const uint8_t *const buffers[] = {frames[first], frames[second]};
+    clear_times();
+    ssd1306_flush_group(group, buffers, 2);
+
+    uint64_t now = time_us_64();
+    const int members[] = {first, second};
+    for (int m = 0; m < 2; m++) {
+        int i = members[m];
+        CHECK(!ssd1306_dma_busy(&oleds[i]));
+        CHECK(last_us[i] <= now);
+        CHECK_MEM(panels[i].gddram, frames[i], ssd1306_buffer_length);
+    }
+}
+
+// Controladores diferentes: as duas transmissões se sobrepõem no tempo
+static void test_overlap(void) {
+    fill(0, 3);
+    fill(1, 5);
+    uint64_t start = time_us_64();
+    flush_pair(0, 1);
+    CHECK(first_us[0] > 0 && first_us[1] > 0);
+    CHECK(first_us[0] < last_us[1] && first_us[1] < last_us[0]);
+
+    // O grupo leva pouco mais que o mais lento dos dois quadros, não a soma
+    uint64_t longest = last_us[0] - start > last_us[1] - start ? last_us[0] - start : last_us[1] - start;
+    CHECK(time_us_64() - start < longest + longest / 4);
+    printf("dois controladores: quadros terminam em %llu e %llu us, grupo em %llu us\n",
+           (unsigned long long)(last_us[0] - start), (unsigned long long)(last_us[1] - start),
+           (unsigned long long)(time_us_64() - start));
+}
+
+// Mesmo controlador: o segundo display só começa depois da última transação do primeiro
+static void test_shared_controller(void) {
+    fill(1, 7);
+    fill(2, 11);
+    uint64_t start = time_us_64();
+    flush_pair(1, 2);
+    CHECK(first_us[1] > 0 && first_us[2] > 0);
+    CHECK(last_us[1] < first_us[2] || last_us[2] < first_us[1]);
+    printf("mesmo controlador: quadros terminam em %llu e %llu us\n",
+           (unsigned long long)(last_us[1] - start), (unsigned long long)(last_us[2] - start));
+}
+
+// Com a cópia sombra válida cada display recebe só o retângulo alterado; um display sem
+// alterações não recebe nada
+static void test_changes_only(void) {
+    frames[0][3 * ssd1306_width + 9] ^= 0xFF;
+    frames[0][4 * ssd1306_width + 12] ^= 0x0F;
+    uint32_t data_bytes[group_panels];
+    for (int i = 0; i < group_panels; i++) {
+        data_bytes[i] = panels[i].data_bytes;
+    }
+    flush_pair(0, 2);
+    CHECK_EQ(panels[0].data_bytes - data_bytes[0], 2 * 4);
+    CHECK_EQ(panels[2].data_bytes, data_bytes[2]);
+    CHECK_EQ(first_us[2], 0);
+}
+
+int main(void) {
+    i2c_bus_init(&bus0, i2c0, 4, 5);
+    i2c_bus_init(&bus1, i2c1, 14, 15);
+    host_ssd1306_attach(&panels[0], i2c0, ssd1306_i2c_address);
+    host_ssd1306_attach(&panels[1], i2c1, ssd1306_i2c_address);
+    host_ssd1306_attach(&panels[2], i2c1, ssd1306_i2c_address + 1);
+    i2c_bus_t *buses[group_panels] = {&bus0, &bus1, &bus1};
+    for (int i = 0; i < group_panels; i++) {
+        panel_write = panels[i].device.write;
+        panels[i].device.write = panel_write_timed;
+        CHECK(ssd1306_attach(&oleds[i], buses[i], panels[i].device.address, ssd1306_height, false) > 0);
+        ssd1306_init(&oleds[i]);
+        ssd1306_dma_init(&oleds[i]);
+    }
+
+    test_overlap();
+    test_shared_controller();
+    test_changes_only();
+    return test_summary("test_ssd1306_group");
+}
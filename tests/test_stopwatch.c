@@ -0,0 +1,138 @@
+// Cronômetro derivado do relógio monotônico: em execuções longas, com pausas e nas viradas de
+// hora, a contagem exibida não pode derivar nem um microssegundo do tempo realmente contado
+#include "stopwatch.h"
+#include "events.h"
+#include "pico_host.h"
+#include "test.h"
+
+#define second_us 1000000ull
+#define hour_us (3600 * second_us)
+
+static stopwatch_t sw;
+static alarm_id_t tick_alarm;
+static uint64_t ticks;
+static uint64_t tick_errors; // Tiques fora da virada de segundo ou com segundo exibido errado
+static uint32_t cost_seed = 1;
+
+// Mesmo reagendamento do firmware (schedule_tick): até a próxima virada do segundo contado
+static void schedule_tick(uint64_t now) {
+    events_cancel(tick_alarm);
+    tick_alarm = events_post_in_us(EVENT_TICK, stopwatch_us_to_next(&sw, now, second_us));
+}
+
+// O tratador gasta um tempo variável (como a composição e o envio do quadro), que um
+// cronômetro acumulado por tiques somaria como deriva
+static void on_tick(void) {
+    if (!sw.running) {
+        return;
+    }
+    uint64_t now = time_us_64();
+    uint64_t elapsed = stopwatch_elapsed_us(&sw, now);
+    ticks++;
+
+    stopwatch_time_t t = stopwatch_split(elapsed);
+    uint64_t expected_seconds = ticks % (stopwatch_wrap_hours * 3600);
+    if (elapsed != ticks * second_us || t.millisecond != 0 ||
+        (uint64_t)(t.hour * 3600 + t.minute * 60 + t.second) != expected_seconds) {
+        tick_errors++;
+    }
+
+    cost_seed = cost_seed * 1103515245 + 12345;
+    busy_wait_us((cost_seed >> 16) % 5000);
+    schedule_tick(time_us_64());
+}
+
+static void run_ticks(void) {
+    schedule_tick(time_us_64());
+    events_run();
+}
+
+// 40 horas seguidas: um tique por segundo contado, sempre na virada exata, atravessando todas
+// as viradas de hora e a volta das 32 horas
+static void test_long_run(void) {
+    uint64_t start = time_us_64();
+    stopwatch_reset(&sw, start);
+    stopwatch_start(&sw, start);
+    ticks = 0;
+    tick_errors = 0;
+
+    host_run(run_ticks, start + 40 * hour_us + 500000);
+    uint64_t now = time_us_64();
+    CHECK_EQ(ticks, 40 * 3600);
+    CHECK_EQ(tick_errors, 0);
+    CHECK_EQ(stopwatch_elapsed_us(&sw, now), now - start);
+
+    stopwatch_time_t t = stopwatch_split(stopwatch_elapsed_us(&sw, now));
+    CHECK_EQ(t.hour, 40 - stopwatch_wrap_hours);
+    CHECK_EQ(t.minute, 0);
+    CHECK_EQ(t.second, 0);
+    CHECK_EQ(t.millisecond, 500);
+}
+
+// Pausas e retomadas em instantes quebrados: o tempo contado é exatamente a soma dos trechos em
+// execução, não muda enquanto parado, e o tique seguinte à retomada cai na virada de segundo
+static void test_pause_resume(void) {
+    static const uint64_t running_us[] = {1300001, 59999999, 7, hour_us - 1, 2 * hour_us + 123457};
+    static const uint64_t paused_us[] = {250003, 1, 3 * hour_us, 999999, 17};
+
+    events_cancel(tick_alarm); // Só o tempo avança aqui; os tiques voltam após a última retomada
+    uint64_t start = time_us_64();
+    stopwatch_reset(&sw, start);
+    uint64_t counted = 0;
+    for (unsigned i = 0; i < count_of(running_us); i++) {
+        stopwatch_start(&sw, time_us_64());
+        host_advance_us(running_us[i]);
+        counted += running_us[i];
+        CHECK_EQ(stopwatch_elapsed_us(&sw, time_us_64()), counted);
+
+        stopwatch_pause(&sw, time_us_64());
+        CHECK_EQ(stopwatch_us_to_next(&sw, time_us_64(), second_us), second_us);
+        host_advance_us(paused_us[i]);
+        CHECK_EQ(stopwatch_elapsed_us(&sw, time_us_64()), counted);
+
+        // Pausar ou iniciar de novo no mesmo estado não altera nada
+        stopwatch_pause(&sw, time_us_64());
+        CHECK_EQ(stopwatch_elapsed_us(&sw, time_us_64()), counted);
+    }
+
+    // Retomada: o primeiro tique falta só o que resta do segundo interrompido
+    stopwatch_start(&sw, time_us_64());
+    stopwatch_start(&sw, time_us_64());
+    CHECK_EQ(stopwatch_us_to_next(&sw, time_us_64(), second_us), second_us - counted % second_us);
+
+    ticks = counted / second_us;
+    tick_errors = 0;
+    uint64_t resume = time_us_64();
+    host_run(run_ticks, resume + hour_us);
+    CHECK_EQ(ticks, (counted + hour_us) / second_us);
+    CHECK_EQ(tick_errors, 0);
+    CHECK_EQ(stopwatch_elapsed_us(&sw, time_us_64()), counted + hour_us);
+}
+
+static void check_split(uint64_t elapsed_us, int hour, int minute, int second, int millisecond) {
+    stopwatch_time_t t = stopwatch_split(elapsed_us);
+    CHECK_EQ(t.hour, hour);
+    CHECK_EQ(t.minute, minute);
+    CHECK_EQ(t.second, second);
+    CHECK_EQ(t.millisecond, millisecond);
+}
+
+// Viradas de hora e a volta da contagem exibida após stopwatch_wrap_hours
+static void test_hour_rollover(void) {
+    check_split(hour_us - 1, 0, 59, 59, 999);
+    check_split(hour_us, 1, 0, 0, 0);
+    check_split(10 * hour_us - 1000, 9, 59, 59, 999);
+    check_split(10 * hour_us, 10, 0, 0, 0);
+    check_split(stopwatch_wrap_hours * hour_us - 1, stopwatch_wrap_hours - 1, 59, 59, 999);
+    check_split(stopwatch_wrap_hours * hour_us, 0, 0, 0, 0);
+    check_split(1000 * hour_us + 61001000, 1000 % stopwatch_wrap_hours, 1, 1, 1);
+}
+
+int main(void) {
+    events_set_handler(EVENT_TICK, on_tick);
+
+    test_long_run();
+    test_pause_resume();
+    test_hour_rollover();
+    return test_summary("test_stopwatch");
+}
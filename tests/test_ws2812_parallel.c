@@ -0,0 +1,149 @@
+// Saída paralela dos WS2812 (inc/ws2812_parallel.c): a transposição 8x8 por máscaras contra uma
+// referência bit a bit, e o quadro completo capturado na FIFO do PIO e decodificado pino a pino
+// de volta às cores de cada fita
+#include "pico/stdlib.h"
+#include "pico_host.h"
+#include "ws2812_parallel.h"
+#include "test.h"
+
+#define max_length 40
+
+static uint32_t seed = 2024;
+
+static uint32_t random_next(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed;
+}
+
+static uint32_t strip_pixels[ws2812_parallel_max_strips][max_length];
+static const uint32_t *const strip_rows[ws2812_parallel_max_strips] = {
+    strip_pixels[0], strip_pixels[1], strip_pixels[2], strip_pixels[3],
+    strip_pixels[4], strip_pixels[5], strip_pixels[6], strip_pixels[7],
+};
+
+static void fill_random(void) {
+    for (int s = 0; s < ws2812_parallel_max_strips; s++) {
+        for (int i = 0; i < max_length; i++) {
+            strip_pixels[s][i] = random_next() & 0xFFFFFF00u; // GRB alinhado à esquerda
+        }
+    }
+}
+
+// Referência: para cada LED, cada bit de G, R e B do mais significativo ao menos, um byte com o
+// bit s igual ao bit da fita s (zero depois do fim das fitas mais curtas)
+static void reference_transpose(uint8_t *dest, const uint16_t *lengths, uint strips, uint length) {
+    for (uint i = 0; i < length; i++) {
+        for (int bit = 23; bit >= 0; bit--) {
+            uint8_t byte = 0;
+            for (uint s = 0; s < strips; s++) {
+                if (i < lengths[s] && (strip_pixels[s][i] >> (8 + bit)) & 1) {
+                    byte |= 1 << s;
+                }
+            }
+            *dest++ = byte;
+        }
+    }
+}
+
+// Todas as quantidades de fitas, com comprimentos variados e dados aleatórios
+static void test_transpose_reference(void) {
+    static uint8_t actual[max_length * 24 + 1]; // Um byte de guarda depois do maior quadro
+    static uint8_t expected[max_length * 24];
+    for (int round = 0; round < 200; round++) {
+        fill_random();
+        uint strips = 1 + round % ws2812_parallel_max_strips;
+        uint16_t lengths[ws2812_parallel_max_strips];
+        uint length = 0;
+        for (uint s = 0; s < strips; s++) {
+            lengths[s] = 1 + random_next() % max_length;
+            if (lengths[s] > length) {
+                length = lengths[s];
+            }
+        }
+        memset(actual, 0xA5, sizeof(actual));
+        ws2812_parallel_transpose(actual, strip_rows, lengths, strips, length);
+        reference_transpose(expected, lengths, strips, length);
+        CHECK_MEM(actual, expected, length * 24);
+        CHECK_EQ(actual[length * 24], 0xA5); // Nada escrito além do quadro
+    }
+}
+
+// Padrões de um único bit: cada posição de entrada aparece em exatamente uma posição de saída
+static void test_transpose_single_bits(void) {
+    static const uint16_t lengths[ws2812_parallel_max_strips] = {1, 1, 1, 1, 1, 1, 1, 1};
+    uint8_t out[24];
+    int mismatches = 0;
+    for (int s = 0; s < ws2812_parallel_max_strips; s++) {
+        for (int bit = 0; bit < 24; bit++) {
+            memset(strip_pixels, 0, sizeof(strip_pixels));
+            strip_pixels[s][0] = 1u << (8 + bit);
+            ws2812_parallel_transpose(out, strip_rows, lengths, ws2812_parallel_max_strips, 1);
+            for (int k = 0; k < 24; k++) {
+                uint8_t expected = k == 23 - bit ? 1 << s : 0;
+                mismatches += out[k] != expected;
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static uint8_t captured[max_length * 24];
+static uint captured_words;
+
+static void on_pio_words(PIO pio, uint sm, const uint32_t *words, uint count, uint64_t time_us, void *context) {
+    captured_words = count;
+    for (uint w = 0; w < count && w < max_length * 6; w++) {
+        for (int b = 0; b < 4; b++) {
+            captured[w * 4 + b] = (words[w] >> (8 * b)) & 0xFF; // O PIO desloca o byte menos significativo primeiro
+        }
+    }
+}
+
+// Quadro completo pela máquina de estados: os níveis de cada pino, em ordem de envio,
+// reconstroem as cores de cada fita; a próxima chamada espera o fim do quadro e do reset
+static void test_show_decodes(void) {
+    static uint32_t words[ws2812_parallel_buffer_words(max_length)];
+    static const uint16_t lengths[] = {25, 40, 7, 33, 1};
+    ws2812_parallel_t out;
+    CHECK(ws2812_parallel_init(&out, 8, count_of(lengths), lengths, words));
+
+    host_pio_set_listener(on_pio_words, NULL);
+    fill_random();
+    CHECK(ws2812_parallel_show(&out, strip_rows));
+    CHECK(!ws2812_parallel_show(&out, strip_rows)); // Quadro anterior em andamento
+    while (ws2812_parallel_busy(&out)) {
+        tight_loop_contents();
+    }
+    host_pio_set_listener(NULL, NULL);
+
+    CHECK_EQ(captured_words, ws2812_parallel_buffer_words(40));
+    int mismatches = 0;
+    for (uint s = 0; s < count_of(lengths); s++) {
+        for (uint i = 0; i < lengths[s]; i++) {
+            uint32_t grb = 0;
+            for (int k = 0; k < 24; k++) {
+                grb = grb << 1 | ((captured[i * 24 + k] >> s) & 1);
+            }
+            mismatches += (grb << 8) != strip_pixels[s][i];
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(out.frames, 1);
+}
+
+// Modelo do tempo de quadro: os valores da tabela de ws2812_parallel.h
+static void test_frame_model(void) {
+    CHECK_EQ(ws2812_frame_us(1, 25, true), 850);
+    CHECK_EQ(ws2812_frame_us(8, 25, false), 6100);
+    CHECK_EQ(ws2812_frame_us(8, 60, true), 1900);
+    CHECK_EQ(ws2812_frame_us(8, 60, false), 14500);
+    CHECK_EQ(ws2812_frame_us(8, 300, true), 9100);
+}
+
+int main(void) {
+    test_transpose_reference();
+    test_transpose_single_bits();
+    test_show_decodes();
+    test_frame_model();
+    return test_summary("test_ws2812_parallel");
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Compara a saída do benchmark das primitivas (bench/ssd1306_prims.c) com uma linha de base.
+
+A linha de base é um CSV carga,medida,valor,tolerância. Cada medida da execução pode ficar até
+valor * (1 + tolerância) acima da base; passar disso, ou faltar uma medida da base, é uma
+regressão e o script sai com código 1. Medidas abaixo da base são apenas informadas (atualize a
+base para travar o ganho). Medidas novas, sem base, são ignoradas.
+Uso: bench_compare.py [--update] <base.csv> <executável do benchmark> [argumentos...]
+  --update  regrava a base com os valores desta execução, mantendo as tolerâncias existentes
+"""
+import csv
+import subprocess
+import sys
+
+# Tolerância das medidas novas ao regravar a base: as do barramento são exatas no host (relógio
+# virtual, painel modelado); o tempo de CPU relativo varia com a máquina e a carga (até o dobro)
+DEFAULT_TOLERANCE = {"us": 0.0, "transactions": 0.0, "bytes": 0.0, "rel": 1.0}
+
+
+def parse_output(text):
+    results = {}
+    for line in text.splitlines():
+        fields = line.strip().split(",")
+        if len(fields) != 3:
+            continue
+        try:
+            results[(fields[0], fields[1])] = float(fields[2])
+        except ValueError:
+            continue
+    return results
+
+
+def load_baseline(path):
+    baseline = {}
+    try:
+        with open(path, newline="") as file:
+            for row in csv.reader(file):
+                if not row or row[0].startswith("#") or row[0] == "workload":
+                    continue
+                baseline[(row[0], row[1])] = (float(row[2]), float(row[3]))
+    except FileNotFoundError:
+        pass
+    return baseline
+
+
+def write_baseline(path, results, baseline):
+    with open(path, "w", newline="") as file:
+        writer = csv.writer(file, lineterminator="\n")
+        writer.writerow(["workload", "metric", "value", "tolerance"])
+        for key in sorted(results):
+            tolerance = baseline[key][1] if key in baseline else DEFAULT_TOLERANCE.get(key[1], 1.0)
+            writer.writerow([key[0], key[1], f"{results[key]:g}", f"{tolerance:g}"])
+
+
+def main(argv):
+    update = "--update" in argv
+    argv = [arg for arg in argv if arg != "--update"]
+    if len(argv) < 2:
+        print(__doc__, file=sys.stderr)
+        return 2
+
+    baseline_path, command = argv[0], argv[1:]
+    run = subprocess.run(command, capture_output=True, text=True)
+    if run.returncode != 0:
+        sys.stderr.write(run.stdout + run.stderr)
+        print(f"benchmark terminou com código {run.returncode}", file=sys.stderr)
+        return 1
+    results = parse_output(run.stdout)
+    baseline = load_baseline(baseline_path)
+
+    if update:
+        write_baseline(baseline_path, results, baseline)
+        print(f"{baseline_path}: {len(results)} medidas gravadas")
+        return 0
+
+    regressions = 0
+    for key, (base, tolerance) in sorted(baseline.items()):
+        name = f"{key[0]}.{key[1]}"
+        if key not in results:
+            print(f"FALTANDO  {name}")
+            regressions += 1
+            continue
+        value = results[key]
+        limit = base * (1 + tolerance)
+        change = (value - base) / base * 100 if base else 0.0
+        if value > limit:
+            status = "REGRESSÃO"
+            regressions += 1
+        elif value < base:
+            status = "melhor"
+        else:
+            status = "ok"
+        print(f"{status:<9} {name:<32} {value:>12g}  base {base:g} ({change:+.1f}%, limite {limit:g})")
+
+    print(f"{regressions} regressão(ões) em {len(baseline)} medidas")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
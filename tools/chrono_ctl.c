@@ -0,0 +1,219 @@
+// Ferramenta do host para o protocolo binário do cronômetro (inc/chrono_proto.h) na USB CDC.
+// Compilação no Linux:
+//   cc -O2 -Iinc -o chrono_ctl tools/chrono_ctl.c inc/chrono_proto.c
+// Uso:
+//   chrono_ctl <porta> start|pause|reset|lap|query
+//   chrono_ctl <porta> subscribe <período us>   (0: só mudanças de estado; mínimo 1000 = 1 kHz)
+//   chrono_ctl <porta> ping <n>                 (n consultas; tempo de ida e volta mín/médio/p99/máx)
+// Bytes fora de quadros (ex.: relatório CSV de CHRONO_PERF na mesma porta) são ignorados
+#define _DEFAULT_SOURCE // cfmakeraw
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "chrono_proto.h"
+
+#define REPLY_TIMEOUT_MS 500
+
+static chrono_proto_parser_t parser;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Porta em modo bruto: sem eco, sem tradução de fim de linha, leitura byte a byte
+static int open_port(const char *path) {
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static int send_command(int fd, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t length) {
+    uint8_t frame[chrono_proto_frame_size(chrono_proto_max_payload)];
+    size_t size = chrono_proto_encode(frame, type, seq, payload, length);
+    return write(fd, frame, size) == (ssize_t)size ? 0 : -1;
+}
+
+// Próximo quadro válido em até timeout_ms (negativo: sem limite). Retorna 1, 0 (tempo esgotado) ou -1
+static int read_frame(int fd, int timeout_ms, chrono_proto_frame_t *frame) {
+    if (chrono_proto_next(&parser)) { // Outro quadro já recebido, relido depois de um quadro recusado
+        *frame = parser.frame;
+        return 1;
+    }
+    uint64_t deadline = now_ns() + (uint64_t)(timeout_ms < 0 ? 0 : timeout_ms) * 1000000u;
+    while (1) {
+        int wait = -1;
+        if (timeout_ms >= 0) {
+            uint64_t now = now_ns();
+            if (now >= deadline) {
+                return 0;
+            }
+            wait = (int)((deadline - now + 999999) / 1000000);
+        }
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, wait);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        uint8_t byte;
+        ssize_t count = read(fd, &byte, 1);
+        if (count < 0) {
+            return -1;
+        }
+        if (count == 1 && chrono_proto_parse(&parser, byte)) {
+            *frame = parser.frame;
+            return 1;
+        }
+    }
+}
+
+static void print_state(uint8_t seq, const chrono_proto_state_t *state) {
+    uint32_t ms = state->elapsed_ms;
+    printf("seq=%u cause=%u t=%lu us elapsed=%02lu:%02lu:%02lu.%03lu laps=%u%s%s%s\n", seq, state->cause,
+           (unsigned long)state->time_us, (unsigned long)(ms / 3600000), (unsigned long)(ms / 60000 % 60),
+           (unsigned long)(ms / 1000 % 60), (unsigned long)(ms % 1000), state->laps,
+           state->flags & CHRONO_STATE_RUNNING ? " running" : "",
+           state->flags & CHRONO_STATE_RESET_PROMPT ? " reset-prompt" : "",
+           state->flags & CHRONO_STATE_HIRES ? " hires" : "");
+}
+
+// Aguarda a resposta de mesma sequência, ignorando registros espontâneos da assinatura
+static int await_reply(int fd, uint8_t seq, chrono_proto_frame_t *frame) {
+    while (1) {
+        int result = read_frame(fd, REPLY_TIMEOUT_MS, frame);
+        if (result <= 0) {
+            return result;
+        }
+        if (frame->seq == seq) {
+            return 1;
+        }
+    }
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int ping(int fd, int count) {
+    uint64_t *rtt = calloc(count, sizeof(uint64_t));
+    int received = 0, lost = 0;
+    for (int i = 0; i < count; i++) {
+        uint8_t seq = (uint8_t)(i % 255 + 1);
+        chrono_proto_frame_t frame;
+        uint64_t start = now_ns();
+        if (send_command(fd, CHRONO_CMD_QUERY, seq, NULL, 0) < 0) {
+            perror("write");
+            free(rtt);
+            return 1;
+        }
+        if (await_reply(fd, seq, &frame) == 1) {
+            rtt[received++] = now_ns() - start;
+        } else {
+            lost++;
+        }
+    }
+    if (received == 0) {
+        fprintf(stderr, "nenhuma resposta (%d perdidas)\n", lost);
+        free(rtt);
+        return 1;
+    }
+    qsort(rtt, received, sizeof(uint64_t), compare_u64);
+    uint64_t total = 0;
+    for (int i = 0; i < received; i++) {
+        total += rtt[i];
+    }
+    printf("rtt_us,min=%.1f,avg=%.1f,p99=%.1f,max=%.1f,n=%d,lost=%d,bad=%lu\n", rtt[0] / 1e3,
+           total / 1e3 / received, rtt[(received - 1) * 99 / 100] / 1e3, rtt[received - 1] / 1e3, received, lost,
+           (unsigned long)parser.bad);
+    free(rtt);
+    return 0;
+}
+
+static int subscribe(int fd, uint32_t period_us) {
+    uint8_t payload[4] = {period_us, period_us >> 8, period_us >> 16, period_us >> 24};
+    if (send_command(fd, CHRONO_CMD_SUBSCRIBE, 1, payload, sizeof(payload)) < 0) {
+        perror("write");
+        return 1;
+    }
+    chrono_proto_frame_t frame;
+    chrono_proto_state_t state;
+    while (read_frame(fd, -1, &frame) == 1) {
+        if (chrono_proto_decode_state(&frame, &state)) {
+            print_state(frame.seq, &state);
+            fflush(stdout);
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    static const struct {
+        const char *name;
+        uint8_t type;
+    } commands[] = {
+        {"start", CHRONO_CMD_START}, {"pause", CHRONO_CMD_PAUSE}, {"reset", CHRONO_CMD_RESET},
+        {"lap", CHRONO_CMD_LAP},     {"query", CHRONO_CMD_QUERY},
+    };
+
+    if (argc < 3) {
+        fprintf(stderr, "uso: %s <porta> start|pause|reset|lap|query|subscribe <us>|ping <n>\n", argv[0]);
+        return 2;
+    }
+    int fd = open_port(argv[1]);
+    if (fd < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    chrono_proto_parser_init(&parser);
+
+    if (strcmp(argv[2], "ping") == 0) {
+        return ping(fd, argc > 3 ? atoi(argv[3]) : 1000);
+    }
+    if (strcmp(argv[2], "subscribe") == 0) {
+        return subscribe(fd, argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 0) : 0);
+    }
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (strcmp(argv[2], commands[i].name) == 0) {
+            chrono_proto_frame_t frame;
+            chrono_proto_state_t state;
+            uint64_t start = now_ns();
+            if (send_command(fd, commands[i].type, 1, NULL, 0) < 0 || await_reply(fd, 1, &frame) != 1) {
+                fprintf(stderr, "sem resposta\n");
+                return 1;
+            }
+            if (!chrono_proto_decode_state(&frame, &state)) {
+                fprintf(stderr, "comando recusado\n");
+                return 1;
+            }
+            print_state(frame.seq, &state);
+            printf("rtt_us=%.1f\n", (now_ns() - start) / 1e3);
+            return 0;
+        }
+    }
+    fprintf(stderr, "comando desconhecido: %s\n", argv[2]);
+    return 2;
+}
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""Converte uma sequência de imagens PBM (128x64, P1 ou P4) numa animação compactada do SSD1306.
+
+O formato está descrito em inc/ssd1306_anim.h: cada quadro guarda apenas os trechos de
+página que mudaram em relação ao anterior, com os bytes compactados por RLE.
+Uso: gen_anim.py <saida.h> <nome> <fps> <quadro0.pbm> [<quadro1.pbm> ...]
+"""
+import sys
+
+WIDTH = 128
+HEIGHT = 64
+PAGES = HEIGHT // 8
+END_OF_FRAME = 0xFF
+MERGE_GAP = 4  # Trechos separados por até esta distância viram um só (cabeçalho custa ~8 bytes no barramento)
+
+
+def read_pbm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    tokens = []
+    pos = 0
+    # Cabeçalho: formato, largura e altura, ignorando comentários
+    while len(tokens) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(data[start:pos].decode())
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    if (width, height) != (WIDTH, HEIGHT):
+        sys.exit(f"{path}: esperado {WIDTH}x{HEIGHT}, encontrado {width}x{height}")
+    if magic == "P4":
+        raster = data[pos + 1:]
+        row_bytes = (width + 7) // 8
+        pixel = lambda x, y: (raster[y * row_bytes + x // 8] >> (7 - x % 8)) & 1
+    elif magic == "P1":
+        bits = [c for c in data[pos:].decode() if c in "01"]
+        pixel = lambda x, y: int(bits[y * width + x])
+    else:
+        sys.exit(f"{path}: formato {magic} não suportado (use P1 ou P4)")
+    # Converte para o layout de páginas do display: bit 0 é a linha de cima da página
+    frame = bytearray(PAGES * WIDTH)
+    for page in range(PAGES):
+        for x in range(WIDTH):
+            byte = 0
+            for bit in range(8):
+                byte |= pixel(x, page * 8 + bit) << bit
+            frame[page * WIDTH + x] = byte
+    return frame
+
+
+def rle(data):
+    out = bytearray()
+    i = 0
+    literal = bytearray()
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del literal[:128]
+
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 128:
+            run += 1
+        if run >= 3:
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out.append(data[i])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    flush_literal()
+    return out
+
+
+def encode_frame(previous, current):
+    out = bytearray()
+    for page in range(PAGES):
+        row = current[page * WIDTH:(page + 1) * WIDTH]
+        old = previous[page * WIDTH:(page + 1) * WIDTH] if previous is not None else None
+        changed = [x for x in range(WIDTH) if old is None or row[x] != old[x]]
+        spans = []
+        for x in changed:
+            if spans and x - spans[-1][1] <= MERGE_GAP:
+                spans[-1][1] = x
+            else:
+                spans.append([x, x])
+        for first, last in spans:
+            length = last - first + 1
+            out.extend([page, first, length])
+            out.extend(rle(row[first:last + 1]))
+    out.append(END_OF_FRAME)
+    return out
+
+
+def main():
+    output, name, fps = sys.argv[1], sys.argv[2], int(sys.argv[3])
+    frames = [read_pbm(path) for path in sys.argv[4:]]
+    if not frames:
+        sys.exit("nenhum quadro informado")
+
+    stream = bytearray()
+    restart_offset = 0
+    for i, frame in enumerate(frames):
+        if i == 1:
+            restart_offset = len(stream)
+        stream.extend(encode_frame(frames[i - 1] if i else None, frame))
+    wrap_offset = len(stream)
+    if len(frames) == 1:
+        restart_offset = wrap_offset
+    stream.extend(encode_frame(frames[-1], frames[0]))
+
+    raw = len(frames) * PAGES * WIDTH
+    out = [f"// Gerado por tools/gen_anim.py - não editar ({len(frames)} quadros, {len(stream)} de {raw} bytes)", "",
+           f"#ifndef {name}_anim_h", f"#define {name}_anim_h", "",
+           '#include "ssd1306_anim.h"', "",
+           f"static const uint8_t {name}_data[] = {{"]
+    for i in range(0, len(stream), 16):
+        out.append("    " + ", ".join(f"0x{b:02x}" for b in stream[i:i + 16]) + ",")
+    out.append("};")
+    out.append(f"static const ssd1306_anim_t {name} = {{{len(frames)}, {fps}, {restart_offset}, {wrap_offset}, {name}_data}};")
+    out.append("")
+    out.append("#endif")
+    with open(output, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Gera atlas de glifos pré-rasterizados e alinhados a páginas para o SSD1306.
+
+A fonte de origem é um arquivo de colunas 8x8 (ver fonts/font8x8.txt). Cada atlas é a
+fonte ampliada por um fator inteiro, com cada glifo gravado página a página (largura
+bytes por página), no mesmo formato do buffer do display, para cópia direta com memcpy.
+
+Uso: gen_glyph_atlas.py <fonte.txt> <saida.h> <nome>:<escala>:<primeiro>:<último> ...
+  ex.: font_8:1:0x20:0x7a font_16:2:0x20:0x7a
+"""
+import sys
+
+SOURCE_SIZE = 8
+
+
+def load_font(path):
+    glyphs = {}
+    with open(path) as f:
+        for line in f:
+            line = line.split(";")[0].strip()
+            if not line or line.startswith("#"):
+                continue
+            fields = line.split()
+            glyphs[int(fields[0], 16)] = [int(b, 16) for b in fields[1:1 + SOURCE_SIZE]]
+    # Minúsculas sem glifo próprio usam a maiúscula correspondente
+    for code in range(ord("a"), ord("z") + 1):
+        if code not in glyphs and code - 32 in glyphs:
+            glyphs[code] = glyphs[code - 32]
+    return glyphs
+
+
+def scale_glyph(columns, scale):
+    """Amplia o glifo e o devolve como bytes página a página."""
+    height = SOURCE_SIZE * scale
+    pages = height // 8
+    scaled_columns = []
+    for column in columns:
+        bits = 0
+        for row in range(SOURCE_SIZE):
+            if column & (1 << row):
+                bits |= ((1 << scale) - 1) << (row * scale)
+        scaled_columns.extend([bits] * scale)
+    data = []
+    for page in range(pages):
+        data.extend((bits >> (page * 8)) & 0xFF for bits in scaled_columns)
+    return data
+
+
+def main():
+    glyphs = load_font(sys.argv[1])
+    blank = [0] * SOURCE_SIZE
+    out = ["// Gerado por tools/gen_glyph_atlas.py - não editar", "",
+           "#ifndef glyph_atlas_h", "#define glyph_atlas_h", "",
+           '#include "ssd1306_glyph.h"', ""]
+    for spec in sys.argv[3:]:
+        name, scale, first, last = spec.split(":")
+        scale, first, last = int(scale), int(first, 0), int(last, 0)
+        width = SOURCE_SIZE * scale
+        pages = width // 8
+        out.append(f"static const uint8_t {name}_data[] = {{")
+        for code in range(first, last + 1):
+            data = scale_glyph(glyphs.get(code, blank), scale)
+            # Nomes para caracteres que não podem terminar um comentário C
+            label = {0x20: "espaço", 0x5c: "barra invertida"}.get(code, chr(code))
+            out.append("    " + ", ".join(f"0x{b:02x}" for b in data) + f", // {label}")
+        out.append("};")
+        out.append(f"static const ssd1306_font_t {name} = {{{width}, {pages}, 0x{first:02x}, 0x{last:02x}, {name}_data}};")
+        out.append("")
+    out.append("#endif")
+    with open(sys.argv[2], "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Gera as tabelas de máscaras da matriz de LEDs do relógio binário e a curva de gama.
+
+Para cada valor possível de segundos, minutos e horas é gerada uma máscara de 25 bits
+com os LEDs acesos, já no índice linear da fita (layout serpentina da matriz 5x5).
+A curva de gama converte o valor lógico (0-255) na intensidade do LED em ponto fixo 8.8,
+preservando a fração que o pontilhamento temporal do compositor recupera.
+Uso: gen_led_tables.py <saida.h>
+"""
+import sys
+
+MATRIX_SIZE = 5
+
+# Posição (x, y) de cada bit, do menos significativo ao mais significativo
+FIELDS = {
+    "second": (64, [(4, 4), (4, 3), (4, 2), (4, 1), (4, 0), (3, 4)]),
+    "minute": (64, [(2, 4), (2, 3), (2, 2), (2, 1), (2, 0), (1, 4)]),
+    "hour": (32, [(0, 4), (0, 3), (0, 2), (0, 1), (0, 0)]),
+}
+
+GAMMA = 2.2
+
+
+def get_index(x, y):
+    """Mesmo mapeamento serpentina da matriz: linhas pares da direita para a esquerda."""
+    if y % 2 == 0:
+        return 24 - (y * MATRIX_SIZE + x)
+    return 24 - (y * MATRIX_SIZE + (MATRIX_SIZE - 1 - x))
+
+
+def masks(count, positions):
+    result = []
+    for value in range(count):
+        mask = 0
+        for bit, (x, y) in enumerate(positions):
+            if value & (1 << bit):
+                mask |= 1 << get_index(x, y)
+        result.append(mask)
+    return result
+
+
+def main():
+    out = ["// Gerado por tools/gen_led_tables.py - não editar", "",
+           "#ifndef led_tables_h", "#define led_tables_h", "",
+           "#include <stdint.h>", ""]
+    for name, (count, positions) in FIELDS.items():
+        values = masks(count, positions)
+        out.append(f"static const uint32_t led_{name}_masks[{count}] = {{")
+        for i in range(0, count, 8):
+            out.append("    " + ", ".join(f"0x{v:07x}" for v in values[i:i + 8]) + ",")
+        out.append("};")
+        out.append("")
+    gamma = [round((value / 255) ** GAMMA * 255 * 256) for value in range(256)]
+    out.append(f"// Gama {GAMMA}: intensidade em ponto fixo 8.8 (0 a 255 * 256) para cada valor lógico")
+    out.append("static const uint16_t led_gamma[256] = {")
+    for i in range(0, 256, 8):
+        out.append("    " + ", ".join(f"{v}" for v in gamma[i:i + 8]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("#endif")
+    with open(sys.argv[1], "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()